@@ -21,8 +21,8 @@
 // OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //=============================================================================
 
-#ifndef INCLUDE_NENE_COMPRESSION_ZLIB_COMPRESS_HPP
-#define INCLUDE_NENE_COMPRESSION_ZLIB_COMPRESS_HPP
+#ifndef INCLUDE_NENE_COMPRESSION_ZLIB_UNCOMPRESS_HPP
+#define INCLUDE_NENE_COMPRESSION_ZLIB_UNCOMPRESS_HPP
 
 #include "../../ArrayView.hpp"
 
@@ -39,4 +39,4 @@ namespace Nene::Compression::Zlib
 	std::vector<Byte> uncompress(ByteArrayView data, std::size_t uncompressedSize);
 }
 
-#endif  // #ifndef INCLUDE_NENE_COMPRESSION_ZLIB_COMPRESS_HPP
+#endif  // #ifndef INCLUDE_NENE_COMPRESSION_ZLIB_UNCOMPRESS_HPP
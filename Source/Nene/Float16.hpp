@@ -0,0 +1,201 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_FLOAT16_HPP
+#define INCLUDE_NENE_FLOAT16_HPP
+
+#include <cstring>
+#include "Types.hpp"
+
+namespace Nene
+{
+	/**
+	 * @brief      IEEE 754 half precision floating point number.
+	 *
+	 *             Only the storage and the conversions are provided; the
+	 *             arithmetic is done in `Float32`.
+	 */
+	class Float16
+	{
+		struct BitsTag {};
+
+		UInt16 bits_ = 0;
+
+		constexpr explicit Float16(UInt16 bits, BitsTag) noexcept
+			: bits_(bits) {}
+
+	public:
+		/**
+		 * @brief      Constructs the number from the bit pattern.
+		 *
+		 * @param[in]  bits  The IEEE 754 binary16 bit pattern.
+		 *
+		 * @return     The half precision number.
+		 */
+		[[nodiscard]]
+		constexpr static Float16 fromBits(UInt16 bits) noexcept
+		{
+			return Float16 { bits, BitsTag {} };
+		}
+
+		/**
+		 * @brief      Default constructor.
+		 */
+		constexpr Float16() noexcept =default;
+
+		/**
+		 * @brief      Copy constructor.
+		 */
+		constexpr Float16(const Float16&) noexcept =default;
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 *             The value is rounded to the nearest even.
+		 *
+		 * @param[in]  value  The single precision value.
+		 */
+		Float16(Float32 value) noexcept
+		{
+			UInt32 x;
+			std::memcpy(&x, &value, sizeof(x));
+
+			const UInt32 sign     = (x >> 16) & 0x8000;
+			const Int32  exponent = static_cast<Int32>((x >> 23) & 0xff) - 127 + 15;
+			UInt32       mantissa = x & 0x7fffff;
+
+			if (((x >> 23) & 0xff) == 0xff)
+			{
+				// Infinity or NaN.
+				bits_ = static_cast<UInt16>(sign | 0x7c00 | (mantissa ? 0x0200 : 0));
+			}
+			else if (exponent >= 0x1f)
+			{
+				// Overflow.
+				bits_ = static_cast<UInt16>(sign | 0x7c00);
+			}
+			else if (exponent <= 0)
+			{
+				// Subnormal or zero.
+				if (exponent < -10)
+				{
+					bits_ = static_cast<UInt16>(sign);
+					return;
+				}
+
+				mantissa |= 0x800000;
+
+				const Int32  shift     = 14 - exponent;
+				const UInt32 remainder = mantissa & ((1u << shift) - 1);
+				const UInt32 halfway   = 1u << (shift - 1);
+				UInt32       half      = mantissa >> shift;
+
+				if (remainder > halfway || (remainder == halfway && (half & 1)))
+				{
+					half++;
+				}
+
+				bits_ = static_cast<UInt16>(sign | half);
+			}
+			else
+			{
+				const UInt32 remainder = mantissa & 0x1fff;
+				UInt32       half      = sign | (static_cast<UInt32>(exponent) << 10) | (mantissa >> 13);
+
+				// The carry may propagate into the exponent, which rounds up correctly.
+				if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+				{
+					half++;
+				}
+
+				bits_ = static_cast<UInt16>(half);
+			}
+		}
+
+		/**
+		 * @brief      Destructor.
+		 */
+		~Float16() =default;
+
+		/**
+		 * @brief      Returns the bit pattern.
+		 *
+		 * @return     The IEEE 754 binary16 bit pattern.
+		 */
+		[[nodiscard]]
+		constexpr UInt16 bits() const noexcept
+		{
+			return bits_;
+		}
+
+		/**
+		 * @brief      Converts into the single precision value.
+		 */
+		operator Float32() const noexcept
+		{
+			const UInt32 sign     = static_cast<UInt32>(bits_ & 0x8000) << 16;
+			Int32        exponent = (bits_ >> 10) & 0x1f;
+			UInt32       mantissa = bits_ & 0x03ff;
+			UInt32       x;
+
+			if (exponent == 0x1f)
+			{
+				// Infinity or NaN.
+				x = sign | 0x7f800000 | (mantissa << 13);
+			}
+			else if (exponent != 0)
+			{
+				x = sign | (static_cast<UInt32>(exponent + 127 - 15) << 23) | (mantissa << 13);
+			}
+			else if (mantissa != 0)
+			{
+				// Normalize the subnormal number.
+				exponent = 1;
+
+				while (!(mantissa & 0x0400))
+				{
+					mantissa <<= 1;
+					exponent--;
+				}
+
+				x = sign | (static_cast<UInt32>(exponent + 127 - 15) << 23) | ((mantissa & 0x03ff) << 13);
+			}
+			else
+			{
+				x = sign;
+			}
+
+			Float32 value;
+			std::memcpy(&value, &x, sizeof(value));
+
+			return value;
+		}
+
+		/**
+		 * @brief      Copy operator `=`.
+		 */
+		constexpr Float16& operator=(const Float16&) noexcept =default;
+	};
+}
+
+#endif  // #ifndef INCLUDE_NENE_FLOAT16_HPP
@@ -27,18 +27,20 @@
 #include <memory>
 #include <string_view>
 #include "../ArrayView.hpp"
+#include "../ImageView.hpp"
 #include "../Size2D.hpp"
 #include "../Vertex2D.hpp"
 
 namespace Nene
 {
 	// Forward declarations.
-	class Image;
 	class IContext;
 	class IDynamicTexture;
 	class IPixelShader;
+	class MipChain;
 	class IScreen;
 	class ITexture;
+	class TextureData;
 	class IVertexShader;
 	class IWindow;
 
@@ -199,7 +201,29 @@ namespace Nene
 		 * @return     The texture instance.
 		 */
 		[[nodiscard]]
-		virtual std::shared_ptr<ITexture> texture(const Image& image) =0;
+		virtual std::shared_ptr<ITexture> texture(ImageView image) =0;
+
+		/**
+		 * @brief      Creates the mipmapped texture.
+		 *
+		 * @param[in]  mipChain  The mipmap levels of the source image.
+		 *
+		 * @return     The texture instance.
+		 */
+		[[nodiscard]]
+		virtual std::shared_ptr<ITexture> texture(const MipChain& mipChain) =0;
+
+		/**
+		 * @brief      Creates the texture from GPU ready texture data.
+		 *
+		 *             The subresources are uploaded as is without decoding.
+		 *
+		 * @param[in]  data  The texture data.
+		 *
+		 * @return     The texture instance.
+		 */
+		[[nodiscard]]
+		virtual std::shared_ptr<ITexture> texture(const TextureData& data) =0;
 
 		/**
 		 * @brief      Creates the empty dynamic texture.
@@ -219,7 +243,7 @@ namespace Nene
 		 * @return     The dynamic texture instance.
 		 */
 		[[nodiscard]]
-		virtual std::shared_ptr<IDynamicTexture> dynamicTexture(const Image& image) =0;
+		virtual std::shared_ptr<IDynamicTexture> dynamicTexture(ImageView image) =0;
 	};
 }
 
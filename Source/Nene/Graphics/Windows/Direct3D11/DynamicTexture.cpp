@@ -63,7 +63,7 @@ namespace Nene::Windows::Direct3D11
 		: TextureBase(device, size, true)
 		, renderTarget_(createRenderTargetView(texture2D())) {}
 
-	DynamicTexture::DynamicTexture(const Microsoft::WRL::ComPtr<ID3D11Device>& device, const Image& image)
+	DynamicTexture::DynamicTexture(const Microsoft::WRL::ComPtr<ID3D11Device>& device, ImageView image)
 		: TextureBase(device, image, true)
 		, renderTarget_(createRenderTargetView(texture2D())) {}
 }
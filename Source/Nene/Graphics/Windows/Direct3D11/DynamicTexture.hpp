@@ -69,7 +69,7 @@ namespace Nene::Windows::Direct3D11
 		 * @param[in]  device   Direct3D11 device.
 		 * @param[in]  image    The source image.
 		 */
-		explicit DynamicTexture(const Microsoft::WRL::ComPtr<ID3D11Device>& device, const Image& image);
+		explicit DynamicTexture(const Microsoft::WRL::ComPtr<ID3D11Device>& device, ImageView image);
 
 		/**
 		 * @brief      Destructor.
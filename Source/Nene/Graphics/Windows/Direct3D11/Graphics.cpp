@@ -255,17 +255,27 @@ namespace Nene::Windows::Direct3D11
 		return std::make_shared<PixelShader>(device_, compiledBinary);
 	}
 
-	std::shared_ptr<ITexture> Graphics::texture(const Image& image)
+	std::shared_ptr<ITexture> Graphics::texture(ImageView image)
 	{
 		return std::make_shared<Texture>(device_, image);
 	}
 
+	std::shared_ptr<ITexture> Graphics::texture(const MipChain& mipChain)
+	{
+		return std::make_shared<Texture>(device_, mipChain);
+	}
+
+	std::shared_ptr<ITexture> Graphics::texture(const TextureData& data)
+	{
+		return std::make_shared<Texture>(device_, data);
+	}
+
 	std::shared_ptr<IDynamicTexture> Graphics::dynamicTexture(const Size2Di& size)
 	{
 		return std::make_shared<DynamicTexture>(device_, size);
 	}
 
-	std::shared_ptr<IDynamicTexture> Graphics::dynamicTexture(const Image& image)
+	std::shared_ptr<IDynamicTexture> Graphics::dynamicTexture(ImageView image)
 	{
 		return std::make_shared<DynamicTexture>(device_, image);
 	}
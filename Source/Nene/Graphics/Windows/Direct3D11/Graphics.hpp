@@ -141,7 +141,13 @@ namespace Nene::Windows::Direct3D11
 		 * @see        `Nene::IGraphics::texture()`.
 		 */
 		[[nodiscard]]
-		std::shared_ptr<ITexture> texture(const Image& image) override;
+		std::shared_ptr<ITexture> texture(ImageView image) override;
+
+		[[nodiscard]]
+		std::shared_ptr<ITexture> texture(const MipChain& mipChain) override;
+
+		[[nodiscard]]
+		std::shared_ptr<ITexture> texture(const TextureData& data) override;
 
 		/**
 		 * @see        `Nene::IGraphics::dynamicTexture()`.
@@ -150,7 +156,7 @@ namespace Nene::Windows::Direct3D11
 		std::shared_ptr<IDynamicTexture> dynamicTexture(const Size2Di& image) override;
 
 		[[nodiscard]]
-		std::shared_ptr<IDynamicTexture> dynamicTexture(const Image& image) override;
+		std::shared_ptr<IDynamicTexture> dynamicTexture(ImageView image) override;
 	};
 }
 
@@ -24,6 +24,7 @@
 #include "../../../Platform.hpp"
 #if defined(NENE_OS_WINDOWS)
 
+#include <vector>
 #include "../../../Exceptions/Windows/DirectXException.hpp"
 #include "Texture.hpp"
 
@@ -43,10 +44,30 @@ namespace Nene::Windows::Direct3D11
 			texture->GetDevice(device.GetAddressOf());
 
 			D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-			srvDesc.Format                    = texDesc.Format;
-			srvDesc.ViewDimension             = D3D11_SRV_DIMENSION_TEXTURE2D;
-			srvDesc.Texture2D.MostDetailedMip = texDesc.MipLevels - 1;
-			srvDesc.Texture2D.MipLevels       = texDesc.MipLevels;
+			srvDesc.Format = texDesc.Format;
+
+			if (texDesc.MiscFlags & D3D11_RESOURCE_MISC_TEXTURECUBE)
+			{
+				srvDesc.ViewDimension                     = texDesc.ArraySize > 6 ? D3D11_SRV_DIMENSION_TEXTURECUBEARRAY : D3D11_SRV_DIMENSION_TEXTURECUBE;
+				srvDesc.TextureCubeArray.MostDetailedMip  = 0;
+				srvDesc.TextureCubeArray.MipLevels        = texDesc.MipLevels;
+				srvDesc.TextureCubeArray.First2DArrayFace = 0;
+				srvDesc.TextureCubeArray.NumCubes         = texDesc.ArraySize / 6;
+			}
+			else if (texDesc.ArraySize > 1)
+			{
+				srvDesc.ViewDimension                  = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+				srvDesc.Texture2DArray.MostDetailedMip = 0;
+				srvDesc.Texture2DArray.MipLevels       = texDesc.MipLevels;
+				srvDesc.Texture2DArray.FirstArraySlice = 0;
+				srvDesc.Texture2DArray.ArraySize       = texDesc.ArraySize;
+			}
+			else
+			{
+				srvDesc.ViewDimension             = D3D11_SRV_DIMENSION_TEXTURE2D;
+				srvDesc.Texture2D.MostDetailedMip = 0;
+				srvDesc.Texture2D.MipLevels       = texDesc.MipLevels;
+			}
 
 
 			throwIfFailed(
@@ -55,6 +76,33 @@ namespace Nene::Windows::Direct3D11
 
 			return shaderResource;
 		}
+
+		DXGI_FORMAT dxgiFormat(TextureFormat format) noexcept
+		{
+			switch (format)
+			{
+				case TextureFormat::rgba8:      return DXGI_FORMAT_R8G8B8A8_UNORM;
+				case TextureFormat::rgba8Srgb:  return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+				case TextureFormat::bgra8:      return DXGI_FORMAT_B8G8R8A8_UNORM;
+				case TextureFormat::bgra8Srgb:  return DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+				case TextureFormat::bgrx8:      return DXGI_FORMAT_B8G8R8X8_UNORM;
+				case TextureFormat::bgrx8Srgb:  return DXGI_FORMAT_B8G8R8X8_UNORM_SRGB;
+				case TextureFormat::rgba16f:    return DXGI_FORMAT_R16G16B16A16_FLOAT;
+				case TextureFormat::bc1:        return DXGI_FORMAT_BC1_UNORM;
+				case TextureFormat::bc1Srgb:    return DXGI_FORMAT_BC1_UNORM_SRGB;
+				case TextureFormat::bc2:        return DXGI_FORMAT_BC2_UNORM;
+				case TextureFormat::bc2Srgb:    return DXGI_FORMAT_BC2_UNORM_SRGB;
+				case TextureFormat::bc3:        return DXGI_FORMAT_BC3_UNORM;
+				case TextureFormat::bc3Srgb:    return DXGI_FORMAT_BC3_UNORM_SRGB;
+				case TextureFormat::bc4:        return DXGI_FORMAT_BC4_UNORM;
+				case TextureFormat::bc5:        return DXGI_FORMAT_BC5_UNORM;
+				case TextureFormat::bc6h:       return DXGI_FORMAT_BC6H_UF16;
+				case TextureFormat::bc6hSigned: return DXGI_FORMAT_BC6H_SF16;
+				case TextureFormat::bc7:        return DXGI_FORMAT_BC7_UNORM;
+				case TextureFormat::bc7Srgb:    return DXGI_FORMAT_BC7_UNORM_SRGB;
+				default:                        return DXGI_FORMAT_UNKNOWN;
+			}
+		}
 	}
 
 	TextureBase::TextureBase(const Microsoft::WRL::ComPtr<ID3D11Texture2D>& texture)
@@ -110,7 +158,7 @@ namespace Nene::Windows::Direct3D11
 		shaderResource_ = createShaderResourceView(texture_);
 	}
 
-	TextureBase::TextureBase(const Microsoft::WRL::ComPtr<ID3D11Device>& device, const Image& image, bool dynamic)
+	TextureBase::TextureBase(const Microsoft::WRL::ComPtr<ID3D11Device>& device, ImageView image, bool dynamic)
 		: texture_()
 		, shaderResource_()
 		, size_(image.size())
@@ -137,7 +185,7 @@ namespace Nene::Windows::Direct3D11
 
 		D3D11_SUBRESOURCE_DATA subresource = {};
 		subresource.pSysMem          = image.dataPointer();
-		subresource.SysMemPitch      = size_.width * sizeof(Color4);
+		subresource.SysMemPitch      = static_cast<UINT>(image.pitch());
 		subresource.SysMemSlicePitch = 0;
 
 		throwIfFailed(
@@ -147,6 +195,91 @@ namespace Nene::Windows::Direct3D11
 		// Create shader resource view.
 		shaderResource_ = createShaderResourceView(texture_);
 	}
+
+	TextureBase::TextureBase(const Microsoft::WRL::ComPtr<ID3D11Device>& device, const MipChain& mipChain)
+		: texture_()
+		, shaderResource_()
+		, size_(mipChain.size(0))
+	{
+		assert(device);
+
+		D3D11_TEXTURE2D_DESC texDesc = {};
+		texDesc.Width              = static_cast<UINT>(size_.width);
+		texDesc.Height             = static_cast<UINT>(size_.height);
+		texDesc.MipLevels          = static_cast<UINT>(mipChain.numLevels());
+		texDesc.ArraySize          = 1;
+		texDesc.Format             = DXGI_FORMAT_R8G8B8A8_UNORM;
+		texDesc.SampleDesc.Count   = 1;
+		texDesc.SampleDesc.Quality = 0;
+		texDesc.Usage              = D3D11_USAGE_IMMUTABLE;
+		texDesc.BindFlags          = D3D11_BIND_SHADER_RESOURCE;
+		texDesc.CPUAccessFlags     = 0;
+		texDesc.MiscFlags          = 0;
+
+		// Every level refers into the contiguous buffer.
+		std::vector<D3D11_SUBRESOURCE_DATA> subresources(static_cast<std::size_t>(mipChain.numLevels()));
+
+		for (Int32 level = 0; level < mipChain.numLevels(); level++)
+		{
+			const auto view = mipChain.level(level);
+
+			subresources[level].pSysMem          = view.dataPointer();
+			subresources[level].SysMemPitch      = static_cast<UINT>(view.pitch());
+			subresources[level].SysMemSlicePitch = 0;
+		}
+
+		throwIfFailed(
+			device->CreateTexture2D(&texDesc, subresources.data(), texture_.GetAddressOf()),
+			u8"Failed to create Direct3D11 texture2D.");
+
+		// Create shader resource view.
+		shaderResource_ = createShaderResourceView(texture_);
+	}
+
+	TextureBase::TextureBase(const Microsoft::WRL::ComPtr<ID3D11Device>& device, const TextureData& data)
+		: texture_()
+		, shaderResource_()
+		, size_(data.size())
+	{
+		assert(device);
+
+		D3D11_TEXTURE2D_DESC texDesc = {};
+		texDesc.Width              = static_cast<UINT>(size_.width);
+		texDesc.Height             = static_cast<UINT>(size_.height);
+		texDesc.MipLevels          = static_cast<UINT>(data.numLevels());
+		texDesc.ArraySize          = static_cast<UINT>(data.arraySize());
+		texDesc.Format             = dxgiFormat(data.format());
+		texDesc.SampleDesc.Count   = 1;
+		texDesc.SampleDesc.Quality = 0;
+		texDesc.Usage              = D3D11_USAGE_IMMUTABLE;
+		texDesc.BindFlags          = D3D11_BIND_SHADER_RESOURCE;
+		texDesc.CPUAccessFlags     = 0;
+		texDesc.MiscFlags          = data.isCubeMap() ? D3D11_RESOURCE_MISC_TEXTURECUBE : 0;
+
+		// Every subresource refers into the contiguous buffer in the same order.
+		std::vector<D3D11_SUBRESOURCE_DATA> subresources;
+		subresources.reserve(static_cast<std::size_t>(data.arraySize()) * data.numLevels());
+
+		for (Int32 item = 0; item < data.arraySize(); item++)
+		{
+			for (Int32 level = 0; level < data.numLevels(); level++)
+			{
+				D3D11_SUBRESOURCE_DATA subresource = {};
+				subresource.pSysMem          = data.subresource(item, level).data();
+				subresource.SysMemPitch      = static_cast<UINT>(data.pitch(level));
+				subresource.SysMemSlicePitch = 0;
+
+				subresources.emplace_back(subresource);
+			}
+		}
+
+		throwIfFailed(
+			device->CreateTexture2D(&texDesc, subresources.data(), texture_.GetAddressOf()),
+			u8"Failed to create Direct3D11 texture2D.");
+
+		// Create shader resource view.
+		shaderResource_ = createShaderResourceView(texture_);
+	}
 }
 
 #endif
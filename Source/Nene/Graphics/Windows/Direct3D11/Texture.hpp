@@ -33,6 +33,8 @@
 #include <memory>
 #include <d3d11.h>
 #include <wrl/client.h>
+#include "../../../MipChain.hpp"
+#include "../../../TextureData.hpp"
 #include "../../../Uncopyable.hpp"
 #include "../../ITexture.hpp"
 
@@ -73,7 +75,23 @@ namespace Nene::Windows::Direct3D11
 		 * @param[in]  image    The source image.
 		 * @param[in]  dynamic  `true` if using as a render target texture.
 		 */
-		explicit TextureBase(const Microsoft::WRL::ComPtr<ID3D11Device>& device, const Image& image, bool dynamic);
+		explicit TextureBase(const Microsoft::WRL::ComPtr<ID3D11Device>& device, ImageView image, bool dynamic);
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  device    Direct3D11 device.
+		 * @param[in]  mipChain  The mipmap levels of the source image.
+		 */
+		explicit TextureBase(const Microsoft::WRL::ComPtr<ID3D11Device>& device, const MipChain& mipChain);
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  device  Direct3D11 device.
+		 * @param[in]  data    The GPU ready texture data.
+		 */
+		explicit TextureBase(const Microsoft::WRL::ComPtr<ID3D11Device>& device, const TextureData& data);
 
 	public:
 		/**
@@ -127,9 +145,27 @@ namespace Nene::Windows::Direct3D11
 		 * @param[in]  image    The source image.
 		 * @param[in]  dynamic  `true` if using as a render target texture.
 		 */
-		explicit Texture(const Microsoft::WRL::ComPtr<ID3D11Device>& device, const Image& image)
+		explicit Texture(const Microsoft::WRL::ComPtr<ID3D11Device>& device, ImageView image)
 			: TextureBase(device, image, false) {}
 
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  device    Direct3D11 device.
+		 * @param[in]  mipChain  The mipmap levels of the source image.
+		 */
+		explicit Texture(const Microsoft::WRL::ComPtr<ID3D11Device>& device, const MipChain& mipChain)
+			: TextureBase(device, mipChain) {}
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  device  Direct3D11 device.
+		 * @param[in]  data    The GPU ready texture data.
+		 */
+		explicit Texture(const Microsoft::WRL::ComPtr<ID3D11Device>& device, const TextureData& data)
+			: TextureBase(device, data) {}
+
 		/**
 		 * @brief      Destructor.
 		 */
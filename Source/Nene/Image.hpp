@@ -24,63 +24,174 @@
 #ifndef INCLUDE_NENE_IMAGE_HPP
 #define INCLUDE_NENE_IMAGE_HPP
 
-#include <functional>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
 #include "ArrayView.hpp"
+#include "Byte.hpp"
 #include "Color.hpp"
+#include "ImageLayout.hpp"
+#include "ImageView.hpp"
+#include "PixelFormat.hpp"
 #include "Size2D.hpp"
 #include "Vector2D.hpp"
+#include "Thread/ThreadPool.hpp"
 
 namespace Nene
 {
 	/**
 	 * @brief      Image object.
+	 *
+	 *             Pixels are stored row by row in a buffer taken from
+	 *             `Allocator`, laid out according to `ImageLayout`.
+	 *
+	 * @tparam     Pixel      The pixel type.
+	 * @tparam     Allocator  The byte allocator type.
 	 */
-	class Image
+	template <typename Pixel, typename Allocator = std::allocator<Byte>>
+	class BasicImage
 	{
-		std::vector<Color4> data_;
-		Size2Di             size_;
+		static_assert(std::is_trivially_copyable_v<Pixel>);
+		static_assert(std::is_same_v<typename std::allocator_traits<Allocator>::value_type, Byte>);
+
+		using allocator_traits = std::allocator_traits<Allocator>;
+
+		struct Uninitialized {};
+
+		Allocator   allocator_;
+		Byte*       buffer_;
+		std::size_t bufferSize_;
+		Pixel*      data_;
+		Size2Di     size_;
+		std::size_t pitch_;
+		ImageLayout layout_;
+
+		explicit BasicImage(const Size2Di& size, const ImageLayout& layout, const Allocator& allocator, Uninitialized)
+			: allocator_(allocator)
+			, buffer_(nullptr)
+			, bufferSize_(0)
+			, data_(nullptr)
+			, size_(size)
+			, pitch_(layout.pitch(size.width, sizeof(Pixel)))
+			, layout_(layout)
+		{
+			assert(size.width  > 0);
+			assert(size.height > 0);
+			assert(pitch_ % alignof(Pixel) == 0);
+
+			const auto alignment = (std::max)(layout.alignment, alignof(Pixel));
+
+			bufferSize_ = pitch_ * size.height + alignment - 1;
+			buffer_     = allocator_traits::allocate(allocator_, bufferSize_);
+
+			const auto address = reinterpret_cast<std::uintptr_t>(buffer_);
+
+			data_ = reinterpret_cast<Pixel*>(buffer_ + ((alignment - address % alignment) % alignment));
+		}
+
+		template <typename Generator>
+		static constexpr bool isPixelGenerator = std::is_invocable_r_v<Pixel, Generator&, const Vector2Di&>;
+
+		template <typename Generator>
+		static constexpr bool isRowGenerator = std::is_invocable_v<Generator&, const Vector2Di&, Pixel*, Int32>;
+
+		template <typename Generator>
+		static constexpr bool isGenerator = isPixelGenerator<Generator> || isRowGenerator<Generator>;
+
+		template <typename Generator>
+		void generate(const Rectanglei& rect, Generator& generator)
+		{
+			for (Int32 y = rect.top(); y < rect.bottom(); y++)
+			{
+				const auto p = row(y);
+
+				if constexpr (isRowGenerator<Generator>)
+				{
+					generator(Vector2Di { rect.left(), y }, p + rect.left(), rect.width());
+				}
+				else
+				{
+					for (Int32 x = rect.left(); x < rect.right(); x++)
+					{
+						p[x] = generator(Vector2Di { x, y });
+					}
+				}
+			}
+		}
+
+		void release() noexcept
+		{
+			if (buffer_)
+			{
+				allocator_traits::deallocate(allocator_, buffer_, bufferSize_);
+				buffer_ = nullptr;
+			}
+		}
 
 	public:
+		using value_type     = Pixel;
+		using allocator_type = Allocator;
+
 		/**
 		 * @brief      Default constructor.
 		 */
-		Image() =delete;
+		BasicImage() =delete;
 
 		/**
 		 * @brief      Copy constructor.
 		 */
-		Image(const Image&) =delete;
+		BasicImage(const BasicImage&) =delete;
 
 		/**
 		 * @brief      Move constructor.
 		 */
-		Image(Image&&) =default;
+		BasicImage(BasicImage&& image) noexcept
+			: allocator_(std::move(image.allocator_))
+			, buffer_(std::exchange(image.buffer_, nullptr))
+			, bufferSize_(image.bufferSize_)
+			, data_(image.data_)
+			, size_(image.size_)
+			, pitch_(image.pitch_)
+			, layout_(image.layout_) {}
 
 		/**
 		 * @brief      Constructor.
 		 *
-		 * @param[in]  width   The image width.
-		 * @param[in]  height  The image height.
-		 * @param[in]  color   The fill color.
+		 * @param[in]  size       The image size.
+		 * @param[in]  layout     The storage layout.
+		 * @param[in]  allocator  The allocator of the pixel buffer.
+		 * @param[in]  pixel      The fill value.
 		 */
-		explicit Image(Int32 width, Int32 height, const Color4& color = 0x00000000)
-			: data_()
-			, size_(width, height)
+		explicit BasicImage(const Size2Di& size, const ImageLayout& layout, const Allocator& allocator = Allocator {}, const Pixel& pixel = Pixel {})
+			: BasicImage(size, layout, allocator, Uninitialized {})
 		{
-			assert(width  > 0);
-			assert(height > 0);
-
-			data_.assign(width * height, color);
+			for (Int32 y = 0; y < size_.height; y++)
+			{
+				std::uninitialized_fill_n(row(y), size_.width, pixel);
+			}
 		}
 
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  width   The image width.
+		 * @param[in]  height  The image height.
+		 * @param[in]  pixel   The fill value.
+		 */
+		explicit BasicImage(Int32 width, Int32 height, const Pixel& pixel = Pixel {})
+			: BasicImage(Size2Di { width, height }, ImageLayout::packed(), Allocator {}, pixel) {}
+
 		/**
 		 * @brief      Constructor.
 		 *
 		 * @param[in]  size   The image size.
-		 * @param[in]  color  The fill color.
+		 * @param[in]  pixel  The fill value.
 		 */
-		explicit Image(const Size2Di& size, const Color4& color = 0x00000000)
-			: Image(size.width, size.height, color) {}
+		explicit BasicImage(const Size2Di& size, const Pixel& pixel = Pixel {})
+			: BasicImage(size, ImageLayout::packed(), Allocator {}, pixel) {}
 
 		/**
 		 * @brief      Constructor.
@@ -89,13 +200,10 @@ namespace Nene
 		 * @param[in]  height  The image height.
 		 * @param[in]  data    The pixel data.
 		 */
-		explicit Image(Int32 width, Int32 height, ArrayView<Color4> data)
-			: data_(data.to_vector())
-			, size_(width, height)
+		explicit BasicImage(Int32 width, Int32 height, ArrayView<Pixel> data)
+			: BasicImage(BasicImageView<Pixel> { data.data(), Size2Di { width, height } })
 		{
-			assert(width  > 0);
-			assert(height > 0);
-			assert(data.size() == width * height);
+			assert(data.size() == numPixels());
 		}
 
 		/**
@@ -104,8 +212,41 @@ namespace Nene
 		 * @param[in]  size  The image size.
 		 * @param[in]  data  The pixel data.
 		 */
-		explicit Image(const Size2Di& size, ArrayView<Color4> data)
-			: Image(size.width, size.height, data) {}
+		explicit BasicImage(const Size2Di& size, ArrayView<Pixel> data)
+			: BasicImage(size.width, size.height, data) {}
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  view       The pixels to copy.
+		 * @param[in]  layout     The storage layout.
+		 * @param[in]  allocator  The allocator of the pixel buffer.
+		 */
+		explicit BasicImage(const BasicImageView<Pixel>& view, const ImageLayout& layout = ImageLayout::packed(), const Allocator& allocator = Allocator {})
+			: BasicImage(view.size(), layout, allocator, Uninitialized {})
+		{
+			mutableView().copyFrom(view);
+		}
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 *             `generator` is either a pixel generator called as
+		 *             `generator(position)` returning the pixel, or a row span
+		 *             generator called as `generator(position, pixels, count)`
+		 *             filling `count` pixels from `position`.
+		 *
+		 * @param[in]  size       The image size.
+		 * @param[in]  generator  The pixel generator function.
+		 *
+		 * @tparam     Generator  The generator type.
+		 */
+		template <typename Generator, std::enable_if_t<isGenerator<Generator>, std::nullptr_t> = nullptr>
+		explicit BasicImage(const Size2Di& size, Generator&& generator)
+			: BasicImage(size, ImageLayout::packed(), Allocator {}, Uninitialized {})
+		{
+			generate(Rectanglei { { 0, 0 }, size_ }, generator);
+		}
 
 		/**
 		 * @brief      Constructor.
@@ -113,75 +254,183 @@ namespace Nene
 		 * @param[in]  width      The image width.
 		 * @param[in]  height     The image height.
 		 * @param[in]  generator  The pixel generator function.
+		 *
+		 * @tparam     Generator  The generator type.
+		 */
+		template <typename Generator, std::enable_if_t<isGenerator<Generator>, std::nullptr_t> = nullptr>
+		explicit BasicImage(Int32 width, Int32 height, Generator&& generator)
+			: BasicImage(Size2Di { width, height }, std::forward<Generator>(generator)) {}
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 *             The image is split into cache sized tiles which are
+		 *             generated concurrently, so `generator` must be safe to
+		 *             call from several threads at once.
+		 *
+		 * @param[in]  size       The image size.
+		 * @param[in]  generator  The pixel or row span generator function.
+		 * @param      pool       The thread pool to generate the tiles on.
+		 * @param[in]  layout     The storage layout.
+		 * @param[in]  allocator  The allocator of the pixel buffer.
+		 *
+		 * @tparam     Generator  The generator type.
 		 */
-		explicit Image(Int32 width, Int32 height, const std::function<Color4(const Vector2Di&)>& generator)
-			: data_()
-			, size_(width, height)
+		template <typename Generator, std::enable_if_t<isGenerator<Generator>, std::nullptr_t> = nullptr>
+		explicit BasicImage(const Size2Di& size, Generator&& generator, ThreadPool& pool, const ImageLayout& layout = ImageLayout::packed(), const Allocator& allocator = Allocator {})
+			: BasicImage(size, layout, allocator, Uninitialized {})
 		{
-			assert(width  > 0);
-			assert(height > 0);
+			// About 16KiB of pixels per tile.
+			constexpr Int32 tileHeight = 64;
+			constexpr Int32 tileWidth  = static_cast<Int32>((std::max)(std::size_t { 16 }, 256 / sizeof(Pixel)));
 
-			data_.resize(width * height);
+			const Int32 tilesX   = (size_.width  + tileWidth  - 1) / tileWidth;
+			const Int32 tilesY   = (size_.height + tileHeight - 1) / tileHeight;
+			const Int32 numTiles = tilesX * tilesY;
+			const Int32 grain    = (std::max)(numTiles / static_cast<Int32>((pool.numThreads() + 1) * 8), 1);
 
-			for (int y = 0; y < height; y++)
+			pool.parallelFor(0, numTiles, grain, [&](Int32 begin, Int32 end)
 			{
-				for (int x = 0; x < width; x++)
+				for (Int32 tile = begin; tile < end; tile++)
 				{
-					data_[x + y*width] = generator({ x, y });
+					const Int32 left = tile % tilesX * tileWidth;
+					const Int32 top  = tile / tilesX * tileHeight;
+
+					generate(
+						Rectanglei { left, top, (std::min)(left + tileWidth, size_.width), (std::min)(top + tileHeight, size_.height) },
+						generator);
 				}
+			});
+		}
+
+		/**
+		 * @brief      Destructor.
+		 */
+		~BasicImage()
+		{
+			release();
+		}
+
+		/**
+		 * @brief      Copy operator `=`.
+		 */
+		BasicImage& operator=(const BasicImage&) =delete;
+
+		/**
+		 * @brief      Move operator `=`.
+		 */
+		BasicImage& operator=(BasicImage&& image) noexcept
+		{
+			if (this != &image)
+			{
+				release();
+
+				allocator_  = std::move(image.allocator_);
+				buffer_     = std::exchange(image.buffer_, nullptr);
+				bufferSize_ = image.bufferSize_;
+				data_       = image.data_;
+				size_       = image.size_;
+				pitch_      = image.pitch_;
+				layout_     = image.layout_;
 			}
+
+			return *this;
 		}
 
 		/**
-		 * @brief      Constructor.
+		 * @brief      Converts into the view of the whole image.
+		 */
+		operator BasicImageView<Pixel>() const noexcept
+		{
+			return view();
+		}
+
+		/**
+		 * @brief      Converts into the mutable view of the whole image.
+		 */
+		operator BasicMutableImageView<Pixel>() noexcept
+		{
+			return mutableView();
+		}
+
+		/**
+		 * @brief      Returns the view of the whole image.
 		 *
-		 * @param[in]  size       The image size.
-		 * @param[in]  generator  The pixel generator function.
+		 * @return     The view of the image pixels.
 		 */
-		explicit Image(const Size2Di& size, const std::function<Color4(const Vector2Di&)>& generator)
-			: Image(size.width, size.height, generator) {}
+		[[nodiscard]]
+		BasicImageView<Pixel> view() const noexcept
+		{
+			return { data_, size_, pitch_ };
+		}
 
 		/**
-		 * @brief      Destructor.
+		 * @brief      Returns the view of the sub-rectangle.
+		 *
+		 * @param[in]  rect  The rectangle to refer.
+		 *
+		 * @return     The view of the sub-rectangle.
 		 */
-		~Image() =default;
+		[[nodiscard]]
+		BasicImageView<Pixel> view(const Rectanglei& rect) const noexcept
+		{
+			return view().subView(rect);
+		}
 
 		/**
-		 * @brief      Copy operator `=`.
+		 * @brief      Returns the mutable view of the whole image.
+		 *
+		 * @return     The mutable view of the image pixels.
 		 */
-		Image& operator=(const Image&) =delete;
+		[[nodiscard]]
+		BasicMutableImageView<Pixel> mutableView() noexcept
+		{
+			return { data_, size_, pitch_ };
+		}
 
 		/**
-		 * @brief      Move operator `=`.
+		 * @brief      Returns the mutable view of the sub-rectangle.
+		 *
+		 * @param[in]  rect  The rectangle to refer.
+		 *
+		 * @return     The mutable view of the sub-rectangle.
 		 */
-		Image& operator=(Image&&) =default;
+		[[nodiscard]]
+		BasicMutableImageView<Pixel> mutableView(const Rectanglei& rect) noexcept
+		{
+			return mutableView().subView(rect);
+		}
 
 		/**
-		 * @brief      Returns the image color data.
+		 * @brief      Returns the image pixel data.
+		 *
+		 *             The image must not have row padding.
 		 *
-		 * @return     The array of the pixel colors.
+		 * @return     The array of the pixels.
 		 */
 		[[nodiscard]]
-		ArrayView<Color4> data() const noexcept
+		ArrayView<Pixel> data() const noexcept
 		{
-			return data_;
+			assert(isContiguous());
+
+			return { data_, numPixels() };
 		}
 
 		/**
-		 * @brief      Returns the pointer to the image color data.
+		 * @brief      Returns the pointer to the image pixel data.
 		 *
-		 * @return     The pointer to the array of the pixel colors.
+		 * @return     The pointer to the first row of the pixels.
 		 */
 		[[nodiscard]]
-		Color4* dataPointer() noexcept
+		Pixel* dataPointer() noexcept
 		{
-			return data_.data();
+			return data_;
 		}
 
 		[[nodiscard]]
-		const Color4* dataPointer() const noexcept
+		const Pixel* dataPointer() const noexcept
 		{
-			return data_.data();
+			return data_;
 		}
 
 		/**
@@ -192,13 +441,36 @@ namespace Nene
 		[[nodiscard]]
 		Byte* dataBytes() noexcept
 		{
-			return reinterpret_cast<Byte*>(data_.data());
+			return reinterpret_cast<Byte*>(data_);
 		}
 
 		[[nodiscard]]
 		const Byte* dataBytes() const noexcept
 		{
-			return reinterpret_cast<const Byte*>(data_.data());
+			return reinterpret_cast<const Byte*>(data_);
+		}
+
+		/**
+		 * @brief      Returns the pointer to the row.
+		 *
+		 * @param[in]  y     The row index.
+		 *
+		 * @return     The pointer to the first pixel of the row.
+		 */
+		[[nodiscard]]
+		Pixel* row(Int32 y) noexcept
+		{
+			assert(0 <= y && y < size_.height);
+
+			return reinterpret_cast<Pixel*>(dataBytes() + pitch_ * y);
+		}
+
+		[[nodiscard]]
+		const Pixel* row(Int32 y) const noexcept
+		{
+			assert(0 <= y && y < size_.height);
+
+			return reinterpret_cast<const Pixel*>(dataBytes() + pitch_ * y);
 		}
 
 		/**
@@ -234,6 +506,50 @@ namespace Nene
 			return size_;
 		}
 
+		/**
+		 * @brief      Returns the distance between rows.
+		 *
+		 * @return     The row pitch in bytes.
+		 */
+		[[nodiscard]]
+		std::size_t pitch() const noexcept
+		{
+			return pitch_;
+		}
+
+		/**
+		 * @brief      Returns the storage layout.
+		 *
+		 * @return     The storage layout.
+		 */
+		[[nodiscard]]
+		const ImageLayout& layout() const noexcept
+		{
+			return layout_;
+		}
+
+		/**
+		 * @brief      Returns the allocator of the pixel buffer.
+		 *
+		 * @return     The allocator.
+		 */
+		[[nodiscard]]
+		const Allocator& allocator() const noexcept
+		{
+			return allocator_;
+		}
+
+		/**
+		 * @brief      Determines if the rows are packed without padding.
+		 *
+		 * @return     `true` if the rows are packed, `false` otherwise.
+		 */
+		[[nodiscard]]
+		bool isContiguous() const noexcept
+		{
+			return pitch_ == sizeof(Pixel) * size_.width;
+		}
+
 		/**
 		 * @brief      Returns number of pixels the image contains.
 		 *
@@ -242,31 +558,61 @@ namespace Nene
 		[[nodiscard]]
 		std::size_t numPixels() const noexcept
 		{
-			return size_.width * size_.height;
+			return static_cast<std::size_t>(size_.width) * size_.height;
 		}
 
 		/**
 		 * @brief      Returns bytes size of the image data.
 		 *
-		 * @return     Bytes size of the image data.
+		 * @return     Bytes size of the image data including the row padding.
 		 */
 		[[nodiscard]]
 		std::size_t sizeBytes() const noexcept
 		{
-			return numPixels() * sizeof(Color4);
+			return pitch_ * size_.height;
 		}
 
 		/**
 		 * @brief      Creates the new image data from the image.
 		 *
-		 * @return     Copy of the image data.
+		 * @return     Copy of the image data with the same layout.
+		 */
+		[[nodiscard]]
+		BasicImage clone() const
+		{
+			BasicImage image { size_, layout_, allocator_, Uninitialized {} };
+
+			std::memcpy(image.data_, data_, sizeBytes());
+
+			return image;
+		}
+
+		/**
+		 * @brief      Creates the new image data from the sub-rectangle.
+		 *
+		 * @param[in]  rect  The rectangle to copy.
+		 *
+		 * @return     Copy of the sub-rectangle with the same layout.
 		 */
 		[[nodiscard]]
-		Image clone() const noexcept
+		BasicImage clone(const Rectanglei& rect) const
 		{
-			return Image { size_, data_ };
+			return BasicImage { view(rect), layout_, allocator_ };
 		}
 	};
+
+	using Image        = BasicImage<PixelRGBA8>;
+	using ImageR8      = BasicImage<PixelR8>;
+	using ImageRG8     = BasicImage<PixelRG8>;
+	using ImageBGRA8   = BasicImage<PixelBGRA8>;
+	using ImageR16     = BasicImage<PixelR16>;
+	using ImageRGBA16F = BasicImage<PixelRGBA16F>;
+	using ImageRGBA32F = BasicImage<PixelRGBA32F>;
+
+	/**
+	 * @brief      Image of any pixel format.
+	 */
+	using AnyImage = std::variant<Image, ImageR8, ImageRG8, ImageBGRA8, ImageR16, ImageRGBA16F, ImageRGBA32F>;
 }
 
 #endif  // #ifndef INCLUDE_NENE_IMAGE_HPP
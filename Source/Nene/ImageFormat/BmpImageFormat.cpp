@@ -21,15 +21,25 @@
 // OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //=============================================================================
 
+#include <array>
+#include <cstring>
+#include <vector>
 #include <fmt/ostream.h>
 #include "BmpImageFormat.hpp"
 #include "BmpImageFormatException.hpp"
 #include "../Platform.hpp"
+#include "../Scope.hpp"
+#include "../Uncopyable.hpp"
+#include "../ImageProcessing/Convert.hpp"
 #include "../Reader/IReader.hpp"
 #include "../Serialization/BinaryDeserializer.hpp"
 #include "../Serialization/BinarySerializer.hpp"
 #include "../Writer/IWriter.hpp"
 
+#if defined(NENE_SIMD_SSSE3)
+#  include <tmmintrin.h>
+#endif
+
 namespace Nene
 {
 	namespace
@@ -113,144 +123,593 @@ namespace Nene
 				.serialize(header.colorImportant)
 			;
 		}
-	}
-
-	BmpImageFormat::BmpImageFormat(std::string_view name)
-		: name_(name) {}
 
-	const std::string& BmpImageFormat::name() const noexcept
-	{
-		return name_;
-	}
-
-	ArrayView<IImageFormat::path_type> BmpImageFormat::possibleExtensions() const noexcept
-	{
-		static const path_type extensions[] =
+		enum class BitmapCompression : UInt32
 		{
-			".bmp",
+			rgb            = 0,
+			rle8           = 1,
+			rle4           = 2,
+			bitFields      = 3,
+			jpeg           = 4,
+			png            = 5,
+			alphaBitFields = 6,
 		};
 
-		return extensions;
-	}
+		// Size of the pixel data read or written at once.
+		constexpr std::size_t batchBytes = 64 * 1024;
 
-	bool BmpImageFormat::isImageHeader(const std::array<Byte, 16>& header) const noexcept
-	{
-		constexpr Byte signature[2] =
+		// Color channel of the bit field pixels.
+		class BitField
 		{
-			byte(0x42), byte(0x4d),
-		};
+			UInt32 mask_;
+			UInt32 shift_;
+			UInt64 max_;
+
+		public:
+			constexpr explicit BitField(UInt32 mask = 0) noexcept
+				: mask_(mask)
+				, shift_(0)
+				, max_(0)
+			{
+				if (mask_ != 0)
+				{
+					while (!(mask_ >> shift_ & 1))
+					{
+						shift_++;
+					}
 
-		return std::memcmp(header.data(), signature, sizeof(signature)) == 0;
-	}
+					max_ = mask_ >> shift_;
+				}
+			}
 
-	Image BmpImageFormat::decode(IReader& reader)
-	{
-		Serialization::BinaryDeserializer archive { reader, Endian::Order::little };
+			[[nodiscard]]
+			constexpr bool empty() const noexcept
+			{
+				return mask_ == 0;
+			}
 
-		// Read file header.
-		BitmapFileHeader fileHeader;
-		archive.serialize(fileHeader);
+			// Extracts the channel scaled into 8bit.
+			[[nodiscard]]
+			constexpr UInt8 extract(UInt32 pixel, UInt8 fallback) const noexcept
+			{
+				if (mask_ == 0)
+				{
+					return fallback;
+				}
 
-		if (fileHeader.signature != 0x4d42)
-		{
-			throw BmpImageFormatException { u8"Unknown bitmap file format." };
-		}
+				const UInt64 value = (pixel & mask_) >> shift_;
 
-		// Read information header.
-		BitmapInfoHeader infoHeader;
-		archive.serialize(infoHeader);
+				return static_cast<UInt8>((value * 255 + max_ / 2) / max_);
+			}
+		};
 
-		if (infoHeader.headerSize != 40)
+		[[nodiscard]]
+		ImageInfo imageInfo(const BitmapInfoHeader& header, bool hasAlpha) noexcept
 		{
-			throw BmpImageFormatException { u8"Unknown bitmap file information header format." };
-		}
+			// Palette images report the index bits.
+			const bool indexed = header.bitCount <= 8;
 
-		if (infoHeader.bitPlanes != 1)
-		{
-			throw BmpImageFormatException { u8"Unknown bitmap image format." };
+			return
+			{
+				Size2Di { header.width, std::abs(header.height) },
+				indexed ? 1 : hasAlpha ? 4 : 3,
+				indexed ? header.bitCount : header.bitCount == 16 ? 5 : 8,
+				hasAlpha,
+				false,
+			};
 		}
 
-		if (infoHeader.compression != 0)
+		// Swizzles 24bit BGR pixels into RGBA.
+		void convertBgr(const UInt8* source, Color4* destination, std::size_t count) noexcept
 		{
-			throw BmpImageFormatException { u8"Unsupported bitmap compression format." };
-		}
+			std::size_t i = 0;
 
-		if (infoHeader.width <= 0)
-		{
-			throw BmpImageFormatException { u8"Invalid bitmap image size." };
-		}
+#if defined(NENE_SIMD_SSSE3)
+			const auto shuffle = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+			const auto alpha   = _mm_set1_epi32(static_cast<int>(0xff000000));
 
-		// Read pixels.
-		bool topDown = (infoHeader.height < 0);
+			// Each load covers 16 bytes of the 12 bytes used.
+			for (; i * 3 + 16 <= count * 3; i += 4)
+			{
+				const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 3));
 
-		Size2Di size =
-		{
-			infoHeader.width,
-			std::abs(infoHeader.height),
-		};
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alpha));
+			}
+#endif
 
-		Image image { size };
+			for (; i < count; i++)
+			{
+				destination[i].red   = source[i*3 + 2];
+				destination[i].green = source[i*3 + 1];
+				destination[i].blue  = source[i*3 + 0];
+				destination[i].alpha = 255;
+			}
+		}
 
-		switch (infoHeader.bitCount)
+		// Expands the run length encoded palette indices into top-down rows.
+		void expandRle(const UInt8* data, std::size_t size, bool rle4, Int32 width, Int32 height, UInt8* indices) noexcept
 		{
-			case 24:
+			Int32       x = 0;
+			Int32       y = 0; // Rows are stored bottom-up.
+			std::size_t i = 0;
+
+			const auto put = [&](UInt32 count, auto&& index)
+			{
+				const auto row = indices + static_cast<std::size_t>(height - 1 - y) * width;
+
+				for (UInt32 k = 0; k < count; k++, x++)
+				{
+					if (x < width)
+					{
+						row[x] = index(k);
+					}
+				}
+			};
+
+			while (i + 2 <= size && y < height)
 			{
-				for (Int32 y = 0; y < size.height; y++)
+				const UInt8 count = data[i++];
+				const UInt8 value = data[i++];
+
+				if (count > 0)
+				{
+					// Encoded mode.
+					put(count, [&](UInt32 k) -> UInt8
+					{
+						return rle4 ? (k & 1 ? value & 0x0f : value >> 4) : value;
+					});
+					continue;
+				}
+
+				switch (value)
 				{
-					for (Int32 x = 0; x < size.width; x++)
+					case 0:
+						// End of line.
+						x = 0;
+						y++;
+						break;
+
+					case 1:
+						// End of bitmap.
+						return;
+
+					case 2:
+						// Delta.
+						if (i + 2 > size)
+						{
+							return;
+						}
+
+						x += data[i + 0];
+						y += data[i + 1];
+						i += 2;
+						break;
+
+					default:
 					{
-						const std::size_t col = x;
-						const std::size_t row = topDown ? y : size.height - y - 1;
-						const std::size_t i   = x + col * size.width;
+						// Absolute mode, padded to 16bit.
+						const std::size_t bytes = rle4 ? (value + 1) / 2 : value;
 
-						archive
-							.serialize(image.dataPointer()[i].blue)
-							.serialize(image.dataPointer()[i].green)
-							.serialize(image.dataPointer()[i].red)
-						;
+						if (i + bytes > size)
+						{
+							return;
+						}
 
-						image.dataPointer()[i].alpha = 255;
+						const auto p = data + i;
+
+						put(value, [&](UInt32 k) -> UInt8
+						{
+							return rle4 ? (k & 1 ? p[k / 2] & 0x0f : p[k / 2] >> 4) : p[k];
+						});
+
+						i += (bytes + 1) & ~std::size_t { 1 };
+						break;
 					}
+				}
+			}
+		}
+
+		class BmpDecoder final
+			: public  IImageDecoder
+			, private Uncopyable
+		{
+			IReader&                 reader_;
+			ImageInfo                info_;
+			BitmapCompression        compression_;
+			UInt32                   bitCount_;
+			bool                     topDown_;
+			std::size_t              offset_;
+			std::size_t              stride_;
+			Int32                    row_;
+			std::array<BitField, 4>  fields_;
+			std::array<Color4, 256>  palette_;
+			std::vector<UInt8>       indices_;
+			std::vector<UInt8>       own_;
+			std::vector<UInt8>&      buffer_;
+
+			[[nodiscard]]
+			bool isRle() const noexcept
+			{
+				return compression_ == BitmapCompression::rle8 || compression_ == BitmapCompression::rle4;
+			}
+
+			// Reads the bit field masks.
+			void readFields(Serialization::BinaryDeserializer& archive, bool alpha)
+			{
+				UInt32 masks[4] = {};
+
+				for (Int32 i = 0; i < (alpha ? 4 : 3); i++)
+				{
+					archive.serialize(masks[i]);
+				}
+
+				for (Int32 i = 0; i < 4; i++)
+				{
+					fields_[i] = BitField { masks[i] };
+				}
+			}
+
+			void readPalette(std::size_t count)
+			{
+				std::array<UInt8, 256 * 4> entries;
+
+				if (reader_.read(entries.data(), count * 4) != count * 4)
+				{
+					throw BmpImageFormatException { u8"Unexpected end of bitmap data." };
+				}
 
-					UInt32 pad;
-					archive.read(&pad, size.width % 4);
+				for (std::size_t i = 0; i < count; i++)
+				{
+					palette_[i] = Color4 { entries[i*4 + 2], entries[i*4 + 1], entries[i*4 + 0], 255 };
 				}
+			}
+
+			// Decodes the whole run length encoded image.
+			void readRle()
+			{
+				const auto height = info_.size.height;
+				const auto width  = info_.size.width;
+				const auto size   = reader_.size() > offset_ ? reader_.size() - offset_ : std::size_t { 0 };
+
+				buffer_.resize(stride_ != 0 && stride_ < size ? stride_ : size);
+
+				reader_.position(offset_);
+				buffer_.resize(reader_.read(buffer_.data(), buffer_.size()));
 
-				break;
+				// Skipped pixels take the first palette entry.
+				indices_.assign(static_cast<std::size_t>(width) * height, 0);
+
+				expandRle(buffer_.data(), buffer_.size(), compression_ == BitmapCompression::rle4, width, height, indices_.data());
 			}
 
-			case 32:
+			void decodeRow(const UInt8* p, Color4* row, std::size_t width) const noexcept
 			{
-				for (Int32 y = 0; y < size.height; y++)
+				if (compression_ == BitmapCompression::bitFields || compression_ == BitmapCompression::alphaBitFields || bitCount_ == 16)
 				{
-					for (Int32 x = 0; x < size.width; x++)
+					for (std::size_t x = 0; x < width; x++)
 					{
-						const std::size_t col = x;
-						const std::size_t row = topDown ? y : size.height - y - 1;
-						const std::size_t i   = x + col * size.width;
-
-						archive
-							.serialize(image.dataPointer()[i].blue)
-							.serialize(image.dataPointer()[i].green)
-							.serialize(image.dataPointer()[i].red)
-							.serialize(image.dataPointer()[i].alpha)
-						;
+						const UInt32 pixel = bitCount_ == 16
+							? static_cast<UInt32>(p[x*2 + 0] | p[x*2 + 1] << 8)
+							: static_cast<UInt32>(p[x*4 + 0] | p[x*4 + 1] << 8 | p[x*4 + 2] << 16 | p[x*4 + 3] << 24);
+
+						row[x] = Color4
+						{
+							fields_[0].extract(pixel, 0),
+							fields_[1].extract(pixel, 0),
+							fields_[2].extract(pixel, 0),
+							fields_[3].extract(pixel, 255),
+						};
 					}
+					return;
 				}
 
-				break;
+				switch (bitCount_)
+				{
+					case 32:
+						ImageProcessing::convertRow(reinterpret_cast<const PixelBGRA8*>(p), row, width);
+						break;
+
+					case 24:
+						convertBgr(p, row, width);
+						break;
+
+					case 8:
+						for (std::size_t x = 0; x < width; x++)
+						{
+							row[x] = palette_[p[x]];
+						}
+						break;
+
+					case 4:
+						for (std::size_t x = 0; x < width; x++)
+						{
+							row[x] = palette_[p[x / 2] >> (x & 1 ? 0 : 4) & 0x0f];
+						}
+						break;
+
+					default:
+						for (std::size_t x = 0; x < width; x++)
+						{
+							row[x] = palette_[p[x / 8] >> (7 - x % 8) & 0x01];
+						}
+						break;
+				}
 			}
 
-			default:
+		public:
+			// `scratch` is used instead of the own buffer if given.
+			explicit BmpDecoder(IReader& reader, std::vector<UInt8>* scratch = nullptr)
+				: reader_(reader)
+				, info_()
+				, compression_(BitmapCompression::rgb)
+				, bitCount_(0)
+				, topDown_(false)
+				, offset_(0)
+				, stride_(0)
+				, row_(0)
+				, fields_()
+				, palette_()
+				, indices_()
+				, own_()
+				, buffer_(scratch ? *scratch : own_)
 			{
-				throw BmpImageFormatException { u8"Unsupported bitmap image format." };
+				const auto start = reader.position();
+
+				Serialization::BinaryDeserializer archive { reader, Endian::Order::little };
+
+				// Read file header.
+				BitmapFileHeader fileHeader;
+				archive.serialize(fileHeader);
+
+				if (fileHeader.signature != 0x4d42)
+				{
+					throw BmpImageFormatException { u8"Unknown bitmap file format." };
+				}
+
+				// Read information header; the later versions only append fields.
+				BitmapInfoHeader infoHeader;
+				archive.serialize(infoHeader);
+
+				if (infoHeader.headerSize < 40)
+				{
+					throw BmpImageFormatException { u8"Unknown bitmap file information header format." };
+				}
+
+				if (infoHeader.bitPlanes != 1)
+				{
+					throw BmpImageFormatException { u8"Unknown bitmap image format." };
+				}
+
+				if (infoHeader.width <= 0 || infoHeader.height == 0)
+				{
+					throw BmpImageFormatException { u8"Invalid bitmap image size." };
+				}
+
+				compression_ = static_cast<BitmapCompression>(infoHeader.compression);
+				bitCount_    = infoHeader.bitCount;
+
+				const bool bitFields = compression_ == BitmapCompression::bitFields || compression_ == BitmapCompression::alphaBitFields;
+
+				switch (compression_)
+				{
+					case BitmapCompression::rgb:
+						if (bitCount_ != 1 && bitCount_ != 4 && bitCount_ != 8 && bitCount_ != 16 && bitCount_ != 24 && bitCount_ != 32)
+						{
+							throw BmpImageFormatException { u8"Unsupported bitmap image format." };
+						}
+						break;
+
+					case BitmapCompression::rle8:
+					case BitmapCompression::rle4:
+						if (bitCount_ != (compression_ == BitmapCompression::rle8 ? 8u : 4u) || infoHeader.height < 0)
+						{
+							throw BmpImageFormatException { u8"Invalid bitmap compression format." };
+						}
+						break;
+
+					case BitmapCompression::bitFields:
+					case BitmapCompression::alphaBitFields:
+						if (bitCount_ != 16 && bitCount_ != 32)
+						{
+							throw BmpImageFormatException { u8"Invalid bitmap compression format." };
+						}
+						break;
+
+					default:
+						throw BmpImageFormatException { u8"Unsupported bitmap compression format." };
+				}
+
+				if (bitFields)
+				{
+					// The masks follow the header unless it has the fields of them.
+					readFields(archive, compression_ == BitmapCompression::alphaBitFields || infoHeader.headerSize >= 56);
+				}
+				else if (bitCount_ == 16)
+				{
+					// 5-5-5.
+					fields_ = { BitField { 0x7c00 }, BitField { 0x03e0 }, BitField { 0x001f }, BitField {} };
+				}
+
+				if (bitCount_ <= 8)
+				{
+					// Read the palette after the header and the masks.
+					const auto maxColors = std::size_t { 1 } << bitCount_;
+					const auto colors    = infoHeader.colorUsed == 0 ? maxColors : (std::min)(std::size_t { infoHeader.colorUsed }, maxColors);
+
+					palette_.fill(Color4 { 0, 0, 0, 255 });
+
+					reader.position(start + 14 + infoHeader.headerSize);
+					readPalette(colors);
+				}
+
+				info_ = imageInfo(infoHeader, bitFields ? !fields_[3].empty() : bitCount_ == 32);
+
+				// Rows are padded to 4 bytes.
+				topDown_ = infoHeader.height < 0;
+				offset_  = start + fileHeader.offset;
+				stride_  = isRle()
+					? infoHeader.sizeImage
+					: (static_cast<std::size_t>(infoHeader.width) * bitCount_ + 31) / 32 * 4;
+			}
+
+			~BmpDecoder() =default;
+
+			[[nodiscard]]
+			const ImageInfo& info() const noexcept override
+			{
+				return info_;
+			}
+
+			[[nodiscard]]
+			Int32 currentRow() const noexcept override
+			{
+				return row_;
+			}
+
+			Int32 readRows(MutableImageView rows) override
+			{
+				assert(rows.width() == info_.size.width);
+
+				const auto height = info_.size.height;
+				const auto width  = static_cast<std::size_t>(info_.size.width);
+				const auto count  = (std::min)(rows.height(), height - row_);
+
+				if (isRle())
+				{
+					if (row_ == 0 && count > 0)
+					{
+						readRle();
+					}
+
+					for (Int32 y = 0; y < count; y++)
+					{
+						const auto p   = indices_.data() + width * (row_ + y);
+						const auto row = rows.row(y);
+
+						for (std::size_t x = 0; x < width; x++)
+						{
+							row[x] = palette_[p[x]];
+						}
+					}
+
+					row_ += count;
+
+					return count;
+				}
+
+				const auto batch = static_cast<Int32>((std::max)(batchBytes / stride_, std::size_t { 1 }));
+
+				for (Int32 y = 0; y < count; )
+				{
+					// The batch is a contiguous run of rows in either storage order.
+					const auto n     = (std::min)(batch, count - y);
+					const auto first = topDown_ ? row_ + y : height - (row_ + y) - n;
+
+					buffer_.resize(stride_ * n);
+
+					reader_.position(offset_ + stride_ * first);
+
+					if (reader_.read(buffer_.data(), buffer_.size()) != buffer_.size())
+					{
+						throw BmpImageFormatException { u8"Unexpected end of bitmap data." };
+					}
+
+					for (Int32 i = 0; i < n; i++, y++)
+					{
+						decodeRow(buffer_.data() + stride_ * (topDown_ ? i : n - i - 1), rows.row(y), width);
+					}
+				}
+
+				row_ += count;
+
+				if (count > 0 && row_ == height)
+				{
+					// Leave the reader at the end of the pixel data.
+					reader_.position(offset_ + stride_ * height);
+				}
+
+				return count;
 			}
+		};
+
+		// Pixel data buffer reused by the images on the thread.
+		std::vector<UInt8>& threadBuffer() noexcept
+		{
+			thread_local std::vector<UInt8> buffer;
+
+			return buffer;
 		}
+	}
+
+	BmpImageFormat::BmpImageFormat(std::string_view name)
+		: name_(name) {}
+
+	const std::string& BmpImageFormat::name() const noexcept
+	{
+		return name_;
+	}
+
+	ArrayView<IImageFormat::path_type> BmpImageFormat::possibleExtensions() const noexcept
+	{
+		static const path_type extensions[] =
+		{
+			".bmp",
+		};
+
+		return extensions;
+	}
+
+	bool BmpImageFormat::isImageHeader(const std::array<Byte, 16>& header) const noexcept
+	{
+		constexpr Byte signature[2] =
+		{
+			byte(0x42), byte(0x4d),
+		};
+
+		return std::memcmp(header.data(), signature, sizeof(signature)) == 0;
+	}
+
+	ImageInfo BmpImageFormat::probe(IReader& reader)
+	{
+		const auto position = reader.position();
+
+		[[maybe_unused]] const auto _ = scopeExit([&]()
+		{
+			reader.position(position);
+		});
+
+		// The decoder reads only the headers and the palette up front.
+		return BmpDecoder { reader }.info();
+	}
+
+	Image BmpImageFormat::decode(IReader& reader)
+	{
+		BmpDecoder decoder { reader, &threadBuffer() };
+
+		Image image { decoder.info().size };
+		decoder.readRows(image.mutableView());
 
 		return image;
 	}
 
-	void BmpImageFormat::encode(const Image& image, IWriter& writer)
+	void BmpImageFormat::decodeInto(IReader& reader, MutableImageView image)
+	{
+		BmpDecoder decoder { reader, &threadBuffer() };
+
+		if (decoder.info().size != image.size())
+		{
+			throw BmpImageFormatException { u8"Image size mismatch." };
+		}
+
+		decoder.readRows(image);
+	}
+
+	std::unique_ptr<IImageDecoder> BmpImageFormat::createDecoder(IReader& reader)
+	{
+		return std::make_unique<BmpDecoder>(reader);
+	}
+
+	void BmpImageFormat::encode(ImageView image, IWriter& writer)
 	{
 		Serialization::BinarySerializer archive { writer, Endian::Order::little };
 
@@ -278,23 +737,34 @@ namespace Nene
 			/*.colorImportant =*/0,
 		});
 
-		for (Int32 y = image.height() - 1; y >= 0; y--)
+		const auto width  = static_cast<std::size_t>(image.width());
+		const auto stride = width * 4;
+		const auto batch  = static_cast<Int32>((std::max)(batchBytes / stride, std::size_t { 1 }));
+
+		auto& buffer = threadBuffer();
+
+		// Write bottom-up rows in batches.
+		for (Int32 y = image.height(); y > 0; )
 		{
-			for (Int32 x = 0; x < image.width(); x++)
+			const auto n = (std::min)(batch, y);
+
+			buffer.resize(stride * n);
+
+			for (Int32 i = 0; i < n; i++)
 			{
-				const std::size_t i = static_cast<std::size_t>(x + y * image.width());
-
-				archive
-					.serialize(image.data()[i].blue)
-					.serialize(image.data()[i].green)
-					.serialize(image.data()[i].red)
-					.serialize(image.data()[i].alpha)
-				;
+				ImageProcessing::convertRow(image.row(y - 1 - i), reinterpret_cast<PixelBGRA8*>(buffer.data() + stride * i), width);
 			}
+
+			if (writer.write(buffer.data(), buffer.size()) != buffer.size())
+			{
+				throw BmpImageFormatException { u8"Failed to write bitmap data." };
+			}
+
+			y -= n;
 		}
 	}
 
-	void BmpImageFormat::encode(const Image& image, IWriter& writer, [[maybe_unused]] Int32 quality)
+	void BmpImageFormat::encode(ImageView image, IWriter& writer, [[maybe_unused]] Int32 quality)
 	{
 		encode(image, writer);
 	}
@@ -69,21 +69,38 @@ namespace Nene
 		[[nodiscard]]
 		bool isImageHeader(const std::array<Byte, 16>& header) const noexcept override;
 
+		/**
+		 * @see        `Nene::IImageFormat::probe()`.
+		 */
+		[[nodiscard]]
+		ImageInfo probe(IReader& reader) override;
+
 		/**
 		 * @see        `Nene::IImageFormat::decode()`.
 		 */
 		[[nodiscard]]
 		Image decode(IReader& reader) override;
 
+		/**
+		 * @see        `Nene::IImageFormat::decodeInto()`.
+		 */
+		void decodeInto(IReader& reader, MutableImageView image) override;
+
+		/**
+		 * @see        `Nene::IImageFormat::createDecoder()`.
+		 */
+		[[nodiscard]]
+		std::unique_ptr<IImageDecoder> createDecoder(IReader& reader) override;
+
 		/**
 		 * @see        `Nene::IImageFormat::encode()`.
 		 */
-		void encode(const Image& image, IWriter& writer) override;
+		void encode(ImageView image, IWriter& writer) override;
 
 		/**
 		 * @see        `Nene::IImageFormat::encode()`.
 		 */
-		void encode(const Image& image, IWriter& writer, Int32 quality) override;
+		void encode(ImageView image, IWriter& writer, Int32 quality) override;
 	};
 }
 
@@ -0,0 +1,99 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_IMAGEFORMAT_BUFFEREDIMAGEDECODER_HPP
+#define INCLUDE_NENE_IMAGEFORMAT_BUFFEREDIMAGEDECODER_HPP
+
+#include "../Image.hpp"
+#include "../Uncopyable.hpp"
+#include "IImageDecoder.hpp"
+
+namespace Nene
+{
+	/**
+	 * @brief      Image decoder serving the rows of an already decoded image.
+	 */
+	class BufferedImageDecoder final
+		: public  IImageDecoder
+		, private Uncopyable
+	{
+		Image     image_;
+		ImageInfo info_;
+		Int32     row_;
+
+	public:
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param      image  The decoded image.
+		 * @param[in]  info   The properties of the encoded image.
+		 */
+		explicit BufferedImageDecoder(Image&& image, const ImageInfo& info) noexcept
+			: image_(std::move(image))
+			, info_(info)
+			, row_(0)
+		{
+			assert(info_.size == image_.size());
+		}
+
+		/**
+		 * @brief      Destructor.
+		 */
+		~BufferedImageDecoder() =default;
+
+		/**
+		 * @see        `Nene::IImageDecoder::info()`.
+		 */
+		[[nodiscard]]
+		const ImageInfo& info() const noexcept override
+		{
+			return info_;
+		}
+
+		/**
+		 * @see        `Nene::IImageDecoder::currentRow()`.
+		 */
+		[[nodiscard]]
+		Int32 currentRow() const noexcept override
+		{
+			return row_;
+		}
+
+		/**
+		 * @see        `Nene::IImageDecoder::readRows()`.
+		 */
+		Int32 readRows(MutableImageView rows) override
+		{
+			assert(rows.width() == image_.width());
+
+			const auto count = (std::min)(rows.height(), image_.height() - row_);
+
+			rows.rows(0, count).copyFrom(image_.view().rows(row_, count));
+			row_ += count;
+
+			return count;
+		}
+	};
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGEFORMAT_BUFFEREDIMAGEDECODER_HPP
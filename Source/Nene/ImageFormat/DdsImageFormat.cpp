@@ -0,0 +1,806 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include "DdsImageFormat.hpp"
+#include "DdsImageFormatException.hpp"
+#include "../Scope.hpp"
+#include "../ImageProcessing/BlockCompression.hpp"
+#include "../ImageProcessing/Convert.hpp"
+#include "../Reader/IReader.hpp"
+#include "../Serialization/BinaryDeserializer.hpp"
+#include "../Serialization/BinarySerializer.hpp"
+#include "../Writer/IWriter.hpp"
+
+namespace Nene
+{
+	namespace
+	{
+		constexpr UInt32 fourCC(char a, char b, char c, char d) noexcept
+		{
+			return static_cast<UInt32>(a) | static_cast<UInt32>(b) << 8 | static_cast<UInt32>(c) << 16 | static_cast<UInt32>(d) << 24;
+		}
+
+		constexpr UInt32 magic = fourCC('D', 'D', 'S', ' ');
+
+		// The largest Direct3D texture is 16384 pixels wide.
+		constexpr UInt32 maxDimension = 16384;
+		constexpr UInt32 maxArraySize = 2048;
+
+		// Header flags.
+		constexpr UInt32 ddsdCaps         = 0x00000001;
+		constexpr UInt32 ddsdHeight       = 0x00000002;
+		constexpr UInt32 ddsdWidth        = 0x00000004;
+		constexpr UInt32 ddsdPitch        = 0x00000008;
+		constexpr UInt32 ddsdPixelFormat  = 0x00001000;
+		constexpr UInt32 ddsdMipMapCount  = 0x00020000;
+		constexpr UInt32 ddsdLinearSize   = 0x00080000;
+
+		// Pixel format flags.
+		constexpr UInt32 ddpfAlphaPixels  = 0x00000001;
+		constexpr UInt32 ddpfFourCC       = 0x00000004;
+		constexpr UInt32 ddpfRgb          = 0x00000040;
+
+		// Capability flags.
+		constexpr UInt32 ddsCapsComplex   = 0x00000008;
+		constexpr UInt32 ddsCapsTexture   = 0x00001000;
+		constexpr UInt32 ddsCapsMipMap    = 0x00400000;
+		constexpr UInt32 ddsCaps2CubeMap  = 0x00000200;
+		constexpr UInt32 ddsCaps2AllFaces = 0x0000fc00;
+		constexpr UInt32 ddsCaps2Volume   = 0x00200000;
+
+		// DX10 header values.
+		constexpr UInt32 dimensionTexture2D = 3;
+		constexpr UInt32 miscTextureCube    = 0x00000004;
+
+		// `D3DFMT_A16B16G16R16F`.
+		constexpr UInt32 d3dFormatRgba16f = 36;
+
+		struct DdsPixelFormat
+		{
+			UInt32 size;
+			UInt32 flags;
+			UInt32 fourCC;
+			UInt32 rgbBitCount;
+			UInt32 redMask;
+			UInt32 greenMask;
+			UInt32 blueMask;
+			UInt32 alphaMask;
+		};
+
+		struct DdsHeader
+		{
+			UInt32         size;
+			UInt32         flags;
+			UInt32         height;
+			UInt32         width;
+			UInt32         pitchOrLinearSize;
+			UInt32         depth;
+			UInt32         mipMapCount;
+			UInt32         reserved1[11];
+			DdsPixelFormat pixelFormat;
+			UInt32         caps;
+			UInt32         caps2;
+			UInt32         caps3;
+			UInt32         caps4;
+			UInt32         reserved2;
+		};
+
+		struct DdsHeaderDx10
+		{
+			UInt32 dxgiFormat;
+			UInt32 resourceDimension;
+			UInt32 miscFlag;
+			UInt32 arraySize;
+			UInt32 miscFlags2;
+		};
+
+		void load(Serialization::BinaryDeserializer& archive, DdsPixelFormat& format)
+		{
+			archive
+				.serialize(format.size)
+				.serialize(format.flags)
+				.serialize(format.fourCC)
+				.serialize(format.rgbBitCount)
+				.serialize(format.redMask)
+				.serialize(format.greenMask)
+				.serialize(format.blueMask)
+				.serialize(format.alphaMask)
+			;
+		}
+
+		void save(Serialization::BinarySerializer& archive, const DdsPixelFormat& format)
+		{
+			archive
+				.serialize(format.size)
+				.serialize(format.flags)
+				.serialize(format.fourCC)
+				.serialize(format.rgbBitCount)
+				.serialize(format.redMask)
+				.serialize(format.greenMask)
+				.serialize(format.blueMask)
+				.serialize(format.alphaMask)
+			;
+		}
+
+		void load(Serialization::BinaryDeserializer& archive, DdsHeader& header)
+		{
+			archive
+				.serialize(header.size)
+				.serialize(header.flags)
+				.serialize(header.height)
+				.serialize(header.width)
+				.serialize(header.pitchOrLinearSize)
+				.serialize(header.depth)
+				.serialize(header.mipMapCount)
+			;
+
+			for (auto& reserved : header.reserved1)
+			{
+				archive.serialize(reserved);
+			}
+
+			archive
+				.serialize(header.pixelFormat)
+				.serialize(header.caps)
+				.serialize(header.caps2)
+				.serialize(header.caps3)
+				.serialize(header.caps4)
+				.serialize(header.reserved2)
+			;
+		}
+
+		void save(Serialization::BinarySerializer& archive, const DdsHeader& header)
+		{
+			archive
+				.serialize(header.size)
+				.serialize(header.flags)
+				.serialize(header.height)
+				.serialize(header.width)
+				.serialize(header.pitchOrLinearSize)
+				.serialize(header.depth)
+				.serialize(header.mipMapCount)
+			;
+
+			for (const auto reserved : header.reserved1)
+			{
+				archive.serialize(reserved);
+			}
+
+			archive
+				.serialize(header.pixelFormat)
+				.serialize(header.caps)
+				.serialize(header.caps2)
+				.serialize(header.caps3)
+				.serialize(header.caps4)
+				.serialize(header.reserved2)
+			;
+		}
+
+		void load(Serialization::BinaryDeserializer& archive, DdsHeaderDx10& header)
+		{
+			archive
+				.serialize(header.dxgiFormat)
+				.serialize(header.resourceDimension)
+				.serialize(header.miscFlag)
+				.serialize(header.arraySize)
+				.serialize(header.miscFlags2)
+			;
+		}
+
+		void save(Serialization::BinarySerializer& archive, const DdsHeaderDx10& header)
+		{
+			archive
+				.serialize(header.dxgiFormat)
+				.serialize(header.resourceDimension)
+				.serialize(header.miscFlag)
+				.serialize(header.arraySize)
+				.serialize(header.miscFlags2)
+			;
+		}
+
+		struct DxgiFormat
+		{
+			UInt32        dxgi;
+			TextureFormat format;
+		};
+
+		// The first entry of each format is used for writing.
+		constexpr DxgiFormat dxgiFormats[] =
+		{
+			{ 10, TextureFormat::rgba16f    }, // DXGI_FORMAT_R16G16B16A16_FLOAT
+			{ 28, TextureFormat::rgba8      }, // DXGI_FORMAT_R8G8B8A8_UNORM
+			{ 27, TextureFormat::rgba8      }, // DXGI_FORMAT_R8G8B8A8_TYPELESS
+			{ 29, TextureFormat::rgba8Srgb  }, // DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+			{ 87, TextureFormat::bgra8      }, // DXGI_FORMAT_B8G8R8A8_UNORM
+			{ 90, TextureFormat::bgra8      }, // DXGI_FORMAT_B8G8R8A8_TYPELESS
+			{ 91, TextureFormat::bgra8Srgb  }, // DXGI_FORMAT_B8G8R8A8_UNORM_SRGB
+			{ 88, TextureFormat::bgrx8      }, // DXGI_FORMAT_B8G8R8X8_UNORM
+			{ 92, TextureFormat::bgrx8      }, // DXGI_FORMAT_B8G8R8X8_TYPELESS
+			{ 93, TextureFormat::bgrx8Srgb  }, // DXGI_FORMAT_B8G8R8X8_UNORM_SRGB
+			{ 71, TextureFormat::bc1        }, // DXGI_FORMAT_BC1_UNORM
+			{ 70, TextureFormat::bc1        }, // DXGI_FORMAT_BC1_TYPELESS
+			{ 72, TextureFormat::bc1Srgb    }, // DXGI_FORMAT_BC1_UNORM_SRGB
+			{ 74, TextureFormat::bc2        }, // DXGI_FORMAT_BC2_UNORM
+			{ 73, TextureFormat::bc2        }, // DXGI_FORMAT_BC2_TYPELESS
+			{ 75, TextureFormat::bc2Srgb    }, // DXGI_FORMAT_BC2_UNORM_SRGB
+			{ 77, TextureFormat::bc3        }, // DXGI_FORMAT_BC3_UNORM
+			{ 76, TextureFormat::bc3        }, // DXGI_FORMAT_BC3_TYPELESS
+			{ 78, TextureFormat::bc3Srgb    }, // DXGI_FORMAT_BC3_UNORM_SRGB
+			{ 80, TextureFormat::bc4        }, // DXGI_FORMAT_BC4_UNORM
+			{ 79, TextureFormat::bc4        }, // DXGI_FORMAT_BC4_TYPELESS
+			{ 83, TextureFormat::bc5        }, // DXGI_FORMAT_BC5_UNORM
+			{ 82, TextureFormat::bc5        }, // DXGI_FORMAT_BC5_TYPELESS
+			{ 95, TextureFormat::bc6h       }, // DXGI_FORMAT_BC6H_UF16
+			{ 94, TextureFormat::bc6h       }, // DXGI_FORMAT_BC6H_TYPELESS
+			{ 96, TextureFormat::bc6hSigned }, // DXGI_FORMAT_BC6H_SF16
+			{ 98, TextureFormat::bc7        }, // DXGI_FORMAT_BC7_UNORM
+			{ 97, TextureFormat::bc7        }, // DXGI_FORMAT_BC7_TYPELESS
+			{ 99, TextureFormat::bc7Srgb    }, // DXGI_FORMAT_BC7_UNORM_SRGB
+		};
+
+		struct LegacyFormat
+		{
+			UInt32        fourCC;
+			TextureFormat format;
+		};
+
+		// The first entry of each format is used for writing.
+		constexpr LegacyFormat legacyFormats[] =
+		{
+			{ fourCC('D', 'X', 'T', '1'), TextureFormat::bc1     },
+			{ fourCC('D', 'X', 'T', '3'), TextureFormat::bc2     },
+			{ fourCC('D', 'X', 'T', '2'), TextureFormat::bc2     },
+			{ fourCC('D', 'X', 'T', '5'), TextureFormat::bc3     },
+			{ fourCC('D', 'X', 'T', '4'), TextureFormat::bc3     },
+			{ fourCC('A', 'T', 'I', '1'), TextureFormat::bc4     },
+			{ fourCC('B', 'C', '4', 'U'), TextureFormat::bc4     },
+			{ fourCC('A', 'T', 'I', '2'), TextureFormat::bc5     },
+			{ fourCC('B', 'C', '5', 'U'), TextureFormat::bc5     },
+			{ d3dFormatRgba16f,           TextureFormat::rgba16f },
+		};
+
+		// Layout of the texture data.
+		struct DdsLayout
+		{
+			TextureFormat format;
+			Size2Di       size;
+			Int32         numLevels;
+			Int32         arraySize;
+			bool          cubeMap;
+			bool          opaque;
+		};
+
+		[[nodiscard]]
+		bool hasAlpha(const DdsPixelFormat& format) noexcept
+		{
+			return (format.flags & ddpfAlphaPixels) && format.alphaMask != 0;
+		}
+
+		[[nodiscard]]
+		TextureFormat pixelFormat(const DdsPixelFormat& format)
+		{
+			if (format.flags & ddpfFourCC)
+			{
+				for (const auto& legacy : legacyFormats)
+				{
+					if (legacy.fourCC == format.fourCC)
+					{
+						return legacy.format;
+					}
+				}
+			}
+			else if ((format.flags & ddpfRgb) && format.rgbBitCount == 32 && format.greenMask == 0x0000ff00)
+			{
+				// X8B8G8R8 has no DXGI format, so the X byte is overwritten with opaque alpha on loading.
+				if (format.redMask == 0x000000ff && format.blueMask == 0x00ff0000)
+				{
+					return TextureFormat::rgba8;
+				}
+
+				if (format.redMask == 0x00ff0000 && format.blueMask == 0x000000ff)
+				{
+					return hasAlpha(format) ? TextureFormat::bgra8 : TextureFormat::bgrx8;
+				}
+			}
+
+			throw DdsImageFormatException { u8"Unsupported DDS pixel format." };
+		}
+
+		[[nodiscard]]
+		TextureFormat pixelFormat(UInt32 dxgiFormat)
+		{
+			for (const auto& dxgi : dxgiFormats)
+			{
+				if (dxgi.dxgi == dxgiFormat)
+				{
+					return dxgi.format;
+				}
+			}
+
+			throw DdsImageFormatException { u8"Unsupported DDS pixel format." };
+		}
+
+		[[nodiscard]]
+		DdsLayout readHeader(IReader& reader)
+		{
+			Serialization::BinaryDeserializer archive { reader, Endian::Order::little };
+
+			UInt32 signature;
+			archive.serialize(signature);
+
+			DdsHeader header;
+			archive.serialize(header);
+
+			if (signature != magic || header.size != 124 || header.pixelFormat.size != 32)
+			{
+				throw DdsImageFormatException { u8"Unknown DDS file format." };
+			}
+
+			if (header.caps2 & ddsCaps2Volume)
+			{
+				throw DdsImageFormatException { u8"Volume textures are not supported." };
+			}
+
+			if (header.width == 0 || header.height == 0 || header.width > maxDimension || header.height > maxDimension)
+			{
+				throw DdsImageFormatException { u8"Invalid DDS image size." };
+			}
+
+			DdsLayout layout;
+			layout.size      = { static_cast<Int32>(header.width), static_cast<Int32>(header.height) };
+			layout.numLevels = (std::max)(static_cast<Int32>(header.mipMapCount), 1);
+			layout.arraySize = 1;
+			layout.cubeMap   = false;
+			layout.opaque    = false;
+
+			if (layout.numLevels > MipChain::fullLevels(layout.size))
+			{
+				throw DdsImageFormatException { u8"Invalid DDS mipmap count." };
+			}
+
+			if ((header.pixelFormat.flags & ddpfFourCC) && header.pixelFormat.fourCC == fourCC('D', 'X', '1', '0'))
+			{
+				DdsHeaderDx10 extension;
+				archive.serialize(extension);
+
+				if (extension.resourceDimension != dimensionTexture2D)
+				{
+					throw DdsImageFormatException { u8"Only 2D textures are supported." };
+				}
+
+				if (extension.arraySize == 0 || extension.arraySize > maxArraySize)
+				{
+					throw DdsImageFormatException { u8"Invalid DDS array size." };
+				}
+
+				layout.format    = pixelFormat(extension.dxgiFormat);
+				layout.cubeMap   = (extension.miscFlag & miscTextureCube) != 0;
+				layout.arraySize = static_cast<Int32>(extension.arraySize) * (layout.cubeMap ? 6 : 1);
+			}
+			else
+			{
+				layout.format = pixelFormat(header.pixelFormat);
+				layout.opaque = !(header.pixelFormat.flags & ddpfFourCC) && !hasAlpha(header.pixelFormat);
+
+				if (header.caps2 & ddsCaps2CubeMap)
+				{
+					if ((header.caps2 & ddsCaps2AllFaces) != ddsCaps2AllFaces)
+					{
+						throw DdsImageFormatException { u8"Partial cube maps are not supported." };
+					}
+
+					layout.cubeMap   = true;
+					layout.arraySize = 6;
+				}
+			}
+
+			if (layout.format == TextureFormat::bgrx8 || layout.format == TextureFormat::bgrx8Srgb)
+			{
+				layout.opaque = true;
+			}
+
+			return layout;
+		}
+
+		[[nodiscard]]
+		std::size_t totalBytes(const DdsLayout& layout) noexcept
+		{
+			std::size_t bytes = 0;
+
+			for (Int32 level = 0; level < layout.numLevels; level++)
+			{
+				const Size2Di size { (std::max)(layout.size.width >> level, 1), (std::max)(layout.size.height >> level, 1) };
+
+				bytes += TextureData::levelBytes(layout.format, size);
+			}
+
+			return bytes * static_cast<std::size_t>(layout.arraySize);
+		}
+
+		void writeHeader(IWriter& writer, const DdsLayout& layout)
+		{
+			const bool compressed = TextureData::isCompressed(layout.format);
+			const bool array      = layout.arraySize != (layout.cubeMap ? 6 : 1);
+
+			// Find a legacy description of the format.
+			std::optional<DdsPixelFormat> legacy;
+
+			if (layout.format == TextureFormat::rgba8 || layout.format == TextureFormat::bgra8 || layout.format == TextureFormat::bgrx8)
+			{
+				const bool rgba  = layout.format == TextureFormat::rgba8;
+				const bool alpha = layout.format != TextureFormat::bgrx8;
+
+				legacy = DdsPixelFormat
+				{
+					/*.size        =*/32,
+					/*.flags       =*/ddpfRgb | (alpha ? ddpfAlphaPixels : 0),
+					/*.fourCC      =*/0,
+					/*.rgbBitCount =*/32,
+					/*.redMask     =*/rgba ? 0x000000ffu : 0x00ff0000u,
+					/*.greenMask   =*/0x0000ff00,
+					/*.blueMask    =*/rgba ? 0x00ff0000u : 0x000000ffu,
+					/*.alphaMask   =*/alpha ? 0xff000000u : 0x00000000u,
+				};
+			}
+			else
+			{
+				for (const auto& entry : legacyFormats)
+				{
+					if (entry.format == layout.format)
+					{
+						legacy = DdsPixelFormat { 32, ddpfFourCC, entry.fourCC, 0, 0, 0, 0, 0 };
+						break;
+					}
+				}
+			}
+
+			const bool dx10 = array || !legacy;
+
+			DdsHeader header = {};
+			header.size              = 124;
+			header.flags             = ddsdCaps | ddsdHeight | ddsdWidth | ddsdPixelFormat | (compressed ? ddsdLinearSize : ddsdPitch);
+			header.height            = static_cast<UInt32>(layout.size.height);
+			header.width             = static_cast<UInt32>(layout.size.width);
+			header.pitchOrLinearSize = static_cast<UInt32>(compressed ? TextureData::levelBytes(layout.format, layout.size) : TextureData::rowBytes(layout.format, layout.size.width));
+			header.mipMapCount       = static_cast<UInt32>(layout.numLevels);
+			header.pixelFormat       = dx10 ? DdsPixelFormat { 32, ddpfFourCC, fourCC('D', 'X', '1', '0'), 0, 0, 0, 0, 0 } : *legacy;
+			header.caps              = ddsCapsTexture;
+
+			if (layout.numLevels > 1)
+			{
+				header.flags |= ddsdMipMapCount;
+				header.caps  |= ddsCapsComplex | ddsCapsMipMap;
+			}
+
+			if (layout.cubeMap || array)
+			{
+				header.caps |= ddsCapsComplex;
+			}
+
+			if (layout.cubeMap)
+			{
+				header.caps2 |= ddsCaps2CubeMap | ddsCaps2AllFaces;
+			}
+
+			Serialization::BinarySerializer archive { writer, Endian::Order::little };
+
+			archive.serialize(magic);
+			archive.serialize(header);
+
+			if (dx10)
+			{
+				const auto dxgi = std::find_if(std::begin(dxgiFormats), std::end(dxgiFormats), [&](const DxgiFormat& entry)
+				{
+					return entry.format == layout.format;
+				});
+
+				archive.serialize(DdsHeaderDx10
+				{
+					/*.dxgiFormat        =*/dxgi->dxgi,
+					/*.resourceDimension =*/dimensionTexture2D,
+					/*.miscFlag          =*/layout.cubeMap ? miscTextureCube : 0,
+					/*.arraySize         =*/static_cast<UInt32>(layout.arraySize / (layout.cubeMap ? 6 : 1)),
+					/*.miscFlags2        =*/0,
+				});
+			}
+		}
+
+		[[nodiscard]]
+		std::optional<ImageProcessing::BlockFormat> blockFormat(TextureFormat format) noexcept
+		{
+			switch (format)
+			{
+				case TextureFormat::bc1:
+				case TextureFormat::bc1Srgb:
+					return ImageProcessing::BlockFormat::bc1;
+
+				case TextureFormat::bc3:
+				case TextureFormat::bc3Srgb:
+					return ImageProcessing::BlockFormat::bc3;
+
+				case TextureFormat::bc4:
+					return ImageProcessing::BlockFormat::bc4;
+
+				case TextureFormat::bc5:
+					return ImageProcessing::BlockFormat::bc5;
+
+				case TextureFormat::bc7:
+				case TextureFormat::bc7Srgb:
+					return ImageProcessing::BlockFormat::bc7;
+
+				default:
+					return std::nullopt;
+			}
+		}
+
+		// Reads the top level of the first array item.
+		[[nodiscard]]
+		std::vector<Byte> readTopLevel(IReader& reader, DdsLayout& layout)
+		{
+			layout = readHeader(reader);
+
+			const auto size = TextureData::levelBytes(layout.format, layout.size);
+
+			std::vector<Byte> data(size);
+
+			if (reader.read(data.data(), size) != size)
+			{
+				throw DdsImageFormatException { u8"Unexpected end of DDS data." };
+			}
+
+			return data;
+		}
+
+		template <typename Pixel, typename From = Pixel>
+		[[nodiscard]]
+		BasicImage<Pixel> copyImage(const std::vector<Byte>& data, const Size2Di& size, bool opaque = false)
+		{
+			BasicImage<Pixel> image { size };
+
+			ImageProcessing::convert(BasicImageView<From> { reinterpret_cast<const From*>(data.data()), size }, image.mutableView());
+
+			// Writers often leave the unused X byte zero.
+			if (opaque)
+			{
+				for (Int32 y = 0; y < size.height; y++)
+				{
+					const auto row = image.row(y);
+
+					for (Int32 x = 0; x < size.width; x++)
+					{
+						row[x].alpha = 255;
+					}
+				}
+			}
+
+			return image;
+		}
+	}
+
+	DdsImageFormat::DdsImageFormat(std::string_view name)
+		: name_(name) {}
+
+	const std::string& DdsImageFormat::name() const noexcept
+	{
+		return name_;
+	}
+
+	ArrayView<IImageFormat::path_type> DdsImageFormat::possibleExtensions() const noexcept
+	{
+		static const path_type extensions[] =
+		{
+			".dds",
+		};
+
+		return extensions;
+	}
+
+	bool DdsImageFormat::isImageHeader(const std::array<Byte, 16>& header) const noexcept
+	{
+		constexpr Byte signature[8] =
+		{
+			byte(0x44), byte(0x44), byte(0x53), byte(0x20), byte(0x7c), byte(0x00), byte(0x00), byte(0x00),
+		};
+
+		return std::memcmp(header.data(), signature, sizeof(signature)) == 0;
+	}
+
+	ImageInfo DdsImageFormat::probe(IReader& reader)
+	{
+		const auto position = reader.position();
+
+		[[maybe_unused]] const auto _ = scopeExit([&]()
+		{
+			reader.position(position);
+		});
+
+		const auto layout = readHeader(reader);
+
+		switch (layout.format)
+		{
+			case TextureFormat::bc4:
+				return { layout.size, 1, 8, false, false };
+
+			case TextureFormat::bc5:
+				return { layout.size, 2, 8, false, false };
+
+			case TextureFormat::bc6h:
+			case TextureFormat::bc6hSigned:
+				return { layout.size, 3, 16, false, false };
+
+			case TextureFormat::rgba16f:
+				return { layout.size, 4, 16, true, false };
+
+			default:
+				return layout.opaque
+					? ImageInfo { layout.size, 3, 8, false, false }
+					: ImageInfo { layout.size, 4, 8, true,  false };
+		}
+	}
+
+	Image DdsImageFormat::decode(IReader& reader)
+	{
+		DdsLayout layout;
+		const auto data = readTopLevel(reader, layout);
+
+		switch (layout.format)
+		{
+			case TextureFormat::rgba8:
+			case TextureFormat::rgba8Srgb:
+				return copyImage<PixelRGBA8>(data, layout.size, layout.opaque);
+
+			case TextureFormat::bgra8:
+			case TextureFormat::bgra8Srgb:
+			case TextureFormat::bgrx8:
+			case TextureFormat::bgrx8Srgb:
+				return copyImage<PixelRGBA8, PixelBGRA8>(data, layout.size, layout.opaque);
+
+			case TextureFormat::rgba16f:
+				return copyImage<PixelRGBA8, PixelRGBA16F>(data, layout.size);
+
+			default:
+				break;
+		}
+
+		if (const auto format = blockFormat(layout.format))
+		{
+			return ImageProcessing::decompressBlocks(data, layout.size, *format);
+		}
+
+		throw DdsImageFormatException { u8"Unsupported DDS pixel format for decoding." };
+	}
+
+	AnyImage DdsImageFormat::decodeNative(IReader& reader)
+	{
+		const auto position = reader.position();
+
+		const auto layout = readHeader(reader);
+
+		reader.position(position);
+
+		// The uncompressed formats are kept as is.
+		switch (layout.format)
+		{
+			case TextureFormat::bgra8:
+			case TextureFormat::bgra8Srgb:
+			case TextureFormat::bgrx8:
+			case TextureFormat::bgrx8Srgb:
+			{
+				DdsLayout top;
+				const auto data = readTopLevel(reader, top);
+
+				return copyImage<PixelBGRA8>(data, top.size, top.opaque);
+			}
+
+			case TextureFormat::rgba16f:
+			{
+				DdsLayout top;
+				const auto data = readTopLevel(reader, top);
+
+				return copyImage<PixelRGBA16F>(data, top.size);
+			}
+
+			default:
+				return decode(reader);
+		}
+	}
+
+	TextureData DdsImageFormat::decodeTexture(IReader& reader)
+	{
+		const auto layout = readHeader(reader);
+		const auto size   = totalBytes(layout);
+
+		if (reader.size() - reader.position() < size)
+		{
+			throw DdsImageFormatException { u8"Unexpected end of DDS data." };
+		}
+
+		TextureData texture { layout.format, layout.size, layout.numLevels, layout.arraySize, layout.cubeMap };
+
+		// The subresources are stored in the same order.
+		if (reader.read(texture.mutableData(), size) != size)
+		{
+			throw DdsImageFormatException { u8"Unexpected end of DDS data." };
+		}
+
+		// BGRX is uploaded as B8G8R8X8, but RGBX has no such format and is uploaded as RGBA.
+		if (layout.opaque && (layout.format == TextureFormat::rgba8 || layout.format == TextureFormat::rgba8Srgb))
+		{
+			const auto data = texture.mutableData();
+
+			for (std::size_t i = 3; i < size; i += 4)
+			{
+				data[i] = byte(0xff);
+			}
+		}
+
+		return texture;
+	}
+
+	void DdsImageFormat::encode(ImageView image, IWriter& writer)
+	{
+		writeHeader(writer, { TextureFormat::rgba8, image.size(), 1, 1, false });
+
+		const auto stride = static_cast<std::size_t>(image.width()) * sizeof(Color4);
+
+		if (image.isContiguous())
+		{
+			const auto size = stride * image.height();
+
+			if (writer.write(image.row(0), size) != size)
+			{
+				throw DdsImageFormatException { u8"Failed to write DDS data." };
+			}
+
+			return;
+		}
+
+		for (Int32 y = 0; y < image.height(); y++)
+		{
+			if (writer.write(image.row(y), stride) != stride)
+			{
+				throw DdsImageFormatException { u8"Failed to write DDS data." };
+			}
+		}
+	}
+
+	void DdsImageFormat::encode(ImageView image, IWriter& writer, [[maybe_unused]] Int32 quality)
+	{
+		encode(image, writer);
+	}
+
+	void DdsImageFormat::encodeTexture(const TextureData& texture, IWriter& writer)
+	{
+		writeHeader(writer, { texture.format(), texture.size(), texture.numLevels(), texture.arraySize(), texture.isCubeMap() });
+
+		const auto data = texture.data();
+
+		if (writer.write(data.data(), data.size()) != data.size())
+		{
+			throw DdsImageFormatException { u8"Failed to write DDS data." };
+		}
+	}
+}
@@ -0,0 +1,131 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_IMAGEFORMAT_DDSIMAGEFORMAT_HPP
+#define INCLUDE_NENE_IMAGEFORMAT_DDSIMAGEFORMAT_HPP
+
+#include "../TextureData.hpp"
+#include "../Uncopyable.hpp"
+#include "IImageFormat.hpp"
+
+namespace Nene
+{
+	/**
+	 * @brief      DDS (DirectDraw Surface) format.
+	 *
+	 *             Supports 2D textures with mipmaps, arrays and cube maps in
+	 *             the RGBA8, BGRA8, RGBA16F and BC1 to BC7 formats, with the
+	 *             legacy and the DX10 headers. The image interface decodes the
+	 *             top level of the first array item, and decompresses the
+	 *             block formats in every mode they define.
+	 */
+	class DdsImageFormat final
+		: public  IImageFormat
+		, private Uncopyable
+	{
+		std::string name_;
+
+	public:
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  name  Image format name.
+		 */
+		explicit DdsImageFormat(std::string_view name);
+
+		/**
+		 * @brief      Destructor.
+		 */
+		~DdsImageFormat() =default;
+
+		/**
+		 * @see        `Nene::IImageFormat::name()`.
+		 */
+		[[nodiscard]]
+		const std::string& name() const noexcept override;
+
+		/**
+		 * @see        `Nene::IImageFormat::possibleExtensions()`.
+		 */
+		[[nodiscard]]
+		ArrayView<path_type> possibleExtensions() const noexcept override;
+
+		/**
+		 * @see        `Nene::IImageFormat::isImageHeader()`.
+		 */
+		[[nodiscard]]
+		bool isImageHeader(const std::array<Byte, 16>& header) const noexcept override;
+
+		/**
+		 * @see        `Nene::IImageFormat::probe()`.
+		 */
+		[[nodiscard]]
+		ImageInfo probe(IReader& reader) override;
+
+		/**
+		 * @see        `Nene::IImageFormat::decode()`.
+		 *
+		 *             BC2 and BC6H textures can not be decoded into images.
+		 */
+		[[nodiscard]]
+		Image decode(IReader& reader) override;
+
+		/**
+		 * @see        `Nene::IImageFormat::decodeNative()`.
+		 */
+		[[nodiscard]]
+		AnyImage decodeNative(IReader& reader) override;
+
+		/**
+		 * @brief      Reads the texture data as is from a reader.
+		 *
+		 * @param      reader  The texture data reader.
+		 *
+		 * @return     All the subresources of the texture from `reader`.
+		 */
+		[[nodiscard]]
+		TextureData decodeTexture(IReader& reader);
+
+		/**
+		 * @see        `Nene::IImageFormat::encode()`.
+		 */
+		void encode(ImageView image, IWriter& writer) override;
+
+		/**
+		 * @see        `Nene::IImageFormat::encode()`.
+		 */
+		void encode(ImageView image, IWriter& writer, Int32 quality) override;
+
+		/**
+		 * @brief      Writes the texture data as is to a writer.
+		 *
+		 *             The legacy header is used if it can describe the texture.
+		 *
+		 * @param[in]  texture  The texture data.
+		 * @param      writer   The texture data writer.
+		 */
+		void encodeTexture(const TextureData& texture, IWriter& writer);
+	};
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGEFORMAT_DDSIMAGEFORMAT_HPP
@@ -0,0 +1,727 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+#include <algorithm>
+#include <cstring>
+#include "GifAnimationDecoder.hpp"
+#include "GifImageFormatException.hpp"
+#include "../Reader/IReader.hpp"
+#include "../Serialization/BinaryDeserializer.hpp"
+
+namespace Nene
+{
+	namespace
+	{
+		constexpr UInt8 blockExtension = 0x21;
+		constexpr UInt8 blockImage     = 0x2c;
+		constexpr UInt8 blockTrailer   = 0x3b;
+
+		constexpr UInt8 extensionGraphicControl = 0xf9;
+		constexpr UInt8 extensionApplication    = 0xff;
+
+		constexpr UInt32 maxCodes = 4096;
+
+		const Color4 transparentColor { 0, 0, 0, 0 };
+
+		struct GifHeader
+		{
+			UInt8  signature[6];
+			UInt16 width;
+			UInt16 height;
+			UInt8  flags;
+			UInt8  backgroundIndex;
+			UInt8  aspectRatio;
+		};
+
+		void load(Serialization::BinaryDeserializer& archive, GifHeader& header)
+		{
+			for (auto& c : header.signature)
+			{
+				archive.serialize(c);
+			}
+
+			archive
+				.serialize(header.width)
+				.serialize(header.height)
+				.serialize(header.flags)
+				.serialize(header.backgroundIndex)
+				.serialize(header.aspectRatio)
+			;
+		}
+
+		struct GifImageDescriptor
+		{
+			UInt16 left;
+			UInt16 top;
+			UInt16 width;
+			UInt16 height;
+			UInt8  flags;
+		};
+
+		void load(Serialization::BinaryDeserializer& archive, GifImageDescriptor& descriptor)
+		{
+			archive
+				.serialize(descriptor.left)
+				.serialize(descriptor.top)
+				.serialize(descriptor.width)
+				.serialize(descriptor.height)
+				.serialize(descriptor.flags)
+			;
+		}
+
+		void readBytes(IReader& reader, void* buffer, std::size_t size)
+		{
+			if (reader.read(buffer, size) != size)
+			{
+				throw GifImageFormatException { u8"Unexpected end of GIF data." };
+			}
+		}
+
+		[[nodiscard]]
+		UInt8 readByte(IReader& reader)
+		{
+			UInt8 value;
+			readBytes(reader, &value, 1);
+
+			return value;
+		}
+
+		void skipSubBlocks(IReader& reader)
+		{
+			while (const auto size = readByte(reader))
+			{
+				reader.position(reader.position() + size);
+			}
+		}
+
+		void readPalette(IReader& reader, UInt8 flags, std::array<Color4, 256>& palette)
+		{
+			const auto numColors = std::size_t { 2 } << (flags & 0x07);
+
+			UInt8 rgb[256 * 3];
+			readBytes(reader, rgb, numColors * 3);
+
+			for (std::size_t i = 0; i < numColors; i++)
+			{
+				palette[i] = Color4 { rgb[i * 3 + 0], rgb[i * 3 + 1], rgb[i * 3 + 2] };
+			}
+
+			// Indices out of the palette are black.
+			std::fill(palette.begin() + numColors, palette.end(), Color4 { 0, 0, 0 });
+		}
+
+		[[nodiscard]]
+		Rectanglei unite(const Rectanglei& a, const Rectanglei& b) noexcept
+		{
+			if (a.area() <= 0)
+			{
+				return b;
+			}
+
+			if (b.area() <= 0)
+			{
+				return a;
+			}
+
+			return
+			{
+				(std::min)(a.left(),   b.left()),
+				(std::min)(a.top(),    b.top()),
+				(std::max)(a.right(),  b.right()),
+				(std::max)(a.bottom(), b.bottom()),
+			};
+		}
+
+		/**
+		 * @brief      Incremental decoder of the LZW compressed color indices.
+		 */
+		class LzwDecoder final
+			: private Uncopyable
+		{
+			const std::vector<UInt8>& data_;
+			UInt32      minCodeSize_;
+			UInt32      clearCode_;
+			UInt32      codeSize_;
+			UInt32      nextCode_;
+			UInt32      prevCode_;
+			UInt32      bits_;
+			UInt32      numBits_;
+			std::size_t in_;
+			bool        finished_;
+
+			// Each code is the previous code followed by a byte.
+			UInt16 prefix_[maxCodes];
+			UInt8  suffix_[maxCodes];
+			UInt8  first_ [maxCodes];
+			UInt16 length_[maxCodes];
+
+			// The rest of the string not fitting in the last output.
+			UInt8       pending_[maxCodes];
+			std::size_t pendingBegin_;
+			std::size_t pendingEnd_;
+
+			void reset() noexcept
+			{
+				codeSize_ = minCodeSize_ + 1;
+				nextCode_ = clearCode_ + 2;
+				prevCode_ = maxCodes;
+			}
+
+			// Writes the string of the code backwards.
+			void writeString(UInt32 code, UInt8* out) const noexcept
+			{
+				for (auto p = out + length_[code]; p != out; )
+				{
+					*--p = suffix_[code];
+					code = prefix_[code];
+				}
+			}
+
+		public:
+			explicit LzwDecoder(const std::vector<UInt8>& data, UInt32 minCodeSize) noexcept
+				: data_(data)
+				, minCodeSize_(minCodeSize)
+				, clearCode_(1 << minCodeSize)
+				, codeSize_()
+				, nextCode_()
+				, prevCode_()
+				, bits_(0)
+				, numBits_(0)
+				, in_(0)
+				, finished_(false)
+				, pendingBegin_(0)
+				, pendingEnd_(0)
+			{
+				for (UInt32 code = 0; code < clearCode_; code++)
+				{
+					prefix_[code] = 0;
+					suffix_[code] = static_cast<UInt8>(code);
+					first_ [code] = static_cast<UInt8>(code);
+					length_[code] = 1;
+				}
+
+				reset();
+			}
+
+			~LzwDecoder() =default;
+
+			/**
+			 * @brief      Decodes the next indices.
+			 *
+			 * @return     Number of the indices decoded, less than `size` if the data is truncated or broken.
+			 */
+			[[nodiscard]]
+			std::size_t decode(UInt8* out, std::size_t size) noexcept
+			{
+				std::size_t pos = 0;
+
+				if (pendingBegin_ < pendingEnd_)
+				{
+					const auto n = (std::min)(size, pendingEnd_ - pendingBegin_);
+
+					std::copy_n(pending_ + pendingBegin_, n, out);
+
+					pos           += n;
+					pendingBegin_ += n;
+				}
+
+				while (pos < size && !finished_)
+				{
+					while (numBits_ < codeSize_)
+					{
+						if (in_ >= data_.size())
+						{
+							finished_ = true;
+							return pos;
+						}
+
+						bits_    |= UInt32 { data_[in_++] } << numBits_;
+						numBits_ += 8;
+					}
+
+					const auto code = bits_ & ((1 << codeSize_) - 1);
+
+					bits_    >>= codeSize_;
+					numBits_  -= codeSize_;
+
+					if (code == clearCode_)
+					{
+						reset();
+						continue;
+					}
+
+					if (code == clearCode_ + 1)
+					{
+						finished_ = true;
+						break;
+					}
+
+					if (prevCode_ == maxCodes)
+					{
+						if (code > clearCode_)
+						{
+							finished_ = true;
+							break;
+						}
+
+						out[pos++] = static_cast<UInt8>(code);
+						prevCode_  = code;
+						continue;
+					}
+
+					// The code may be the one to be added, which starts with the previous code.
+					if (code > nextCode_ || (code == nextCode_ && nextCode_ == maxCodes))
+					{
+						finished_ = true;
+						break;
+					}
+
+					if (nextCode_ < maxCodes)
+					{
+						prefix_[nextCode_] = static_cast<UInt16>(prevCode_);
+						suffix_[nextCode_] = code < nextCode_ ? first_[code] : first_[prevCode_];
+						first_ [nextCode_] = first_[prevCode_];
+						length_[nextCode_] = static_cast<UInt16>(length_[prevCode_] + 1);
+						nextCode_++;
+
+						if (nextCode_ == (1u << codeSize_) && codeSize_ < 12)
+						{
+							codeSize_++;
+						}
+					}
+
+					const auto length = std::size_t { length_[code] };
+
+					if (length <= size - pos)
+					{
+						writeString(code, out + pos);
+						pos += length;
+					}
+					else
+					{
+						writeString(code, pending_);
+
+						pendingBegin_ = size - pos;
+						pendingEnd_   = length;
+
+						std::copy_n(pending_, pendingBegin_, out + pos);
+						pos = size;
+					}
+
+					prevCode_ = code;
+				}
+
+				return pos;
+			}
+		};
+
+		[[nodiscard]]
+		GifDisposal disposal(UInt8 flags) noexcept
+		{
+			switch ((flags >> 2) & 0x07)
+			{
+			case 2:
+				return GifDisposal::background;
+
+			case 3:
+				return GifDisposal::previous;
+
+			default:
+				return GifDisposal::keep;
+			}
+		}
+	}
+
+	GifAnimationDecoder::GifAnimationDecoder(IReader& reader)
+		: reader_(reader)
+		, firstBlock_()
+		, size_()
+		, loopCount_(1)
+		, globalPalette_()
+		, canvas_()
+		, frame_()
+		, dirtyRect_()
+		, decodedFrames_(0)
+		, finished_(false)
+		, saved_()
+		, data_()
+		, indices_()
+	{
+		Serialization::BinaryDeserializer archive { reader_, Endian::Order::little };
+
+		GifHeader header;
+		archive.serialize(header);
+
+		if (std::memcmp(header.signature, "GIF87a", 6) != 0 && std::memcmp(header.signature, "GIF89a", 6) != 0)
+		{
+			throw GifImageFormatException { u8"Unknown GIF file format." };
+		}
+
+		if (header.width == 0 || header.height == 0)
+		{
+			throw GifImageFormatException { u8"Invalid GIF image size." };
+		}
+
+		size_ = Size2Di { header.width, header.height };
+
+		if (header.flags & 0x80)
+		{
+			readPalette(reader_, header.flags, globalPalette_);
+		}
+		else
+		{
+			globalPalette_.fill(Color4 { 0, 0, 0 });
+		}
+
+		firstBlock_ = reader_.position();
+
+		// Look for the loop count before the first frame.
+		UInt8 introducer;
+
+		while (reader_.read(&introducer, 1) == 1 && introducer == blockExtension)
+		{
+			if (readByte(reader_) != extensionApplication)
+			{
+				skipSubBlocks(reader_);
+				continue;
+			}
+
+			UInt8 identifier[256] = {};
+			readBytes(reader_, identifier, readByte(reader_));
+
+			if (std::memcmp(identifier, "NETSCAPE2.0", 11) == 0 || std::memcmp(identifier, "ANIMEXTS1.0", 11) == 0)
+			{
+				if (const auto size = readByte(reader_); size > 0)
+				{
+					UInt8 block[256];
+					readBytes(reader_, block, size);
+
+					if (size >= 3 && block[0] == 1)
+					{
+						loopCount_ = block[1] | (block[2] << 8);
+					}
+				}
+				else
+				{
+					continue;
+				}
+			}
+
+			skipSubBlocks(reader_);
+		}
+
+		reader_.position(firstBlock_);
+	}
+
+	void GifAnimationDecoder::dispose(MutableImageView canvas)
+	{
+		const auto& rect = frame_.rect;
+
+		if (rect.area() <= 0)
+		{
+			return;
+		}
+
+		switch (frame_.disposal)
+		{
+		case GifDisposal::background:
+			// Browsers clear to transparent rather than the background color.
+			canvas.subView(rect).fill(transparentColor);
+			break;
+
+		case GifDisposal::previous:
+			for (Int32 y = 0; y < rect.height(); y++)
+			{
+				std::copy_n(saved_.data() + static_cast<std::size_t>(y) * rect.width(), rect.width(), canvas.row(rect.top() + y) + rect.left());
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	void GifAnimationDecoder::decodeFrame(MutableImageView canvas, const Rectanglei& area, const std::array<Color4, 256>& palette, std::optional<UInt8> transparentIndex)
+	{
+		const auto minCodeSize = readByte(reader_);
+
+		if (minCodeSize < 1 || minCodeSize > 11)
+		{
+			throw GifImageFormatException { u8"Invalid GIF LZW code size." };
+		}
+
+		// Gather the data sub-blocks.
+		data_.clear();
+
+		while (const auto size = readByte(reader_))
+		{
+			const auto offset = data_.size();
+
+			data_.resize(offset + size);
+			readBytes(reader_, data_.data() + offset, size);
+		}
+
+		const auto& rect  = frame_.rect;
+		const auto  width = static_cast<std::size_t>(area.width());
+
+		if (rect.area() <= 0)
+		{
+			return;
+		}
+
+		// Decode a row at a time so the buffer is bounded by the frame width.
+		LzwDecoder lzw { data_, minCodeSize };
+
+		indices_.resize(width);
+
+		// Interlaced rows are stored in four passes.
+		constexpr Int32 interlaceStart[] = { 0, 4, 2, 1 };
+		constexpr Int32 interlaceStep[]  = { 8, 8, 4, 2 };
+
+		Int32 pass = 0;
+		Int32 y    = 0;
+		Int32 step = frame_.interlaced ? interlaceStep[0] : 1;
+
+		// Rows out of the canvas are decoded only to skip them, until the last visible one.
+		auto remainingRows = rect.height();
+
+		for (Int32 row = 0; row < area.height() && remainingRows > 0; row++, y += step)
+		{
+			while (y >= area.height())
+			{
+				pass++;
+				y    = interlaceStart[pass];
+				step = interlaceStep[pass];
+			}
+
+			const auto numIndices = lzw.decode(indices_.data(), width);
+
+			const auto dstY = area.top() + y;
+			const auto src  = static_cast<std::size_t>(rect.left() - area.left());
+
+			if (dstY >= rect.top() && dstY < rect.bottom())
+			{
+				remainingRows--;
+			}
+
+			if (dstY < rect.top() || dstY >= rect.bottom() || src >= numIndices)
+			{
+				if (numIndices < width)
+				{
+					break;
+				}
+
+				continue;
+			}
+
+			const auto indices = indices_.data() + src;
+			const auto pixels  = canvas.row(dstY) + rect.left();
+			const auto count   = static_cast<Int32>((std::min)(std::size_t { static_cast<UInt32>(rect.width()) }, numIndices - src));
+
+			if (transparentIndex)
+			{
+				const auto transparent = *transparentIndex;
+
+				for (Int32 x = 0; x < count; x++)
+				{
+					if (indices[x] != transparent)
+					{
+						pixels[x] = palette[indices[x]];
+					}
+				}
+			}
+			else
+			{
+				for (Int32 x = 0; x < count; x++)
+				{
+					pixels[x] = palette[indices[x]];
+				}
+			}
+		}
+	}
+
+	const Size2Di& GifAnimationDecoder::size() const noexcept
+	{
+		return size_;
+	}
+
+	Int32 GifAnimationDecoder::loopCount() const noexcept
+	{
+		return loopCount_;
+	}
+
+	bool GifAnimationDecoder::next()
+	{
+		if (!canvas_)
+		{
+			canvas_.emplace(size_);
+		}
+
+		return next(canvas_->mutableView());
+	}
+
+	bool GifAnimationDecoder::next(MutableImageView canvas)
+	{
+		if (canvas.size() != size_)
+		{
+			throw GifImageFormatException { u8"Canvas size mismatch." };
+		}
+
+		if (finished_)
+		{
+			return false;
+		}
+
+		// Read the blocks up to the next image.
+		UInt8 graphicControl[4] = {};
+
+		for (;;)
+		{
+			UInt8 introducer;
+
+			// Files missing the trailer end at the last frame.
+			if (reader_.read(&introducer, 1) != 1 || introducer == blockTrailer)
+			{
+				finished_  = true;
+				dirtyRect_ = Rectanglei {};
+
+				return false;
+			}
+
+			if (introducer == blockImage)
+			{
+				break;
+			}
+
+			if (introducer != blockExtension)
+			{
+				throw GifImageFormatException { u8"Unknown GIF block." };
+			}
+
+			if (readByte(reader_) == extensionGraphicControl)
+			{
+				if (const auto size = readByte(reader_); size >= 4)
+				{
+					readBytes(reader_, graphicControl, 4);
+					reader_.position(reader_.position() + size - 4);
+				}
+				else
+				{
+					reader_.position(reader_.position() + size);
+				}
+			}
+
+			skipSubBlocks(reader_);
+		}
+
+		Serialization::BinaryDeserializer archive { reader_, Endian::Order::little };
+
+		GifImageDescriptor descriptor;
+		archive.serialize(descriptor);
+
+		std::array<Color4, 256> localPalette;
+
+		if (descriptor.flags & 0x80)
+		{
+			readPalette(reader_, descriptor.flags, localPalette);
+		}
+
+		const auto& palette = (descriptor.flags & 0x80) ? localPalette : globalPalette_;
+
+		// Dispose the previous frame before compositing.
+		auto dirtyRect = Rectanglei {};
+
+		if (decodedFrames_ == 0)
+		{
+			canvas.fill(transparentColor);
+			dirtyRect = Rectanglei { Vector2Di { 0, 0 }, size_ };
+		}
+		else
+		{
+			dispose(canvas);
+
+			if (frame_.disposal != GifDisposal::keep)
+			{
+				dirtyRect = frame_.rect;
+			}
+		}
+
+		const Rectanglei area { Vector2Di { descriptor.left, descriptor.top }, Size2Di { descriptor.width, descriptor.height } };
+
+		const auto left   = (std::min)(area.left(),   size_.width);
+		const auto top    = (std::min)(area.top(),    size_.height);
+		const auto right  = (std::min)(area.right(),  size_.width);
+		const auto bottom = (std::min)(area.bottom(), size_.height);
+
+		frame_.index       = decodedFrames_;
+		frame_.rect        = Rectanglei { left, top, right, bottom };
+		frame_.delay       = std::chrono::milliseconds { (graphicControl[1] | (graphicControl[2] << 8)) * 10 };
+		frame_.disposal    = disposal(graphicControl[0]);
+		frame_.transparent = (graphicControl[0] & 0x01) != 0;
+		frame_.interlaced  = (descriptor.flags & 0x40) != 0;
+
+		// Keep the pixels under the frame to restore them on the disposal.
+		if (frame_.disposal == GifDisposal::previous)
+		{
+			const auto& rect = frame_.rect;
+
+			saved_.resize(static_cast<std::size_t>(rect.width()) * rect.height());
+
+			for (Int32 y = 0; y < rect.height(); y++)
+			{
+				std::copy_n(canvas.row(rect.top() + y) + rect.left(), rect.width(), saved_.data() + static_cast<std::size_t>(y) * rect.width());
+			}
+		}
+
+		decodeFrame(canvas, area, palette, frame_.transparent ? std::optional<UInt8> { graphicControl[3] } : std::nullopt);
+
+		dirtyRect_ = unite(dirtyRect, frame_.rect);
+		decodedFrames_++;
+
+		return true;
+	}
+
+	void GifAnimationDecoder::rewind()
+	{
+		reader_.position(firstBlock_);
+
+		frame_         = GifFrameInfo {};
+		dirtyRect_     = Rectanglei {};
+		decodedFrames_ = 0;
+		finished_      = false;
+	}
+
+	const GifFrameInfo& GifAnimationDecoder::frame() const noexcept
+	{
+		return frame_;
+	}
+
+	const Rectanglei& GifAnimationDecoder::dirtyRect() const noexcept
+	{
+		return dirtyRect_;
+	}
+
+	ImageView GifAnimationDecoder::canvas() const noexcept
+	{
+		return canvas_ ? canvas_->view() : ImageView {};
+	}
+}
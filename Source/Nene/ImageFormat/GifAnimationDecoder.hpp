@@ -0,0 +1,218 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+#ifndef INCLUDE_NENE_IMAGEFORMAT_GIFANIMATIONDECODER_HPP
+#define INCLUDE_NENE_IMAGEFORMAT_GIFANIMATIONDECODER_HPP
+
+#include <array>
+#include <chrono>
+#include <optional>
+#include <vector>
+#include "../Image.hpp"
+#include "../Uncopyable.hpp"
+
+namespace Nene
+{
+	// Forward declarations.
+	class IReader;
+
+	/**
+	 * @brief      How a GIF frame is disposed before the next frame.
+	 */
+	enum class GifDisposal: Int32
+	{
+		/**
+		 * @brief      The frame is left on the canvas.
+		 */
+		keep,
+
+		/**
+		 * @brief      The frame area is cleared to transparent.
+		 */
+		background,
+
+		/**
+		 * @brief      The frame area is restored to the pixels before the frame.
+		 */
+		previous,
+	};
+
+	/**
+	 * @brief      GIF animation frame properties.
+	 */
+	class GifFrameInfo
+	{
+	public:
+		/**
+		 * @brief      Index of the frame from zero.
+		 */
+		Int32 index = 0;
+
+		/**
+		 * @brief      Area of the frame clipped to the canvas.
+		 */
+		Rectanglei rect;
+
+		/**
+		 * @brief      Display duration of the frame.
+		 */
+		std::chrono::milliseconds delay { 0 };
+
+		/**
+		 * @brief      How the frame is disposed before the next frame.
+		 */
+		GifDisposal disposal = GifDisposal::keep;
+
+		/**
+		 * @brief      `true` if the frame has transparent pixels.
+		 */
+		bool transparent = false;
+
+		/**
+		 * @brief      `true` if the frame rows are interlaced.
+		 */
+		bool interlaced = false;
+	};
+
+	/**
+	 * @brief      GIF animation decoder streaming the frames.
+	 *
+	 *             Frames are composited one by one into a canvas which is
+	 *             reused through the animation, so the memory stays constant
+	 *             regardless of the number of frames. Only the area changed by
+	 *             the frame and the disposal of the previous frame is touched,
+	 *             and it is reported by `dirtyRect()` so that the callers can
+	 *             update only that area.
+	 *
+	 * @code
+	 * GifAnimationDecoder decoder { reader };
+	 *
+	 * while (decoder.next())
+	 * {
+	 *     upload(decoder.canvas().subView(decoder.dirtyRect()), decoder.dirtyRect().position);
+	 * }
+	 * @endcode
+	 */
+	class GifAnimationDecoder final
+		: private Uncopyable
+	{
+		IReader&                reader_;
+		std::size_t             firstBlock_;
+		Size2Di                 size_;
+		Int32                   loopCount_;
+		std::array<Color4, 256> globalPalette_;
+		std::optional<Image>    canvas_;
+		GifFrameInfo            frame_;
+		Rectanglei              dirtyRect_;
+		Int32                   decodedFrames_;
+		bool                    finished_;
+		std::vector<Color4>     saved_;
+		std::vector<UInt8>      data_;
+		std::vector<UInt8>      indices_;
+
+		void dispose(MutableImageView canvas);
+
+		void decodeFrame(MutableImageView canvas, const Rectanglei& area, const std::array<Color4, 256>& palette, std::optional<UInt8> transparentIndex);
+
+	public:
+		/**
+		 * @brief      Constructor.
+		 *
+		 *             Reads the GIF header up to the first frame.
+		 *
+		 * @param      reader  The GIF data reader, which must outlive the decoder.
+		 */
+		explicit GifAnimationDecoder(IReader& reader);
+
+		/**
+		 * @brief      Destructor.
+		 */
+		~GifAnimationDecoder() =default;
+
+		/**
+		 * @brief      Returns the canvas size.
+		 *
+		 * @return     The logical screen size of the animation.
+		 */
+		[[nodiscard]]
+		const Size2Di& size() const noexcept;
+
+		/**
+		 * @brief      Returns number of the times to play the animation.
+		 *
+		 * @return     The loop count, 0 if the animation loops forever.
+		 */
+		[[nodiscard]]
+		Int32 loopCount() const noexcept;
+
+		/**
+		 * @brief      Composites the next frame into the internal canvas.
+		 *
+		 * @return     `true` if a frame was decoded, `false` at the end of the animation.
+		 */
+		bool next();
+
+		/**
+		 * @brief      Composites the next frame into the caller's canvas.
+		 *
+		 *             The canvas must keep the pixels of the previous frame
+		 *             since only the dirty rectangle is written. The first
+		 *             frame clears the whole canvas.
+		 *
+		 * @param[in]  canvas  The destination whose size is the canvas size.
+		 *
+		 * @return     `true` if a frame was decoded, `false` at the end of the animation.
+		 */
+		bool next(MutableImageView canvas);
+
+		/**
+		 * @brief      Restarts the animation from the first frame.
+		 */
+		void rewind();
+
+		/**
+		 * @brief      Returns the properties of the current frame.
+		 *
+		 * @return     The current frame properties.
+		 */
+		[[nodiscard]]
+		const GifFrameInfo& frame() const noexcept;
+
+		/**
+		 * @brief      Returns the area changed by the current frame.
+		 *
+		 * @return     The area including the disposal of the previous frame.
+		 */
+		[[nodiscard]]
+		const Rectanglei& dirtyRect() const noexcept;
+
+		/**
+		 * @brief      Returns the internal canvas.
+		 *
+		 * @return     The canvas composited by `next()`, empty before the first frame.
+		 */
+		[[nodiscard]]
+		ImageView canvas() const noexcept;
+	};
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGEFORMAT_GIFANIMATIONDECODER_HPP
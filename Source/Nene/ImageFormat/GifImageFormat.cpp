@@ -0,0 +1,109 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+#include <cstring>
+#include "GifAnimationDecoder.hpp"
+#include "GifImageFormat.hpp"
+#include "GifImageFormatException.hpp"
+#include "../Scope.hpp"
+#include "../Reader/IReader.hpp"
+
+namespace Nene
+{
+	GifImageFormat::GifImageFormat(std::string_view name)
+		: name_(name) {}
+
+	const std::string& GifImageFormat::name() const noexcept
+	{
+		return name_;
+	}
+
+	ArrayView<IImageFormat::path_type> GifImageFormat::possibleExtensions() const noexcept
+	{
+		static const path_type extensions[] =
+		{
+			".gif",
+		};
+
+		return extensions;
+	}
+
+	bool GifImageFormat::isImageHeader(const std::array<Byte, 16>& header) const noexcept
+	{
+		return std::memcmp(header.data(), "GIF87a", 6) == 0
+			|| std::memcmp(header.data(), "GIF89a", 6) == 0;
+	}
+
+	ImageInfo GifImageFormat::probe(IReader& reader)
+	{
+		const auto position = reader.position();
+
+		[[maybe_unused]] const auto _ = scopeExit([&]()
+		{
+			reader.position(position);
+		});
+
+		const GifAnimationDecoder decoder { reader };
+
+		// Transparency is only known per frame.
+		return { decoder.size(), 4, 8, true, false };
+	}
+
+	Image GifImageFormat::decode(IReader& reader)
+	{
+		GifAnimationDecoder decoder { reader };
+
+		Image image { decoder.size() };
+
+		if (!decoder.next(image.mutableView()))
+		{
+			throw GifImageFormatException { u8"GIF image has no frames." };
+		}
+
+		return image;
+	}
+
+	void GifImageFormat::decodeInto(IReader& reader, MutableImageView image)
+	{
+		GifAnimationDecoder decoder { reader };
+
+		if (decoder.size() != image.size())
+		{
+			throw GifImageFormatException { u8"Image size mismatch." };
+		}
+
+		if (!decoder.next(image))
+		{
+			throw GifImageFormatException { u8"GIF image has no frames." };
+		}
+	}
+
+	void GifImageFormat::encode([[maybe_unused]] ImageView image, [[maybe_unused]] IWriter& writer)
+	{
+		throw GifImageFormatException { u8"GIF encoding is not supported." };
+	}
+
+	void GifImageFormat::encode(ImageView image, IWriter& writer, [[maybe_unused]] Int32 quality)
+	{
+		encode(image, writer);
+	}
+}
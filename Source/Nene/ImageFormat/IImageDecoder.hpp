@@ -0,0 +1,80 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_IMAGEFORMAT_IIMAGEDECODER_HPP
+#define INCLUDE_NENE_IMAGEFORMAT_IIMAGEDECODER_HPP
+
+#include "../ImageView.hpp"
+#include "ImageInfo.hpp"
+
+namespace Nene
+{
+	/**
+	 * @brief      Image decoder interface pulling the rows from top to bottom.
+	 *
+	 *             The decoder reads from the reader it was created with, which
+	 *             must outlive the decoder.
+	 */
+	class IImageDecoder
+	{
+	public:
+		/**
+		 * @brief      Constructor.
+		 */
+		IImageDecoder() noexcept =default;
+
+		/**
+		 * @brief      Destructor.
+		 */
+		virtual ~IImageDecoder() =default;
+
+		/**
+		 * @brief      Returns the properties of the image.
+		 *
+		 * @return     The image properties.
+		 */
+		[[nodiscard]]
+		virtual const ImageInfo& info() const noexcept =0;
+
+		/**
+		 * @brief      Returns index of the next row to read.
+		 *
+		 * @return     Number of the rows already read.
+		 */
+		[[nodiscard]]
+		virtual Int32 currentRow() const noexcept =0;
+
+		/**
+		 * @brief      Decodes the next rows.
+		 *
+		 * @param[out] rows  The destination whose width is the image width;
+		 *                   one row is decoded per row of the view.
+		 *
+		 * @return     Number of the rows decoded, less than the view height
+		 *             at the end of the image.
+		 */
+		virtual Int32 readRows(MutableImageView rows) =0;
+	};
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGEFORMAT_IIMAGEDECODER_HPP
@@ -24,8 +24,13 @@
 #ifndef INCLUDE_IMAGEFORMAT_IIMAGEFORMAT_HPP
 #define INCLUDE_IMAGEFORMAT_IIMAGEFORMAT_HPP
 
+#include <memory>
 #include <experimental/filesystem>
 #include "../Image.hpp"
+#include "BufferedImageDecoder.hpp"
+#include "IImageDecoder.hpp"
+#include "ImageFormatException.hpp"
+#include "ImageInfo.hpp"
 
 namespace Nene
 {
@@ -78,6 +83,33 @@ namespace Nene
 		[[nodiscard]]
 		virtual bool isImageHeader(const std::array<Byte, 16>& header) const noexcept =0;
 
+		/**
+		 * @brief      Determines if the format is identified by a signature.
+		 *
+		 *             The formats without a signature are only guessed from
+		 *             the header, so they are tried after the other formats.
+		 *
+		 * @return     `true` if `isImageHeader()` checks a signature, `false`
+		 *             if it relies on heuristics.
+		 */
+		[[nodiscard]]
+		virtual bool hasSignature() const noexcept
+		{
+			return true;
+		}
+
+		/**
+		 * @brief      Reads the image properties from the header without decoding the pixels.
+		 *
+		 *             The reader position is restored afterwards.
+		 *
+		 * @param      reader  The image data reader.
+		 *
+		 * @return     The image properties.
+		 */
+		[[nodiscard]]
+		virtual ImageInfo probe(IReader& reader) =0;
+
 		/**
 		 * @brief      Constructs a image from a reader.
 		 *
@@ -88,13 +120,68 @@ namespace Nene
 		[[nodiscard]]
 		virtual Image decode(IReader& reader) =0;
 
+		/**
+		 * @brief      Constructs a image in its narrowest pixel format from a reader.
+		 *
+		 *             Formats which cannot decode gray scale or high bit depth
+		 *             images natively return the RGBA image of `decode()`.
+		 *
+		 * @param      reader  The image data reader.
+		 *
+		 * @return     The image from `reader`.
+		 */
+		[[nodiscard]]
+		virtual AnyImage decodeNative(IReader& reader)
+		{
+			return decode(reader);
+		}
+
+		/**
+		 * @brief      Decodes a image into the caller's pixel buffer.
+		 *
+		 *             The size of `image` must match the size of the image.
+		 *
+		 * @param      reader  The image data reader.
+		 * @param[in]  image   The destination image view.
+		 */
+		virtual void decodeInto(IReader& reader, MutableImageView image)
+		{
+			const auto decoder = createDecoder(reader);
+
+			if (decoder->info().size != image.size())
+			{
+				throw ImageFormatException { u8"Image size mismatch." };
+			}
+
+			decoder->readRows(image);
+		}
+
+		/**
+		 * @brief      Creates a decoder reading the image row by row.
+		 *
+		 *             Formats which cannot stream decode the whole image up
+		 *             front.
+		 *
+		 * @param      reader  The image data reader, which must outlive the decoder.
+		 *
+		 * @return     The image decoder.
+		 */
+		[[nodiscard]]
+		virtual std::unique_ptr<IImageDecoder> createDecoder(IReader& reader)
+		{
+			auto image = decode(reader);
+			const ImageInfo info { image.size(), 4, 8, true, false };
+
+			return std::make_unique<BufferedImageDecoder>(std::move(image), info);
+		}
+
 		/**
 		 * @brief      Writes a image to a writer.
 		 *
 		 * @param[in]  image   The image data to write.
 		 * @param      writer  The image data writer.
 		 */
-		virtual void encode(const Image& image, IWriter& writer) =0;
+		virtual void encode(ImageView image, IWriter& writer) =0;
 
 		/**
 		 * @brief      Writes a image to a writer.
@@ -103,7 +190,7 @@ namespace Nene
 		 * @param      writer   The image data writer.
 		 * @param[in]  quality  The image quality.
 		 */
-		virtual void encode(const Image& image, IWriter& writer, Int32 quality) =0;
+		virtual void encode(ImageView image, IWriter& writer, Int32 quality) =0;
 	};
 }
 
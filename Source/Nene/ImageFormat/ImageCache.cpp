@@ -0,0 +1,226 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#include <system_error>
+#include "../Hash/Crc64.hpp"
+#include "../Reader/FileReader.hpp"
+#include "../Reader/MemoryReader.hpp"
+#include "ImageCache.hpp"
+#include "ImageFormatException.hpp"
+#include "ImageFormatManager.hpp"
+
+namespace Nene
+{
+	namespace
+	{
+		[[nodiscard]]
+		std::vector<Byte> readAll(const ImageCache::path_type& path)
+		{
+			FileReader reader { path };
+
+			std::vector<Byte> data(reader.size());
+
+			if (reader.read(data.data(), data.size()) != data.size())
+			{
+				throw ImageFormatException { u8"Failed to read image file." };
+			}
+
+			return data;
+		}
+
+		[[nodiscard]]
+		UInt64 modifiedTime(const ImageCache::path_type& path)
+		{
+			return static_cast<UInt64>(std::experimental::filesystem::last_write_time(path).time_since_epoch().count());
+		}
+	}
+
+	ImageCache::ImageCache(ImageFormatManager& manager, std::size_t maxBytes, ImageCacheValidation validation)
+		: manager_(manager)
+		, validation_(validation)
+		, maxBytes_(maxBytes)
+		, entries_()
+		, index_()
+		, statistics_()
+		, mutex_() {}
+
+	void ImageCache::insert(std::string&& key, UInt64 version, const std::shared_ptr<const Image>& image)
+	{
+		const auto bytes = image->sizeBytes();
+
+		if (bytes > maxBytes_)
+		{
+			return;
+		}
+
+		// Another thread may have loaded the same file meanwhile.
+		if (const auto it = index_.find(key); it != index_.end())
+		{
+			statistics_.bytes -= it->second->bytes;
+			statistics_.entries--;
+
+			entries_.erase(it->second);
+			index_.erase(it);
+		}
+
+		evict(maxBytes_ - bytes);
+
+		entries_.push_front(Entry { key, version, image, bytes });
+		index_.emplace(std::move(key), entries_.begin());
+
+		statistics_.bytes += bytes;
+		statistics_.entries++;
+	}
+
+	void ImageCache::evict(std::size_t maxBytes)
+	{
+		while (statistics_.bytes > maxBytes && !entries_.empty())
+		{
+			const auto& entry = entries_.back();
+
+			statistics_.bytes -= entry.bytes;
+			statistics_.entries--;
+			statistics_.evictions++;
+
+			index_.erase(entry.key);
+			entries_.pop_back();
+		}
+	}
+
+	std::shared_ptr<const Image> ImageCache::load(const path_type& path)
+	{
+		auto key = std::experimental::filesystem::canonical(path).u8string();
+
+		// Read the version; the content is kept to decode on a miss.
+		std::vector<Byte> data;
+		UInt64            version;
+
+		if (validation_ == ImageCacheValidation::contentHash)
+		{
+			data    = readAll(path);
+			version = Hash::crc64(data);
+		}
+		else
+		{
+			version = modifiedTime(path);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock { mutex_ };
+
+			if (const auto it = index_.find(key); it != index_.end() && it->second->version == version)
+			{
+				// Move to the most recently used position.
+				entries_.splice(entries_.begin(), entries_, it->second);
+
+				statistics_.hits++;
+
+				return it->second->image;
+			}
+
+			statistics_.misses++;
+		}
+
+		// Decode without the lock.
+		if (data.empty())
+		{
+			data = readAll(path);
+		}
+
+		MemoryReader reader { std::move(data) };
+
+		const auto image = std::make_shared<const Image>(manager_.decode(reader));
+
+		std::lock_guard<std::mutex> lock { mutex_ };
+
+		insert(std::move(key), version, image);
+
+		return image;
+	}
+
+	void ImageCache::remove(const path_type& path)
+	{
+		std::error_code error;
+
+		const auto key = std::experimental::filesystem::canonical(path, error).u8string();
+
+		if (error)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock { mutex_ };
+
+		if (const auto it = index_.find(key); it != index_.end())
+		{
+			statistics_.bytes -= it->second->bytes;
+			statistics_.entries--;
+
+			entries_.erase(it->second);
+			index_.erase(it);
+		}
+	}
+
+	void ImageCache::clear() noexcept
+	{
+		std::lock_guard<std::mutex> lock { mutex_ };
+
+		index_.clear();
+		entries_.clear();
+
+		statistics_.bytes   = 0;
+		statistics_.entries = 0;
+	}
+
+	std::size_t ImageCache::maxBytes() const noexcept
+	{
+		std::lock_guard<std::mutex> lock { mutex_ };
+
+		return maxBytes_;
+	}
+
+	void ImageCache::maxBytes(std::size_t maxBytes)
+	{
+		std::lock_guard<std::mutex> lock { mutex_ };
+
+		maxBytes_ = maxBytes;
+
+		evict(maxBytes_);
+	}
+
+	ImageCacheStatistics ImageCache::statistics() const noexcept
+	{
+		std::lock_guard<std::mutex> lock { mutex_ };
+
+		return statistics_;
+	}
+
+	void ImageCache::resetStatistics() noexcept
+	{
+		std::lock_guard<std::mutex> lock { mutex_ };
+
+		statistics_.hits      = 0;
+		statistics_.misses    = 0;
+		statistics_.evictions = 0;
+	}
+}
@@ -0,0 +1,195 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_IMAGEFORMAT_IMAGECACHE_HPP
+#define INCLUDE_NENE_IMAGEFORMAT_IMAGECACHE_HPP
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <experimental/filesystem>
+#include "../Image.hpp"
+#include "../Uncopyable.hpp"
+
+namespace Nene
+{
+	// Forward declarations.
+	class ImageFormatManager;
+
+	/**
+	 * @brief      How the image cache detects the modified files.
+	 */
+	enum class ImageCacheValidation: Int32
+	{
+		/**
+		 * @brief      Compares the last modified time; the file is read only on misses.
+		 */
+		modifiedTime,
+
+		/**
+		 * @brief      Compares CRC-64 of the file; the file is read every time but decoded only on misses.
+		 */
+		contentHash,
+	};
+
+	/**
+	 * @brief      Image cache counters.
+	 */
+	class ImageCacheStatistics
+	{
+	public:
+		/**
+		 * @brief      Number of the loads served from the cache.
+		 */
+		UInt64 hits = 0;
+
+		/**
+		 * @brief      Number of the loads which decoded the file.
+		 */
+		UInt64 misses = 0;
+
+		/**
+		 * @brief      Number of the entries evicted to keep the budget.
+		 */
+		UInt64 evictions = 0;
+
+		/**
+		 * @brief      Number of the cached images.
+		 */
+		std::size_t entries = 0;
+
+		/**
+		 * @brief      Bytes of the cached images.
+		 */
+		std::size_t bytes = 0;
+	};
+
+	/**
+	 * @brief      Thread safe LRU cache of the decoded image files.
+	 *
+	 *             Entries are keyed by the canonical path and validated by the
+	 *             modified time or the content hash. The least recently used
+	 *             entries are evicted once the cached images exceed the byte
+	 *             budget. Evicted images stay alive while they are shared.
+	 */
+	class ImageCache final
+		: private Uncopyable
+	{
+	public:
+		using path_type = std::experimental::filesystem::path;
+
+	private:
+		struct Entry
+		{
+			std::string                  key;
+			UInt64                       version;
+			std::shared_ptr<const Image> image;
+			std::size_t                  bytes;
+		};
+
+		using list_type = std::list<Entry>;
+
+		ImageFormatManager&                                   manager_;
+		ImageCacheValidation                                  validation_;
+		std::size_t                                           maxBytes_;
+		list_type                                             entries_;
+		std::unordered_map<std::string, list_type::iterator>  index_;
+		ImageCacheStatistics                                  statistics_;
+		mutable std::mutex                                    mutex_;
+
+		void insert(std::string&& key, UInt64 version, const std::shared_ptr<const Image>& image);
+
+		void evict(std::size_t maxBytes);
+
+	public:
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param      manager     The image format manager to decode the files.
+		 * @param[in]  maxBytes    The budget of the cached images in bytes.
+		 * @param[in]  validation  How to detect the modified files.
+		 */
+		explicit ImageCache(ImageFormatManager& manager, std::size_t maxBytes = 256 * 1024 * 1024, ImageCacheValidation validation = ImageCacheValidation::modifiedTime);
+
+		/**
+		 * @brief      Destructor.
+		 */
+		~ImageCache() =default;
+
+		/**
+		 * @brief      Loads the image file through the cache.
+		 *
+		 *             Images larger than the budget are decoded but not cached.
+		 *
+		 * @param[in]  path  The image file path.
+		 *
+		 * @return     The shared image.
+		 */
+		[[nodiscard]]
+		std::shared_ptr<const Image> load(const path_type& path);
+
+		/**
+		 * @brief      Removes the entry of the file if cached.
+		 *
+		 * @param[in]  path  The image file path.
+		 */
+		void remove(const path_type& path);
+
+		/**
+		 * @brief      Removes all the entries.
+		 */
+		void clear() noexcept;
+
+		/**
+		 * @brief      Returns the budget of the cached images.
+		 *
+		 * @return     The budget in bytes.
+		 */
+		[[nodiscard]]
+		std::size_t maxBytes() const noexcept;
+
+		/**
+		 * @brief      Sets the budget of the cached images and evicts the entries over it.
+		 *
+		 * @param[in]  maxBytes  The budget in bytes.
+		 */
+		void maxBytes(std::size_t maxBytes);
+
+		/**
+		 * @brief      Returns the cache counters.
+		 *
+		 * @return     The snapshot of the counters.
+		 */
+		[[nodiscard]]
+		ImageCacheStatistics statistics() const noexcept;
+
+		/**
+		 * @brief      Resets the hit, miss and eviction counters.
+		 */
+		void resetStatistics() noexcept;
+	};
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGEFORMAT_IMAGECACHE_HPP
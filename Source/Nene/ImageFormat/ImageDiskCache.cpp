@@ -0,0 +1,466 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+#include <algorithm>
+#include <functional>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+#include "../Compression/Zlib/Compress.hpp"
+#include "../Compression/Zlib/Uncompress.hpp"
+#include "../Exceptions/FileException.hpp"
+#include "../Hash/Crc32.hpp"
+#include "../Hash/Crc64.hpp"
+#include "../Platform.hpp"
+#include "../Reader/FileReader.hpp"
+#include "../Reader/MappedFileReader.hpp"
+#include "../Reader/MemoryReader.hpp"
+#include "../Serialization/BinaryDeserializer.hpp"
+#include "../Serialization/BinarySerializer.hpp"
+#include "../Writer/FileWriter.hpp"
+#include "ImageDiskCache.hpp"
+#include "ImageFormatException.hpp"
+#include "ImageFormatManager.hpp"
+
+namespace Nene
+{
+	namespace
+	{
+		namespace fs = std::experimental::filesystem;
+
+		constexpr UInt32 entryMagic   = 0x4344494E; // "NIDC"
+		constexpr UInt32 entryVersion = 1;
+
+		constexpr std::size_t entryHeaderSize = 56;
+
+		constexpr char entryExtension[] = u8".nidc";
+		constexpr char tempExtension[]  = u8".tmp";
+
+		enum class EntryCompression: UInt32
+		{
+			none,
+			zlib,
+		};
+
+		struct EntryHeader
+		{
+			UInt32 magic;
+			UInt32 version;
+			UInt64 sourceHash;
+			UInt64 optionsHash;
+			Int32  width;
+			Int32  height;
+			UInt32 compression;
+			UInt32 checksum;
+			UInt64 rawSize;
+			UInt64 storedSize;
+		};
+
+		void load(Serialization::BinaryDeserializer& archive, EntryHeader& header)
+		{
+			archive
+				.serialize(header.magic)
+				.serialize(header.version)
+				.serialize(header.sourceHash)
+				.serialize(header.optionsHash)
+				.serialize(header.width)
+				.serialize(header.height)
+				.serialize(header.compression)
+				.serialize(header.checksum)
+				.serialize(header.rawSize)
+				.serialize(header.storedSize)
+			;
+		}
+
+		void save(Serialization::BinarySerializer& archive, const EntryHeader& header)
+		{
+			archive
+				.serialize(header.magic)
+				.serialize(header.version)
+				.serialize(header.sourceHash)
+				.serialize(header.optionsHash)
+				.serialize(header.width)
+				.serialize(header.height)
+				.serialize(header.compression)
+				.serialize(header.checksum)
+				.serialize(header.rawSize)
+				.serialize(header.storedSize)
+			;
+		}
+
+		[[nodiscard]]
+		std::vector<Byte> readAll(const ImageDiskCache::path_type& path)
+		{
+			FileReader reader { path };
+
+			std::vector<Byte> data(reader.size());
+
+			if (reader.read(data.data(), data.size()) != data.size())
+			{
+				throw ImageFormatException { u8"Failed to read image file." };
+			}
+
+			return data;
+		}
+
+		[[nodiscard]]
+		bool hasExtension(const fs::directory_entry& entry, const char* extension)
+		{
+			std::error_code error;
+
+			return fs::is_regular_file(entry.status(error)) && entry.path().extension() == extension;
+		}
+	}
+
+	ImageDiskCache::ImageDiskCache(ImageFormatManager& manager, const path_type& directory, const ImageDiskCacheOptions& options)
+		: manager_(manager)
+		, directory_(fs::absolute(directory))
+		, options_(options)
+		, sizeBytes_(0)
+		, mutex_()
+	{
+		std::error_code error;
+
+		fs::create_directories(directory_, error);
+
+		if (error)
+		{
+			throw FileException { fmt::format(u8"Could not create cache directory '{}'.", directory_.u8string()) };
+		}
+
+		// Remove the files left by interrupted writes.
+		for (const auto& entry : fs::directory_iterator { directory_, error })
+		{
+			if (hasExtension(entry, tempExtension))
+			{
+				fs::remove(entry.path(), error);
+			}
+		}
+
+		collectGarbage(options_.maxBytes);
+	}
+
+	std::optional<Image> ImageDiskCache::read(const path_type& entryPath, UInt64 sourceHash, UInt64 optionsHash) const
+	{
+		std::error_code error;
+
+		if (!fs::is_regular_file(entryPath, error))
+		{
+			return std::nullopt;
+		}
+
+		try
+		{
+#if defined(NENE_OS_WINDOWS)
+			MappedFileReader reader { entryPath };
+#else
+			MemoryReader reader { readAll(entryPath) };
+#endif
+
+			if (reader.size() < entryHeaderSize)
+			{
+				return std::nullopt;
+			}
+
+			EntryHeader header;
+
+			Serialization::BinaryDeserializer archive { reader, Endian::Order::little };
+			archive.serialize(header);
+
+			if (header.magic       != entryMagic  ||
+				header.version     != entryVersion ||
+				header.sourceHash  != sourceHash  ||
+				header.optionsHash != optionsHash ||
+				header.width  <= 0 ||
+				header.height <= 0 ||
+				header.rawSize    != static_cast<UInt64>(header.width) * header.height * sizeof(PixelRGBA8) ||
+				header.storedSize != reader.size() - entryHeaderSize)
+			{
+				return std::nullopt;
+			}
+
+			const auto payload = reader.data().substr(entryHeaderSize);
+
+			if (Hash::crc32(payload) != header.checksum)
+			{
+				return std::nullopt;
+			}
+
+			const Size2Di size { header.width, header.height };
+
+			switch (static_cast<EntryCompression>(header.compression))
+			{
+			case EntryCompression::none:
+				// Copy straight from the mapped pages.
+				return Image { BasicImageView<PixelRGBA8> { reinterpret_cast<const PixelRGBA8*>(payload.data()), size } };
+
+			case EntryCompression::zlib:
+				{
+					const auto pixels = Compression::Zlib::uncompress(payload, static_cast<std::size_t>(header.rawSize));
+
+					return Image { BasicImageView<PixelRGBA8> { reinterpret_cast<const PixelRGBA8*>(pixels.data()), size } };
+				}
+
+			default:
+				return std::nullopt;
+			}
+		}
+		catch (const EngineException&)
+		{
+			// Treat the unreadable entries as misses.
+			return std::nullopt;
+		}
+	}
+
+	void ImageDiskCache::write(const path_type& entryPath, UInt64 sourceHash, UInt64 optionsHash, const Image& image)
+	{
+		// Entries store the packed rows.
+		std::optional<Image> packed;
+
+		if (!image.isContiguous())
+		{
+			packed.emplace(image.view());
+		}
+
+		const auto& source = packed ? *packed : image;
+
+		const ByteArrayView raw { source.dataBytes(), source.sizeBytes() };
+
+		std::vector<Byte> compressed;
+		ByteArrayView     payload     = raw;
+		auto              compression = EntryCompression::none;
+
+		if (options_.compress)
+		{
+			compressed = Compression::Zlib::compress(raw, options_.compressionLevel);
+
+			// Keep the raw pixels when they do not shrink.
+			if (compressed.size() < raw.size())
+			{
+				payload     = compressed;
+				compression = EntryCompression::zlib;
+			}
+		}
+
+		EntryHeader header;
+		header.magic       = entryMagic;
+		header.version     = entryVersion;
+		header.sourceHash  = sourceHash;
+		header.optionsHash = optionsHash;
+		header.width       = source.width();
+		header.height      = source.height();
+		header.compression = static_cast<UInt32>(compression);
+		header.checksum    = Hash::crc32(payload);
+		header.rawSize     = raw.size();
+		header.storedSize  = payload.size();
+
+		// Write to the temporary file and rename it so that readers never see partial entries.
+		auto tempPath = entryPath;
+		tempPath += fmt::format(u8".{:x}{}", std::hash<std::thread::id> {}(std::this_thread::get_id()), tempExtension);
+
+		std::error_code error;
+
+		try
+		{
+			FileWriter writer { tempPath };
+
+			Serialization::BinarySerializer archive { writer, Endian::Order::little };
+			archive.serialize(header);
+
+			if (writer.write(payload.data(), payload.size()) != payload.size())
+			{
+				throw FileException { u8"Failed to write cache entry." };
+			}
+		}
+		catch (const EngineException&)
+		{
+			// The cache is best effort; a failed write only costs the next decode.
+			fs::remove(tempPath, error);
+
+			return;
+		}
+
+		// Replaced entries are no longer counted.
+		const auto replacedBytes = static_cast<std::size_t>(fs::exists(entryPath, error) ? fs::file_size(entryPath, error) : 0);
+
+		fs::rename(tempPath, entryPath, error);
+
+		if (error)
+		{
+			fs::remove(tempPath, error);
+
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock { mutex_ };
+
+		sizeBytes_ += entryHeaderSize + payload.size() - (std::min)(replacedBytes, sizeBytes_);
+
+		// Trim below the limit so that the following writes do not rescan the directory.
+		if (sizeBytes_ > options_.maxBytes)
+		{
+			collectGarbage(options_.maxBytes - options_.maxBytes / 8);
+		}
+	}
+
+	void ImageDiskCache::collectGarbage(std::size_t maxBytes)
+	{
+		struct Entry
+		{
+			path_type          path;
+			fs::file_time_type time;
+			std::size_t        bytes;
+		};
+
+		std::vector<Entry> entries;
+		std::size_t        totalBytes = 0;
+		std::error_code    error;
+
+		for (const auto& entry : fs::directory_iterator { directory_, error })
+		{
+			if (!hasExtension(entry, entryExtension))
+			{
+				continue;
+			}
+
+			const auto time = fs::last_write_time(entry.path(), error);
+
+			if (error)
+			{
+				continue;
+			}
+
+			const auto bytes = fs::file_size(entry.path(), error);
+
+			if (error)
+			{
+				continue;
+			}
+
+			entries.push_back(Entry { entry.path(), time, static_cast<std::size_t>(bytes) });
+			totalBytes += static_cast<std::size_t>(bytes);
+		}
+
+		if (totalBytes > maxBytes)
+		{
+			// Hits touch the entries, so the oldest are the least recently used.
+			std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b)
+			{
+				return a.time < b.time;
+			});
+
+			for (const auto& entry : entries)
+			{
+				if (totalBytes <= maxBytes)
+				{
+					break;
+				}
+
+				// Entries mapped by other loads may fail to be removed.
+				if (fs::remove(entry.path, error))
+				{
+					totalBytes -= entry.bytes;
+				}
+			}
+		}
+
+		sizeBytes_ = totalBytes;
+	}
+
+	Image ImageDiskCache::load(const path_type& path)
+	{
+		return load(path, {}, [this](IReader& reader)
+		{
+			return manager_.decode(reader);
+		});
+	}
+
+	Image ImageDiskCache::load(const path_type& path, std::string_view optionsKey, const decoder_type& decoder)
+	{
+		auto data = readAll(path);
+
+		const auto sourceHash  = Hash::crc64(data);
+		const auto optionsHash = Hash::crc64(ByteArrayView { reinterpret_cast<const Byte*>(optionsKey.data()), optionsKey.size() });
+
+		const auto entryPath = directory_ / fmt::format(u8"{:016x}{:016x}{}", sourceHash, optionsHash, entryExtension);
+
+		if (auto image = read(entryPath, sourceHash, optionsHash))
+		{
+			// Touch the entry for the garbage collection.
+			std::error_code error;
+			fs::last_write_time(entryPath, fs::file_time_type::clock::now(), error);
+
+			return std::move(*image);
+		}
+
+		MemoryReader reader { std::move(data) };
+
+		auto image = decoder(reader);
+
+		write(entryPath, sourceHash, optionsHash, image);
+
+		return image;
+	}
+
+	void ImageDiskCache::collectGarbage()
+	{
+		std::lock_guard<std::mutex> lock { mutex_ };
+
+		collectGarbage(options_.maxBytes);
+	}
+
+	void ImageDiskCache::clear()
+	{
+		std::lock_guard<std::mutex> lock { mutex_ };
+
+		collectGarbage(0);
+	}
+
+	ImageDiskCache::path_type ImageDiskCache::directory() const
+	{
+		return directory_;
+	}
+
+	std::size_t ImageDiskCache::sizeBytes() const noexcept
+	{
+		std::lock_guard<std::mutex> lock { mutex_ };
+
+		return sizeBytes_;
+	}
+
+	std::size_t ImageDiskCache::maxBytes() const noexcept
+	{
+		std::lock_guard<std::mutex> lock { mutex_ };
+
+		return options_.maxBytes;
+	}
+
+	void ImageDiskCache::maxBytes(std::size_t maxBytes)
+	{
+		std::lock_guard<std::mutex> lock { mutex_ };
+
+		options_.maxBytes = maxBytes;
+
+		collectGarbage(maxBytes);
+	}
+}
@@ -0,0 +1,173 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+#ifndef INCLUDE_NENE_IMAGEFORMAT_IMAGEDISKCACHE_HPP
+#define INCLUDE_NENE_IMAGEFORMAT_IMAGEDISKCACHE_HPP
+
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <experimental/filesystem>
+#include "../Image.hpp"
+#include "../Uncopyable.hpp"
+
+namespace Nene
+{
+	// Forward declarations.
+	class IReader;
+	class ImageFormatManager;
+
+	/**
+	 * @brief      Image disk cache options.
+	 */
+	class ImageDiskCacheOptions
+	{
+	public:
+		/**
+		 * @brief      Size limit of the cache directory in bytes.
+		 */
+		std::size_t maxBytes = 1024 * 1024 * 1024;
+
+		/**
+		 * @brief      Whether to compress the entries with zlib.
+		 */
+		bool compress = false;
+
+		/**
+		 * @brief      zlib compression level of the entries.
+		 */
+		int compressionLevel = 1;
+	};
+
+	/**
+	 * @brief      Content addressed disk cache of the decoded images.
+	 *
+	 *             Entries hold the raw RGBA pixels keyed by CRC-64 of the
+	 *             source file and the decoder options, so renamed or copied
+	 *             files share an entry. Entries are memory mapped and validated
+	 *             with CRC-32 on loading; the least recently used entries are
+	 *             removed once the directory exceeds the size limit.
+	 */
+	class ImageDiskCache final
+		: private Uncopyable
+	{
+	public:
+		using path_type = std::experimental::filesystem::path;
+
+		using decoder_type = std::function<Image(IReader&)>;
+
+	private:
+		ImageFormatManager&   manager_;
+		path_type             directory_;
+		ImageDiskCacheOptions options_;
+		std::size_t           sizeBytes_;
+		mutable std::mutex    mutex_;
+
+		[[nodiscard]]
+		std::optional<Image> read(const path_type& entryPath, UInt64 sourceHash, UInt64 optionsHash) const;
+
+		void write(const path_type& entryPath, UInt64 sourceHash, UInt64 optionsHash, const Image& image);
+
+		void collectGarbage(std::size_t maxBytes);
+
+	public:
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param      manager    The image format manager to decode the files.
+		 * @param[in]  directory  The cache directory, created if missing.
+		 * @param[in]  options    The cache options.
+		 */
+		explicit ImageDiskCache(ImageFormatManager& manager, const path_type& directory, const ImageDiskCacheOptions& options = {});
+
+		/**
+		 * @brief      Destructor.
+		 */
+		~ImageDiskCache() =default;
+
+		/**
+		 * @brief      Loads the image file through the cache.
+		 *
+		 * @param[in]  path  The image file path.
+		 *
+		 * @return     The image.
+		 */
+		[[nodiscard]]
+		Image load(const path_type& path);
+
+		/**
+		 * @brief      Loads the image file through the cache with the custom decoder.
+		 *
+		 * @param[in]  path        The image file path.
+		 * @param[in]  optionsKey  The decoder options; different options are cached separately.
+		 * @param[in]  decoder     The decoder called on misses.
+		 *
+		 * @return     The image.
+		 */
+		[[nodiscard]]
+		Image load(const path_type& path, std::string_view optionsKey, const decoder_type& decoder);
+
+		/**
+		 * @brief      Removes the least recently used entries over the size limit.
+		 */
+		void collectGarbage();
+
+		/**
+		 * @brief      Removes all the entries.
+		 */
+		void clear();
+
+		/**
+		 * @brief      Returns the cache directory.
+		 *
+		 * @return     The cache directory.
+		 */
+		[[nodiscard]]
+		path_type directory() const;
+
+		/**
+		 * @brief      Returns the size of the entries.
+		 *
+		 * @return     The size in bytes.
+		 */
+		[[nodiscard]]
+		std::size_t sizeBytes() const noexcept;
+
+		/**
+		 * @brief      Returns the size limit of the cache directory.
+		 *
+		 * @return     The size limit in bytes.
+		 */
+		[[nodiscard]]
+		std::size_t maxBytes() const noexcept;
+
+		/**
+		 * @brief      Sets the size limit of the cache directory and removes the entries over it.
+		 *
+		 * @param[in]  maxBytes  The size limit in bytes.
+		 */
+		void maxBytes(std::size_t maxBytes);
+	};
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGEFORMAT_IMAGEDISKCACHE_HPP
@@ -21,18 +21,53 @@
 // OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //=============================================================================
 
-#include "../Reader/IReader.hpp"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include "../Reader/FileReader.hpp"
+#include "../Reader/MemoryReader.hpp"
+#include "../Thread/ThreadPool.hpp"
 #include "ImageFormatManager.hpp"
 #include "ImageFormatException.hpp"
 #include "IImageFormat.hpp"
 
 namespace Nene
 {
+	namespace
+	{
+		[[nodiscard]]
+		std::vector<Byte> readAll(FileReader& reader)
+		{
+			std::vector<Byte> data(reader.size());
+
+			if (reader.read(data.data(), data.size()) != data.size())
+			{
+				throw ImageFormatException { u8"Failed to read image file." };
+			}
+
+			return data;
+		}
+	}
+
 	ImageFormatManager& ImageFormatManager::add(std::unique_ptr<IImageFormat>&& imageFormat)
 	{
 		assert(imageFormat);
 
-		formats_.emplace_back(std::move(imageFormat));
+		if (imageFormat->hasSignature())
+		{
+			// Insert before the formats without a signature.
+			const auto it = std::find_if(std::begin(formats_), std::end(formats_), [](const auto& format)
+			{
+				return !format->hasSignature();
+			});
+
+			formats_.emplace(it, std::move(imageFormat));
+		}
+		else
+		{
+			formats_.emplace_back(std::move(imageFormat));
+		}
 
 		return *this;
 	}
@@ -87,6 +122,20 @@ namespace Nene
 		return **it;
 	}
 
+	ImageInfo ImageFormatManager::probe(IReader& reader)
+	{
+		// Peek header.
+		std::array<Byte, 16> header;
+		reader.peek(header.data(), header.size());
+
+		if (const auto format = findFormatFromHeader(header))
+		{
+			return format->get().probe(reader);
+		}
+
+		throw ImageFormatException { u8"Unknown image format." };
+	}
+
 	Image ImageFormatManager::decode(IReader& reader)
 	{
 		// Peek header.
@@ -101,6 +150,198 @@ namespace Nene
 		throw ImageFormatException { u8"Unknown image format." };
 	}
 
+	AnyImage ImageFormatManager::decodeNative(IReader& reader)
+	{
+		// Peek header.
+		std::array<Byte, 16> header;
+		reader.peek(header.data(), header.size());
+
+		if (const auto format = findFormatFromHeader(header))
+		{
+			return format->get().decodeNative(reader);
+		}
+
+		throw ImageFormatException { u8"Unknown image format." };
+	}
+
+	void ImageFormatManager::decodeInto(IReader& reader, MutableImageView image)
+	{
+		// Peek header.
+		std::array<Byte, 16> header;
+		reader.peek(header.data(), header.size());
+
+		if (const auto format = findFormatFromHeader(header))
+		{
+			return format->get().decodeInto(reader, image);
+		}
+
+		throw ImageFormatException { u8"Unknown image format." };
+	}
+
+	std::unique_ptr<IImageDecoder> ImageFormatManager::createDecoder(IReader& reader)
+	{
+		// Peek header.
+		std::array<Byte, 16> header;
+		reader.peek(header.data(), header.size());
+
+		if (const auto format = findFormatFromHeader(header))
+		{
+			return format->get().createDecoder(reader);
+		}
+
+		throw ImageFormatException { u8"Unknown image format." };
+	}
+
+	std::vector<BatchDecodeResult> ImageFormatManager::decodeAll(ArrayView<path_type> paths, const BatchDecodeOptions& options)
+	{
+		return decodeAll(paths, options, ThreadPool::shared());
+	}
+
+	std::vector<BatchDecodeResult> ImageFormatManager::decodeAll(ArrayView<path_type> paths, const BatchDecodeOptions& options, ThreadPool& pool)
+	{
+		std::vector<BatchDecodeResult> results(paths.size());
+
+		const auto maxInFlight = options.maxInFlight > 0
+			? options.maxInFlight
+			: (std::max)(static_cast<Int32>(pool.numThreads()) * 2, 1);
+
+		struct Pending
+		{
+			std::vector<Byte>  data;
+			BatchDecodeResult* result;
+		};
+
+		// Files read but not decoded yet are queued here rather than in the
+		// pool, so that the calling thread can decode them while waiting.
+		struct State
+		{
+			std::deque<Pending>     pending;
+			Int32                   inFlight = 0;
+			std::size_t             inFlightBytes = 0;
+			std::mutex              mutex;
+			std::condition_variable condition;
+		};
+
+		const auto state = std::make_shared<State>();
+
+		// Decodes a queued file if any. Helper tasks running after the
+		// return find the queue empty and touch only the shared state.
+		const auto decodePending = [this, state](std::unique_lock<std::mutex>& lock) noexcept
+		{
+			if (state->pending.empty())
+			{
+				return false;
+			}
+
+			auto pending = std::move(state->pending.front());
+			state->pending.pop_front();
+
+			const auto size = pending.data.size();
+
+			lock.unlock();
+
+			try
+			{
+				MemoryReader reader { std::move(pending.data) };
+
+				pending.result->image = decode(reader);
+			}
+			catch (...)
+			{
+				pending.result->error = std::current_exception();
+			}
+
+			lock.lock();
+
+			state->inFlight      -= 1;
+			state->inFlightBytes -= size;
+
+			state->condition.notify_all();
+
+			return true;
+		};
+
+		std::unique_lock<std::mutex> lock { state->mutex, std::defer_lock };
+
+		// Decodes the queued files instead of blocking while the workers are busy.
+		const auto waitUntil = [&](auto&& predicate)
+		{
+			while (!predicate())
+			{
+				if (!decodePending(lock))
+				{
+					state->condition.wait(lock);
+				}
+			}
+		};
+
+		for (std::size_t i = 0; i < paths.size(); i++)
+		{
+			std::vector<Byte> data;
+
+			try
+			{
+				FileReader reader { paths[i] };
+
+				const auto size = reader.size();
+
+				// Wait for a slot before reading to bound the memory.
+				lock.lock();
+
+				waitUntil([&]()
+				{
+					const bool fits = options.maxInFlightBytes == 0 || state->inFlightBytes + size <= options.maxInFlightBytes;
+
+					return state->inFlight == 0 || (state->inFlight < maxInFlight && fits);
+				});
+
+				lock.unlock();
+
+				data = readAll(reader);
+			}
+			catch (...)
+			{
+				if (lock.owns_lock())
+				{
+					lock.unlock();
+				}
+
+				results[i].error = std::current_exception();
+				continue;
+			}
+
+			const auto size = data.size();
+
+			lock.lock();
+
+			state->pending.push_back(Pending { std::move(data), &results[i] });
+			state->inFlight      += 1;
+			state->inFlightBytes += size;
+
+			lock.unlock();
+
+			if (pool.numThreads() > 0)
+			{
+				// The helper decodes whichever file is queued first, if any is left.
+				static_cast<void>(pool.submit([decodePending, state]()
+				{
+					std::unique_lock<std::mutex> lock { state->mutex };
+
+					decodePending(lock);
+				}));
+			}
+		}
+
+		lock.lock();
+
+		waitUntil([&]()
+		{
+			return state->inFlight == 0;
+		});
+
+		return results;
+	}
+
 	ArrayView<std::unique_ptr<IImageFormat>> ImageFormatManager::imageFormats() const noexcept
 	{
 		return formats_;
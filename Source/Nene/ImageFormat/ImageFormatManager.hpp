@@ -24,18 +24,70 @@
 #ifndef INCLUDE_NENE_IMAGEFORMAT_IMAGEFORMATMANAGER_HPP
 #define INCLUDE_NENE_IMAGEFORMAT_IMAGEFORMATMANAGER_HPP
 
+#include <exception>
 #include <memory>
 #include <optional>
+#include <vector>
 #include <experimental/filesystem>
 #include "../ArrayView.hpp"
 #include "../Image.hpp"
 #include "../Uncopyable.hpp"
+#include "ImageInfo.hpp"
 
 namespace Nene
 {
 	// Forward declarations.
+	class IImageDecoder;
 	class IImageFormat;
 	class IReader;
+	class ThreadPool;
+
+	/**
+	 * @brief      Batch decoding options.
+	 */
+	class BatchDecodeOptions
+	{
+	public:
+		/**
+		 * @brief      Maximum number of the files read but not decoded yet; `0` for twice the number of the threads.
+		 */
+		Int32 maxInFlight = 0;
+
+		/**
+		 * @brief      Maximum total size of the files read but not decoded yet in bytes; `0` for no limit.
+		 *
+		 *             A file larger than the limit is read when no other file is in flight.
+		 */
+		std::size_t maxInFlightBytes = 0;
+	};
+
+	/**
+	 * @brief      Result of decoding a file in a batch.
+	 */
+	class BatchDecodeResult
+	{
+	public:
+		/**
+		 * @brief      The decoded image, or `std::nullopt` if failed.
+		 */
+		std::optional<Image> image;
+
+		/**
+		 * @brief      The exception thrown while reading or decoding the file, or `nullptr` if succeeded.
+		 */
+		std::exception_ptr error;
+
+		/**
+		 * @brief      Determines if the file was decoded.
+		 *
+		 * @return     `true` if the image is decoded, `false` otherwise.
+		 */
+		[[nodiscard]]
+		bool succeeded() const noexcept
+		{
+			return image.has_value();
+		}
+	};
 
 	/**
 	 * @brief      Image format manager.
@@ -61,6 +113,9 @@ namespace Nene
 		/**
 		 * @brief      Adds the image format.
 		 *
+		 *             The formats without a signature are kept after the others
+		 *             so that their header heuristics are tried last.
+		 *
 		 * @param      imageFormat  The image format to add.
 		 *
 		 * @return     `*this`.
@@ -97,6 +152,16 @@ namespace Nene
 		[[nodiscard]]
 		std::optional<std::reference_wrapper<IImageFormat>> findFormatFromHeader(const std::array<Byte, 16>& header) const noexcept;
 
+		/**
+		 * @brief      Reads the image properties from the header without decoding the pixels.
+		 *
+		 * @param      reader  The image data reader.
+		 *
+		 * @return     The image properties.
+		 */
+		[[nodiscard]]
+		ImageInfo probe(IReader& reader);
+
 		/**
 		 * @brief      Constructs a image from a reader.
 		 *
@@ -107,6 +172,70 @@ namespace Nene
 		[[nodiscard]]
 		Image decode(IReader& reader);
 
+		/**
+		 * @brief      Constructs a image in its narrowest pixel format from a reader.
+		 *
+		 * @param      reader  The image data reader.
+		 *
+		 * @return     The image from `reader`.
+		 */
+		[[nodiscard]]
+		AnyImage decodeNative(IReader& reader);
+
+		/**
+		 * @brief      Decodes a image into the caller's pixel buffer.
+		 *
+		 * @param      reader  The image data reader.
+		 * @param[in]  image   The destination image view.
+		 */
+		void decodeInto(IReader& reader, MutableImageView image);
+
+		/**
+		 * @brief      Creates a decoder reading the image row by row.
+		 *
+		 * @param      reader  The image data reader, which must outlive the decoder.
+		 *
+		 * @return     The image decoder.
+		 */
+		[[nodiscard]]
+		std::unique_ptr<IImageDecoder> createDecoder(IReader& reader);
+
+		/**
+		 * @brief      Decodes the image files on the shared thread pool.
+		 *
+		 *             It is safe to call from a task running on the shared
+		 *             thread pool; see the overload taking the pool.
+		 *
+		 * @param[in]  paths    The image file paths.
+		 * @param[in]  options  The batch decoding options.
+		 *
+		 * @return     The results in the order of `paths`.
+		 */
+		[[nodiscard]]
+		std::vector<BatchDecodeResult> decodeAll(ArrayView<path_type> paths, const BatchDecodeOptions& options = {});
+
+		/**
+		 * @brief      Decodes the image files.
+		 *
+		 *             The calling thread reads the files one by one while the
+		 *             pool decodes the files already read. Errors are reported
+		 *             per file and do not stop the other files.
+		 *
+		 *             Instead of blocking while the workers are busy, the
+		 *             calling thread decodes the queued files itself, like
+		 *             `ThreadPool::parallelFor()`. So it is safe to call from a
+		 *             task running on `pool`, even if every worker is busy or
+		 *             the pool has no workers.
+		 *
+		 * @param[in]  paths    The image file paths.
+		 * @param[in]  options  The batch decoding options.
+		 * @param      pool     The thread pool to decode the images on.
+		 *
+		 * @return     The results in the order of `paths`.
+		 */
+		[[nodiscard]]
+		std::vector<BatchDecodeResult> decodeAll(ArrayView<path_type> paths, const BatchDecodeOptions& options, ThreadPool& pool);
+
 		/**
 		 * @brief      Returns the list of image format codecs.
 		 *
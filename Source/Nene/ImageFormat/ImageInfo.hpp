@@ -0,0 +1,64 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_IMAGEFORMAT_IMAGEINFO_HPP
+#define INCLUDE_NENE_IMAGEFORMAT_IMAGEINFO_HPP
+
+#include "../Size2D.hpp"
+
+namespace Nene
+{
+	/**
+	 * @brief      Properties of an encoded image.
+	 */
+	class ImageInfo
+	{
+	public:
+		/**
+		 * @brief      The image size.
+		 */
+		Size2Di size;
+
+		/**
+		 * @brief      Number of the stored channels, including alpha.
+		 */
+		Int32 channels;
+
+		/**
+		 * @brief      Number of the bits per channel.
+		 */
+		Int32 bitDepth;
+
+		/**
+		 * @brief      `true` if the image has transparency.
+		 */
+		bool hasAlpha;
+
+		/**
+		 * @brief      `true` if the image is interlaced or progressive.
+		 */
+		bool interlaced;
+	};
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGEFORMAT_IMAGEINFO_HPP
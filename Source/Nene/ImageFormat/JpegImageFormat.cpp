@@ -22,15 +22,23 @@
 //=============================================================================
 
 #include <cstdio>
+#include <vector>
 #include <libjpeg/jpeglib.h>
 #include <libjpeg/jerror.h>
 #include "../Platform.hpp"
 #include "../Scope.hpp"
+#include "../Uncopyable.hpp"
+#include "../ImageProcessing/Convert.hpp"
 #include "../Reader/IReader.hpp"
+#include "../Serialization/BinaryDeserializer.hpp"
 #include "../Writer/IWriter.hpp"
 #include "JpegImageFormat.hpp"
 #include "JpegImageFormatException.hpp"
 
+#if defined(NENE_SIMD_SSSE3)
+#  include <tmmintrin.h>
+#endif
+
 namespace Nene
 {
 	namespace
@@ -150,6 +158,407 @@ namespace Nene
 				}
 			}
 		}
+
+		// Layouts of the decompressed scanlines.
+		enum class Output
+		{
+			gray,
+			rgb,
+			rgba,
+			cmyk,
+			invertedCmyk,
+		};
+
+		[[nodiscard]]
+		constexpr J_DCT_METHOD dctMethod(JpegDct dct) noexcept
+		{
+			switch (dct)
+			{
+				case JpegDct::fast    : return JDCT_IFAST;
+				case JpegDct::floating: return JDCT_FLOAT;
+				default               : return JDCT_ISLOW;
+			}
+		}
+
+		// Expands 24bit RGB pixels into RGBA.
+		void expandRgb(const UInt8* source, Color4* destination, std::size_t count) noexcept
+		{
+			std::size_t i = 0;
+
+#if defined(NENE_SIMD_SSSE3)
+			const auto shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+			const auto alpha   = _mm_set1_epi32(static_cast<int>(0xff000000));
+
+			// Each load covers 16 bytes of the 12 bytes used.
+			for (; i * 3 + 16 <= count * 3; i += 4)
+			{
+				const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 3));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alpha));
+			}
+#endif
+
+			for (; i < count; i++)
+			{
+				destination[i].red   = source[i*3 + 0];
+				destination[i].green = source[i*3 + 1];
+				destination[i].blue  = source[i*3 + 2];
+				destination[i].alpha = 255;
+			}
+		}
+
+		// Packs RGBA pixels into 24bit RGB.
+		[[maybe_unused]]
+		void packRgb(const Color4* source, UInt8* destination, std::size_t count) noexcept
+		{
+			std::size_t i = 0;
+
+#if defined(NENE_SIMD_SSSE3)
+			const auto shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+			// Each store covers 16 bytes of the 12 bytes written.
+			for (; i * 3 + 16 <= count * 3; i += 4)
+			{
+				const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * 3), _mm_shuffle_epi8(v, shuffle));
+			}
+#endif
+
+			for (; i < count; i++)
+			{
+				destination[i*3 + 0] = source[i].red;
+				destination[i*3 + 1] = source[i].green;
+				destination[i*3 + 2] = source[i].blue;
+			}
+		}
+
+		// Converts CMYK pixels into RGBA; Adobe applications store the inks inverted.
+		void convertCmyk(const UInt8* source, Color4* destination, std::size_t count, bool inverted) noexcept
+		{
+			const UInt32 flip = inverted ? 0 : 255;
+
+			for (std::size_t i = 0; i < count; i++)
+			{
+				const UInt32 c = source[i*4 + 0] ^ flip;
+				const UInt32 m = source[i*4 + 1] ^ flip;
+				const UInt32 y = source[i*4 + 2] ^ flip;
+				const UInt32 k = source[i*4 + 3] ^ flip;
+
+				destination[i].red   = static_cast<UInt8>((c * k + 127) / 255);
+				destination[i].green = static_cast<UInt8>((m * k + 127) / 255);
+				destination[i].blue  = static_cast<UInt8>((y * k + 127) / 255);
+				destination[i].alpha = 255;
+			}
+		}
+
+		// Decompression struct and buffers reusable for the images one after another.
+		class JpegContext final
+			: private Uncopyable
+		{
+			// Number of the scanlines read per batch.
+			static constexpr Int32 batchRows = 16;
+
+			jpeg_decompress_struct cinfo_;
+			jpeg_error_mgr         err_;
+			SourceMgr*             src_;
+			Output                 output_;
+			bool                   finished_;
+			std::vector<JSAMPLE>   lines_;
+
+		public:
+			// `true` while an image is being decoded.
+			bool busy;
+
+			JpegContext()
+				: src_(nullptr)
+				, output_(Output::rgb)
+				, finished_(false)
+				, lines_()
+				, busy(false)
+			{
+				// Set error handler.
+				cinfo_.err          = jpeg_std_error(&err_);
+				err_.output_message = outputMessage;
+				err_.error_exit     = error;
+
+				// Initialize decompression struct.
+				jpeg_create_decompress(&cinfo_);
+
+				try
+				{
+					// Set source.
+					src_ = static_cast<SourceMgr*>(cinfo_.mem->alloc_small(
+						reinterpret_cast<j_common_ptr>(&cinfo_), JPOOL_PERMANENT, sizeof(SourceMgr)));
+
+					src_->buffer = static_cast<JOCTET*>(cinfo_.mem->alloc_small(
+						reinterpret_cast<j_common_ptr>(&cinfo_), JPOOL_PERMANENT, inputBufferSize * sizeof(JOCTET)));
+
+					cinfo_.src = &src_->src;
+					src_->src.init_source       = initSrc;
+					src_->src.fill_input_buffer = fillInputBuffer;
+					src_->src.skip_input_data   = skipInputData;
+					src_->src.resync_to_restart = jpeg_resync_to_restart; // Use default.
+					src_->src.term_source       = termSrc;
+				}
+				catch (...)
+				{
+					// Destroy decompression struct.
+					jpeg_destroy_decompress(&cinfo_);
+
+					throw;
+				}
+			}
+
+			~JpegContext()
+			{
+				// Destroy decompression struct.
+				jpeg_destroy_decompress(&cinfo_);
+			}
+
+			// Reads the header and starts decompressing the image from the reader.
+			ImageInfo start(IReader& reader, const JpegDecodeOptions& options)
+			{
+				src_->src.bytes_in_buffer = 0;
+				src_->src.next_input_byte = nullptr;
+				src_->reader              = &reader;
+				finished_                 = false;
+
+				jpeg_read_header(&cinfo_, TRUE);
+
+				// Scale and DCT method.
+				cinfo_.scale_num           = 1;
+				cinfo_.scale_denom         = static_cast<unsigned int>(options.scale);
+				cinfo_.dct_method          = dctMethod(options.dct);
+				cinfo_.do_fancy_upsampling = options.fancyUpsampling ? TRUE : FALSE;
+
+				// Choose the output color space.
+				switch (cinfo_.jpeg_color_space)
+				{
+					case JCS_GRAYSCALE:
+						output_ = Output::gray;
+						break;
+
+					case JCS_CMYK:
+					case JCS_YCCK:
+						cinfo_.out_color_space = JCS_CMYK;
+						output_ = cinfo_.saw_Adobe_marker ? Output::invertedCmyk : Output::cmyk;
+						break;
+
+					default:
+#if defined(JCS_EXTENSIONS)
+						// Decompress into RGBA directly.
+						cinfo_.out_color_space = JCS_EXT_RGBA;
+						output_ = Output::rgba;
+#else
+						cinfo_.out_color_space = JCS_RGB;
+						output_ = Output::rgb;
+#endif
+						break;
+				}
+
+				jpeg_start_decompress(&cinfo_);
+
+				return
+				{
+					Size2Di { static_cast<Int32>(cinfo_.output_width), static_cast<Int32>(cinfo_.output_height) },
+					cinfo_.num_components,
+					cinfo_.data_precision,
+					false,
+					cinfo_.progressive_mode != FALSE,
+				};
+			}
+
+			// Releases the image; the struct is ready for the next one.
+			void reset() noexcept
+			{
+				jpeg_abort_decompress(&cinfo_);
+			}
+
+			[[nodiscard]]
+			bool isGray() const noexcept
+			{
+				return output_ == Output::gray;
+			}
+
+			[[nodiscard]]
+			Int32 currentRow() const noexcept
+			{
+				return static_cast<Int32>(cinfo_.output_scanline);
+			}
+
+			// Reads the scanlines in the output color space.
+			void readScanlines(JSAMPARRAY rows, Int32 count)
+			{
+				for (Int32 read = 0; read < count; )
+				{
+					read += static_cast<Int32>(jpeg_read_scanlines(&cinfo_, rows + read, static_cast<JDIMENSION>(count - read)));
+				}
+
+				if (!finished_ && cinfo_.output_scanline == cinfo_.output_height)
+				{
+					// Finish decompress.
+					jpeg_finish_decompress(&cinfo_);
+
+					finished_ = true;
+				}
+			}
+
+			// Reads the scanlines into the rows of the output pixel size.
+			template <typename Pixel>
+			void readScanlines(BasicMutableImageView<Pixel> rows)
+			{
+				for (Int32 y = 0; y < rows.height(); )
+				{
+					const auto n = (std::min)(batchRows, rows.height() - y);
+
+					JSAMPROW pointers[batchRows];
+
+					for (Int32 i = 0; i < n; i++)
+					{
+						pointers[i] = reinterpret_cast<JSAMPROW>(rows.row(y + i));
+					}
+
+					readScanlines(pointers, n);
+
+					y += n;
+				}
+			}
+
+			Int32 readRows(MutableImageView rows)
+			{
+				assert(rows.width() == static_cast<Int32>(cinfo_.output_width));
+
+				const auto count      = (std::min)(rows.height(), static_cast<Int32>(cinfo_.output_height - cinfo_.output_scanline));
+				const auto width      = static_cast<std::size_t>(cinfo_.output_width);
+				const auto components = static_cast<std::size_t>(cinfo_.output_components);
+
+				if (output_ == Output::rgba)
+				{
+					readScanlines(rows.rows(0, count));
+
+					return count;
+				}
+
+				lines_.resize(width * components * batchRows);
+
+				for (Int32 y = 0; y < count; )
+				{
+					const auto n = (std::min)(batchRows, count - y);
+
+					JSAMPROW pointers[batchRows];
+
+					for (Int32 i = 0; i < n; i++)
+					{
+						pointers[i] = lines_.data() + width * components * i;
+					}
+
+					readScanlines(pointers, n);
+
+					for (Int32 i = 0; i < n; i++, y++)
+					{
+						const auto p   = pointers[i];
+						const auto row = rows.row(y);
+
+						switch (output_)
+						{
+							case Output::gray:
+								ImageProcessing::convertRow(reinterpret_cast<const PixelR8*>(p), row, width);
+								break;
+
+							case Output::cmyk:
+							case Output::invertedCmyk:
+								convertCmyk(p, row, width, output_ == Output::invertedCmyk);
+								break;
+
+							default:
+								expandRgb(p, row, width);
+								break;
+						}
+					}
+				}
+
+				return count;
+			}
+		};
+
+		// Runs the function with the context of the thread, or a new one while it is busy.
+		template <typename Function>
+		decltype(auto) withContext(Function&& function)
+		{
+			thread_local JpegContext context;
+
+			if (context.busy)
+			{
+				JpegContext local;
+
+				return function(local);
+			}
+
+			context.busy = true;
+
+			[[maybe_unused]] const auto _ = scopeExit([&]()
+			{
+				context.reset();
+				context.busy = false;
+			});
+
+			return function(context);
+		}
+
+		class JpegDecoder final
+			: public  IImageDecoder
+			, private Uncopyable
+		{
+			JpegContext context_;
+			ImageInfo   info_;
+
+		public:
+			explicit JpegDecoder(IReader& reader, const JpegDecodeOptions& options)
+				: context_()
+				, info_(context_.start(reader, options)) {}
+
+			~JpegDecoder() =default;
+
+			[[nodiscard]]
+			const ImageInfo& info() const noexcept override
+			{
+				return info_;
+			}
+
+			[[nodiscard]]
+			Int32 currentRow() const noexcept override
+			{
+				return context_.currentRow();
+			}
+
+			Int32 readRows(MutableImageView rows) override
+			{
+				return context_.readRows(rows);
+			}
+		};
+
+		AnyImage readJpeg(IReader& reader, bool native, const JpegDecodeOptions& options)
+		{
+			return withContext([&](JpegContext& context) -> AnyImage
+			{
+				const auto size = context.start(reader, options).size;
+
+				if (native && context.isGray())
+				{
+					// Read gray scale scanlines directly into the image.
+					ImageR8 image { size };
+					context.readScanlines(image.mutableView());
+
+					return image;
+				}
+
+				Image image { size };
+				context.readRows(image.mutableView());
+
+				return image;
+			});
+		}
 	}
 
 	JpegImageFormat::JpegImageFormat(std::string_view name)
@@ -181,76 +590,144 @@ namespace Nene
 		return std::memcmp(header.data(), signature, sizeof(signature)) == 0;
 	}
 
-	Image JpegImageFormat::decode(IReader& reader)
+	ImageInfo JpegImageFormat::probe(IReader& reader)
 	{
-		jpeg_decompress_struct cinfo;
-		jpeg_error_mgr err;
-
-		// Set error handler.
-		cinfo.err          = jpeg_std_error(&err);
-		err.output_message = outputMessage;
-		err.error_exit     = error;
-
-		// Initialize decompression struct.
-		jpeg_create_decompress(&cinfo);
+		const auto position = reader.position();
 
 		[[maybe_unused]] const auto _ = scopeExit([&]()
 		{
-			// Destroy decompression struct.
-			jpeg_destroy_decompress(&cinfo);
+			reader.position(position);
 		});
 
-		// Set source.
-		const auto src = static_cast<SourceMgr*>(cinfo.mem->alloc_small(
-			reinterpret_cast<j_common_ptr>(&cinfo), JPOOL_PERMANENT, sizeof(SourceMgr)));
+		Serialization::BinaryDeserializer archive { reader, Endian::Order::big };
 
-		src->buffer = static_cast<JOCTET*>(cinfo.mem->alloc_small(
-			reinterpret_cast<j_common_ptr>(&cinfo), JPOOL_IMAGE, inputBufferSize * sizeof(JOCTET)));
+		UInt16 soi;
+		archive.serialize(soi);
 
-		cinfo.src = &src->src;
-		src->src.init_source       = initSrc;
-		src->src.fill_input_buffer = fillInputBuffer;
-		src->src.skip_input_data   = skipInputData;
-		src->src.resync_to_restart = jpeg_resync_to_restart; // Use default.
-		src->src.term_source       = termSrc;
-		src->src.bytes_in_buffer   = 0;
-		src->src.next_input_byte   = nullptr;
-		src->reader                = &reader;
+		if (soi != 0xffd8)
+		{
+			throw JpegImageFormatException { u8"Invalid JPEG signature." };
+		}
 
-		// Read data.
-		jpeg_read_header(&cinfo, TRUE);
-		jpeg_start_decompress(&cinfo);
+		// Walk the marker segments up to the frame header.
+		for (;;)
+		{
+			UInt8 prefix, marker;
+			archive.serialize(prefix);
 
-		Image image { static_cast<Int32>(cinfo.image_width), static_cast<Int32>(cinfo.image_height) };
-		std::vector<JSAMPLE> line(cinfo.image_width * cinfo.output_components);
+			if (prefix != 0xff)
+			{
+				throw JpegImageFormatException { u8"Invalid JPEG marker." };
+			}
 
-		for (std::size_t y = 0; y < cinfo.output_height; y++)
-		{
-			auto p = line.data();
+			do
+			{
+				archive.serialize(marker);
+			}
+			while (marker == 0xff);
 
-			jpeg_read_scanlines(&cinfo, &p, 1);
+			if (marker == 0x01 || (0xd0 <= marker && marker <= 0xd8))
+			{
+				// Markers without segment.
+				continue;
+			}
 
-			for (std::size_t x = 0; x < cinfo.image_width; x++)
+			if (marker == 0xd9 || marker == 0xda)
 			{
-				image.dataPointer()[x + y*cinfo.image_width].red   = p[x*3 + 0];
-				image.dataPointer()[x + y*cinfo.image_width].green = p[x*3 + 1];
-				image.dataPointer()[x + y*cinfo.image_width].blue  = p[x*3 + 2];
-				image.dataPointer()[x + y*cinfo.image_width].alpha = 255;
+				throw JpegImageFormatException { u8"JPEG frame header not found." };
 			}
+
+			UInt16 length;
+			archive.serialize(length);
+
+			if (0xc0 <= marker && marker <= 0xcf && marker != 0xc4 && marker != 0xc8 && marker != 0xcc)
+			{
+				UInt8  precision, components;
+				UInt16 height, width;
+
+				archive
+					.serialize(precision)
+					.serialize(height)
+					.serialize(width)
+					.serialize(components)
+				;
+
+				return
+				{
+					Size2Di { width, height },
+					components,
+					precision,
+					false,
+					(marker & 0x03) == 0x02,
+				};
+			}
+
+			reader.position(reader.position() + length - 2);
 		}
+	}
+
+	Image JpegImageFormat::decode(IReader& reader)
+	{
+		return decode(reader, {});
+	}
 
-		// Finish decompress.
-		jpeg_finish_decompress(&cinfo);
+	Image JpegImageFormat::decode(IReader& reader, const JpegDecodeOptions& options)
+	{
+		return std::get<Image>(readJpeg(reader, false, options));
+	}
 
-		return image;
+	AnyImage JpegImageFormat::decodeNative(IReader& reader)
+	{
+		return decodeNative(reader, {});
 	}
 
-	void JpegImageFormat::encode(const Image& image, IWriter& writer)
+	AnyImage JpegImageFormat::decodeNative(IReader& reader, const JpegDecodeOptions& options)
+	{
+		return readJpeg(reader, true, options);
+	}
+
+	void JpegImageFormat::decodeInto(IReader& reader, MutableImageView image)
+	{
+		decodeInto(reader, image, {});
+	}
+
+	void JpegImageFormat::decodeInto(IReader& reader, MutableImageView image, const JpegDecodeOptions& options)
+	{
+		withContext([&](JpegContext& context)
+		{
+			if (context.start(reader, options).size != image.size())
+			{
+				throw JpegImageFormatException { u8"Image size mismatch." };
+			}
+
+			context.readRows(image);
+		});
+	}
+
+	std::unique_ptr<IImageDecoder> JpegImageFormat::createDecoder(IReader& reader)
+	{
+		return createDecoder(reader, {});
+	}
+
+	std::unique_ptr<IImageDecoder> JpegImageFormat::createDecoder(IReader& reader, const JpegDecodeOptions& options)
+	{
+		return std::make_unique<JpegDecoder>(reader, options);
+	}
+
+	void JpegImageFormat::encode(ImageView image, IWriter& writer)
 	{
 		encode(image, writer, 100);
 	}
 
-	void JpegImageFormat::encode(const Image& image, IWriter& writer, Int32 quality)
+	void JpegImageFormat::encode(ImageView image, IWriter& writer, Int32 quality)
+	{
+		JpegEncodeOptions options;
+		options.quality = quality;
+
+		encode(image, writer, options);
+	}
+
+	void JpegImageFormat::encode(ImageView image, IWriter& writer, const JpegEncodeOptions& options)
 	{
 		jpeg_compress_struct cinfo;
 		jpeg_error_mgr err;
@@ -280,33 +757,76 @@ namespace Nene
 		dest->writer                   = &writer;
 
 		// Compress data.
-		cinfo.image_width      = image.width();
-		cinfo.image_height     = image.height();
+		cinfo.image_width  = image.width();
+		cinfo.image_height = image.height();
+#if defined(JCS_EXTENSIONS)
+		// Compress the RGBA rows directly.
+		cinfo.in_color_space   = JCS_EXT_RGBA;
+		cinfo.input_components = 4;
+#else
 		cinfo.in_color_space   = JCS_RGB;
 		cinfo.input_components = 3;
+#endif
 
 		jpeg_set_defaults(&cinfo);
-		jpeg_set_quality(&cinfo, std::clamp(quality, 0, 100), TRUE);
+		jpeg_set_quality(&cinfo, std::clamp(options.quality, 0, 100), TRUE);
+
+		// Luma sampling factors; the chroma is sampled once per MCU.
+		switch (options.subsampling)
+		{
+			case JpegSubsampling::yuv444:
+				cinfo.comp_info[0].h_samp_factor = 1;
+				cinfo.comp_info[0].v_samp_factor = 1;
+				break;
+
+			case JpegSubsampling::yuv422:
+				cinfo.comp_info[0].h_samp_factor = 2;
+				cinfo.comp_info[0].v_samp_factor = 1;
+				break;
+
+			default:
+				cinfo.comp_info[0].h_samp_factor = 2;
+				cinfo.comp_info[0].v_samp_factor = 2;
+				break;
+		}
+
+		cinfo.optimize_coding  = options.optimizeCoding ? TRUE : FALSE;
+		cinfo.dct_method       = dctMethod(options.dct);
+		cinfo.restart_interval = static_cast<unsigned int>((std::max)(options.restartInterval, 0));
+		cinfo.smoothing_factor = std::clamp(options.smoothing, 0, 100);
+
+		if (options.progressive)
+		{
+			jpeg_simple_progression(&cinfo);
+		}
 
 		// Start compress.
 		jpeg_start_compress(&cinfo, TRUE);
 
-		std::vector<JSAMPLE> line(cinfo.image_width * 3);
+		constexpr Int32 batchRows = 16;
+
+#if !defined(JCS_EXTENSIONS)
+		std::vector<JSAMPLE> lines(cinfo.image_width * 3 * batchRows);
+#endif
 
-		for (std::size_t y = 0; y < cinfo.image_height; y++)
+		for (Int32 y = 0; y < image.height(); )
 		{
-			auto p = line.data();
+			const auto n = (std::min)(batchRows, image.height() - y);
+
+			JSAMPROW pointers[batchRows];
 
-			for (std::size_t x = 0; x < cinfo.image_width; x++)
+			for (Int32 i = 0; i < n; i++)
 			{
-				const auto& c = image.data()[x + y*cinfo.image_width];
+#if defined(JCS_EXTENSIONS)
+				pointers[i] = const_cast<JSAMPROW>(reinterpret_cast<const JSAMPLE*>(image.row(y + i)));
+#else
+				pointers[i] = lines.data() + cinfo.image_width * 3 * i;
 
-				p[x*3 + 0] = c.red;
-				p[x*3 + 1] = c.green;
-				p[x*3 + 2] = c.blue;
+				packRgb(image.row(y + i), pointers[i], cinfo.image_width);
+#endif
 			}
 
-			jpeg_write_scanlines(&cinfo, &p, 1);
+			y += static_cast<Int32>(jpeg_write_scanlines(&cinfo, pointers, static_cast<JDIMENSION>(n)));
 		}
 
 		// Finish compress.
@@ -29,6 +29,101 @@
 
 namespace Nene
 {
+	/**
+	 * @brief      JPEG decoding scale, performed in the DCT domain.
+	 */
+	enum class JpegScale: Int32
+	{
+		full    = 1,
+		half    = 2,
+		quarter = 4,
+		eighth  = 8,
+	};
+
+	/**
+	 * @brief      JPEG DCT methods.
+	 */
+	enum class JpegDct: Int32
+	{
+		accurate,
+		fast,
+		floating,
+	};
+
+	/**
+	 * @brief      JPEG decoding options.
+	 */
+	class JpegDecodeOptions
+	{
+	public:
+		/**
+		 * @brief      The scale of the decoded image.
+		 */
+		JpegScale scale = JpegScale::full;
+
+		/**
+		 * @brief      The inverse DCT method.
+		 */
+		JpegDct dct = JpegDct::accurate;
+
+		/**
+		 * @brief      `false` to upsample the chroma by replication, which is faster.
+		 */
+		bool fancyUpsampling = true;
+	};
+
+	/**
+	 * @brief      JPEG chroma subsampling.
+	 */
+	enum class JpegSubsampling: Int32
+	{
+		yuv444,
+		yuv422,
+		yuv420,
+	};
+
+	/**
+	 * @brief      JPEG encoding options.
+	 */
+	class JpegEncodeOptions
+	{
+	public:
+		/**
+		 * @brief      The image quality from `0` to `100`.
+		 */
+		Int32 quality = 90;
+
+		/**
+		 * @brief      `true` to write a progressive JPEG.
+		 */
+		bool progressive = false;
+
+		/**
+		 * @brief      `true` to compute optimal Huffman tables, which is smaller but slower.
+		 */
+		bool optimizeCoding = false;
+
+		/**
+		 * @brief      The chroma subsampling.
+		 */
+		JpegSubsampling subsampling = JpegSubsampling::yuv420;
+
+		/**
+		 * @brief      The forward DCT method.
+		 */
+		JpegDct dct = JpegDct::accurate;
+
+		/**
+		 * @brief      The number of MCUs between the restart markers, `0` for none.
+		 */
+		Int32 restartInterval = 0;
+
+		/**
+		 * @brief      The input smoothing factor from `0` to `100`.
+		 */
+		Int32 smoothing = 0;
+	};
+
 	/**
 	 * @brief      JPEG image format.
 	 */
@@ -69,21 +164,97 @@ namespace Nene
 		[[nodiscard]]
 		bool isImageHeader(const std::array<Byte, 16>& header) const noexcept override;
 
+		/**
+		 * @see        `Nene::IImageFormat::probe()`.
+		 */
+		[[nodiscard]]
+		ImageInfo probe(IReader& reader) override;
+
 		/**
 		 * @see        `Nene::IImageFormat::decode()`.
 		 */
 		[[nodiscard]]
 		Image decode(IReader& reader) override;
 
+		/**
+		 * @brief      Constructs a image from a reader.
+		 *
+		 * @param      reader   The image data reader.
+		 * @param[in]  options  The decoding options.
+		 *
+		 * @return     The image from `reader`.
+		 */
+		[[nodiscard]]
+		Image decode(IReader& reader, const JpegDecodeOptions& options);
+
+		/**
+		 * @see        `Nene::IImageFormat::decodeNative()`.
+		 */
+		[[nodiscard]]
+		AnyImage decodeNative(IReader& reader) override;
+
+		/**
+		 * @brief      Constructs a image in its narrowest pixel format from a reader.
+		 *
+		 * @param      reader   The image data reader.
+		 * @param[in]  options  The decoding options.
+		 *
+		 * @return     The image from `reader`.
+		 */
+		[[nodiscard]]
+		AnyImage decodeNative(IReader& reader, const JpegDecodeOptions& options);
+
+		/**
+		 * @see        `Nene::IImageFormat::decodeInto()`.
+		 */
+		void decodeInto(IReader& reader, MutableImageView image) override;
+
+		/**
+		 * @brief      Decodes a image into the caller's pixel buffer.
+		 *
+		 *             The size of `image` must match the scaled size of the image.
+		 *
+		 * @param      reader   The image data reader.
+		 * @param[in]  image    The destination image view.
+		 * @param[in]  options  The decoding options.
+		 */
+		void decodeInto(IReader& reader, MutableImageView image, const JpegDecodeOptions& options);
+
+		/**
+		 * @see        `Nene::IImageFormat::createDecoder()`.
+		 */
+		[[nodiscard]]
+		std::unique_ptr<IImageDecoder> createDecoder(IReader& reader) override;
+
+		/**
+		 * @brief      Creates a decoder reading the image row by row.
+		 *
+		 * @param      reader   The image data reader, which must outlive the decoder.
+		 * @param[in]  options  The decoding options.
+		 *
+		 * @return     The image decoder.
+		 */
+		[[nodiscard]]
+		std::unique_ptr<IImageDecoder> createDecoder(IReader& reader, const JpegDecodeOptions& options);
+
 		/**
 		 * @see        `Nene::IImageFormat::encode()`.
 		 */
-		void encode(const Image& image, IWriter& writer) override;
+		void encode(ImageView image, IWriter& writer) override;
 
 		/**
 		 * @see        `Nene::IImageFormat::encode()`.
 		 */
-		void encode(const Image& image, IWriter& writer, Int32 quality) override;
+		void encode(ImageView image, IWriter& writer, Int32 quality) override;
+
+		/**
+		 * @brief      Writes a image to a writer.
+		 *
+		 * @param[in]  image    The image data to write.
+		 * @param      writer   The image data writer.
+		 * @param[in]  options  The encoding options.
+		 */
+		void encode(ImageView image, IWriter& writer, const JpegEncodeOptions& options);
 	};
 }
 
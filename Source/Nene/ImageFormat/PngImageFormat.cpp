@@ -21,19 +21,34 @@
 // OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //=============================================================================
 
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
 #include <fmt/ostream.h>
 #include <libpng/png.h>
+#include <zlib/zlib.h>
 #include "PngImageFormat.hpp"
 #include "PngImageFormatException.hpp"
+#include "../Endian.hpp"
 #include "../Platform.hpp"
 #include "../Scope.hpp"
+#include "../Uncopyable.hpp"
 #include "../Reader/IReader.hpp"
+#include "../Serialization/BinaryDeserializer.hpp"
+#include "../Thread/ThreadPool.hpp"
 #include "../Writer/IWriter.hpp"
 
 namespace Nene
 {
 	namespace
 	{
+		constexpr UInt32 chunkType(const char (&name)[5]) noexcept
+		{
+			return static_cast<UInt32>(name[0]) << 24 | static_cast<UInt32>(name[1]) << 16 | static_cast<UInt32>(name[2]) << 8 | static_cast<UInt32>(name[3]);
+		}
+
 		void error([[maybe_unused]] ::png_structp png, ::png_const_charp message)
 		{
 			throw PngImageFormatException { fmt::format(u8"PNG image format error\nDescription: {}", message) };
@@ -59,6 +74,752 @@ namespace Nene
 
 			writer->write(buffer, size);
 		}
+
+		[[nodiscard]]
+		constexpr int zlibStrategy(PngStrategy strategy) noexcept
+		{
+			switch (strategy)
+			{
+				case PngStrategy::filtered   : return Z_FILTERED;
+				case PngStrategy::huffmanOnly: return Z_HUFFMAN_ONLY;
+				case PngStrategy::rle        : return Z_RLE;
+				case PngStrategy::fixed      : return Z_FIXED;
+				default                      : return Z_DEFAULT_STRATEGY;
+			}
+		}
+
+		[[nodiscard]]
+		constexpr int filterMask(PngFilter filter) noexcept
+		{
+			switch (filter)
+			{
+				case PngFilter::none   : return PNG_FILTER_NONE;
+				case PngFilter::sub    : return PNG_FILTER_SUB;
+				case PngFilter::up     : return PNG_FILTER_UP;
+				case PngFilter::average: return PNG_FILTER_AVG;
+				case PngFilter::paeth  : return PNG_FILTER_PAETH;
+				default                : return PNG_ALL_FILTERS;
+			}
+		}
+
+		// Bytes per pixel of the RGBA rows.
+		constexpr std::size_t pixelBytes = 4;
+
+		// Deflate window size.
+		constexpr std::size_t windowBytes = std::size_t { 1 } << MAX_WBITS;
+
+		Int32 rowsPerTask(Int32 height, ThreadPool& pool) noexcept
+		{
+			const auto chunks = static_cast<Int32>(pool.numThreads() + 1) * 4;
+
+			return (std::max)((height + chunks - 1) / chunks, 1);
+		}
+
+		[[nodiscard]]
+		constexpr UInt8 paeth(Int32 a, Int32 b, Int32 c) noexcept
+		{
+			const auto p  = a + b - c;
+			const auto pa = std::abs(p - a);
+			const auto pb = std::abs(p - b);
+			const auto pc = std::abs(p - c);
+
+			return static_cast<UInt8>(pa <= pb && pa <= pc ? a : pb <= pc ? b : c);
+		}
+
+		// Filters a row; `out` receives the filter type followed by the filtered bytes.
+		void filterRow(PngFilter filter, const UInt8* row, const UInt8* previous, UInt8* out, std::size_t bytes) noexcept
+		{
+			assert(filter != PngFilter::adaptive);
+
+			out[0] = static_cast<UInt8>(filter);
+
+			const auto dst = out + 1;
+
+			switch (filter)
+			{
+				case PngFilter::none:
+					std::memcpy(dst, row, bytes);
+					break;
+
+				case PngFilter::sub:
+					for (std::size_t i = 0; i < bytes; i++)
+					{
+						dst[i] = static_cast<UInt8>(row[i] - (i < pixelBytes ? 0 : row[i - pixelBytes]));
+					}
+					break;
+
+				case PngFilter::up:
+					for (std::size_t i = 0; i < bytes; i++)
+					{
+						dst[i] = static_cast<UInt8>(row[i] - previous[i]);
+					}
+					break;
+
+				case PngFilter::average:
+					for (std::size_t i = 0; i < bytes; i++)
+					{
+						const Int32 left = i < pixelBytes ? 0 : row[i - pixelBytes];
+
+						dst[i] = static_cast<UInt8>(row[i] - ((left + previous[i]) >> 1));
+					}
+					break;
+
+				default:
+					for (std::size_t i = 0; i < bytes; i++)
+					{
+						const Int32 left   = i < pixelBytes ? 0 : row[i - pixelBytes];
+						const Int32 upLeft = i < pixelBytes ? 0 : previous[i - pixelBytes];
+
+						dst[i] = static_cast<UInt8>(row[i] - paeth(left, previous[i], upLeft));
+					}
+					break;
+			}
+		}
+
+		// Filters a row with the filter of the least sum of the absolute signed bytes, as libpng does.
+		void filterAdaptive(const UInt8* row, const UInt8* previous, UInt8* out, UInt8* scratch, std::size_t bytes) noexcept
+		{
+			UInt64 best = (std::numeric_limits<UInt64>::max)();
+
+			for (const auto filter : { PngFilter::none, PngFilter::sub, PngFilter::up, PngFilter::average, PngFilter::paeth })
+			{
+				filterRow(filter, row, previous, scratch, bytes);
+
+				UInt64 cost = 0;
+
+				for (std::size_t i = 1; i <= bytes; i++)
+				{
+					cost += static_cast<UInt64>(std::abs(static_cast<Int32>(static_cast<Int8>(scratch[i]))));
+				}
+
+				if (cost < best)
+				{
+					best = cost;
+					std::memcpy(out, scratch, bytes + 1);
+				}
+			}
+		}
+
+		void write(IWriter& writer, const void* data, std::size_t size)
+		{
+			if (writer.write(data, size) != size)
+			{
+				throw PngImageFormatException { u8"Failed to write png data." };
+			}
+		}
+
+		void writeChunk(IWriter& writer, const char (&type)[5], const UInt8* data, std::size_t size)
+		{
+			auto crc = ::crc32(0, reinterpret_cast<const Bytef*>(type), 4);
+
+			if (size > 0)
+			{
+				crc = ::crc32(crc, data, static_cast<uInt>(size));
+			}
+
+			const auto length = Endian::nativeToBig(static_cast<UInt32>(size));
+			const auto digest = Endian::nativeToBig(static_cast<UInt32>(crc));
+
+			write(writer, &length, 4);
+			write(writer, type, 4);
+
+			if (size > 0)
+			{
+				write(writer, data, size);
+			}
+
+			write(writer, &digest, 4);
+		}
+
+		// Writes the PNG whose strips are filtered and deflated in parallel.
+		//
+		// Every strip is a raw deflate stream primed with the window before it and
+		// ended by a sync flush, so their concatenation is one zlib stream whose
+		// Adler-32 is combined from the ones of the strips.
+		void writeStrips(ImageView image, IWriter& writer, const PngEncodeOptions& options, ThreadPool& pool)
+		{
+			const auto height = image.height();
+			const auto bytes  = static_cast<std::size_t>(image.width()) * pixelBytes;
+			const auto line   = bytes + 1;
+
+			// Filter the rows.
+			std::vector<UInt8> filtered(line * height);
+
+			pool.parallelFor(0, height, rowsPerTask(height, pool), [&](Int32 begin, Int32 end)
+			{
+				std::vector<UInt8> zeros(begin == 0 ? bytes : 0);
+				std::vector<UInt8> scratch(options.filter == PngFilter::adaptive ? line : 0);
+
+				for (Int32 y = begin; y < end; y++)
+				{
+					const auto row      = reinterpret_cast<const UInt8*>(image.row(y));
+					const auto previous = y > 0 ? reinterpret_cast<const UInt8*>(image.row(y - 1)) : zeros.data();
+					const auto out      = filtered.data() + line * y;
+
+					if (options.filter == PngFilter::adaptive)
+					{
+						filterAdaptive(row, previous, out, scratch.data(), bytes);
+					}
+					else
+					{
+						filterRow(options.filter, row, previous, out, bytes);
+					}
+				}
+			});
+
+			// Deflate the strips.
+			struct Strip
+			{
+				std::vector<UInt8> data;
+				uLong              adler;
+				std::size_t        size;
+			};
+
+			const auto level     = std::clamp(options.compressionLevel, 0, 9);
+			const auto numStrips = static_cast<Int32>(pool.numThreads() + 1) * 2;
+			const auto stripRows = (std::max)((height + numStrips - 1) / numStrips, 1);
+
+			std::vector<Strip> strips(static_cast<std::size_t>((height + stripRows - 1) / stripRows));
+
+			pool.parallelFor(0, static_cast<Int32>(strips.size()), 1, [&](Int32 begin, Int32 end)
+			{
+				for (Int32 s = begin; s < end; s++)
+				{
+					const bool first  = s == 0;
+					const bool last   = s + 1 == static_cast<Int32>(strips.size());
+					const auto offset = line * stripRows * s;
+					const auto size   = (std::min)(line * stripRows, filtered.size() - offset);
+					const auto input  = filtered.data() + offset;
+
+					::z_stream zs = {};
+
+					if (deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS, 8, zlibStrategy(options.strategy)) != Z_OK)
+					{
+						throw PngImageFormatException { u8"Failed to initialize zlib deflate stream." };
+					}
+
+					[[maybe_unused]] const auto _ = scopeExit([&]()
+					{
+						::deflateEnd(&zs);
+					});
+
+					if (!first)
+					{
+						const auto window = (std::min)(offset, windowBytes);
+
+						::deflateSetDictionary(&zs, input - window, static_cast<uInt>(window));
+					}
+
+					// Room for the zlib header, the sync flush and the Adler-32.
+					auto& data = strips[s].data;
+					data.resize(::deflateBound(&zs, static_cast<uLong>(size)) + 16);
+
+					const std::size_t headerBytes = first ? 2 : 0;
+
+					zs.next_in   = const_cast<Bytef*>(input); // Never rewrited.
+					zs.avail_in  = static_cast<uInt>(size);
+					zs.next_out  = data.data() + headerBytes;
+					zs.avail_out = static_cast<uInt>(data.size() - headerBytes - 4);
+
+					const auto flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+
+					auto result = ::deflate(&zs, flush);
+
+					// The flush may be incomplete when the output is full, so continue with more space.
+					while (result == Z_OK && zs.avail_out == 0)
+					{
+						const auto written = static_cast<std::size_t>(zs.next_out - data.data());
+
+						data.resize(data.size() * 2);
+
+						zs.next_out  = data.data() + written;
+						zs.avail_out = static_cast<uInt>(data.size() - written - 4);
+
+						result = ::deflate(&zs, flush);
+					}
+
+					if (result != (last ? Z_STREAM_END : Z_OK) || zs.avail_in != 0)
+					{
+						throw PngImageFormatException { u8"Failed to deflate data." };
+					}
+
+					data.resize(headerBytes + zs.total_out);
+
+					strips[s].adler = ::adler32(::adler32(0, nullptr, 0), input, static_cast<uInt>(size));
+					strips[s].size  = size;
+				}
+			});
+
+			// zlib header of 32KiB window and the level hint.
+			const UInt32 levelHint = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+			const UInt32 header    = (0x78 << 8) | (levelHint << 6);
+
+			strips.front().data[0] = static_cast<UInt8>(header >> 8);
+			strips.front().data[1] = static_cast<UInt8>((header | (31 - header % 31) % 31) & 0xff);
+
+			auto adler = strips.front().adler;
+
+			for (std::size_t s = 1; s < strips.size(); s++)
+			{
+				adler = ::adler32_combine(adler, strips[s].adler, static_cast<z_off_t>(strips[s].size));
+			}
+
+			auto& tail = strips.back().data;
+
+			for (Int32 shift = 24; shift >= 0; shift -= 8)
+			{
+				tail.push_back(static_cast<UInt8>(adler >> shift));
+			}
+
+			// Write the chunks.
+			constexpr UInt8 signature[8] =
+			{
+				0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a,
+			};
+
+			write(writer, signature, sizeof(signature));
+
+			const auto bigWidth  = Endian::nativeToBig(static_cast<UInt32>(image.width()));
+			const auto bigHeight = Endian::nativeToBig(static_cast<UInt32>(height));
+
+			UInt8 ihdr[13] =
+			{
+				0, 0, 0, 0,
+				0, 0, 0, 0,
+				8,                    // Bit depth.
+				PNG_COLOR_TYPE_RGBA,
+				0,                    // Compression method.
+				0,                    // Filter method.
+				PNG_INTERLACE_NONE,
+			};
+
+			std::memcpy(ihdr + 0, &bigWidth , 4);
+			std::memcpy(ihdr + 4, &bigHeight, 4);
+
+			writeChunk(writer, "IHDR", ihdr, sizeof(ihdr));
+
+			for (const auto& strip : strips)
+			{
+				writeChunk(writer, "IDAT", strip.data.data(), strip.data.size());
+			}
+
+			writeChunk(writer, "IEND", nullptr, 0);
+		}
+
+		void writePng(ImageView image, IWriter& writer, const PngEncodeOptions& options)
+		{
+			png_structp png  = nullptr;
+			png_infop   info = nullptr;
+
+			try
+			{
+				// Initialize libpng.
+				if (!(png = ::png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, error, warning)))
+				{
+					throw PngImageFormatException { u8"Failed to create png write struct." };
+				}
+
+				if (!(info = ::png_create_info_struct(png)))
+				{
+					throw PngImageFormatException { u8"Failed to cerate png info struct." };
+				}
+
+				// Set callback.
+				::png_set_write_fn(png, &writer, writeData, nullptr);
+
+				// Set compression.
+				::png_set_compression_level(png, std::clamp(options.compressionLevel, 0, 9));
+				::png_set_compression_strategy(png, zlibStrategy(options.strategy));
+				::png_set_filter(png, PNG_FILTER_TYPE_BASE, filterMask(options.filter));
+
+				// Set information header.
+				const auto width           = static_cast<png_uint_32>(image.width()  );
+				const auto height          = static_cast<png_uint_32>(image.height() );
+				const int  bitDepth        = 8;
+				const int  colorType       = PNG_COLOR_TYPE_RGBA;
+				const int  interlaceType   = PNG_INTERLACE_NONE;
+				const int  compressionType = PNG_COMPRESSION_TYPE_DEFAULT;
+				const int  filterType      = PNG_FILTER_TYPE_DEFAULT;
+
+				::png_set_IHDR(png, info, width, height, bitDepth, colorType, interlaceType, compressionType, filterType);
+
+				// Write information header.
+				::png_write_info(png, info);
+
+				// Write image data.
+				for (Int32 y = 0; y < image.height(); y++)
+				{
+					::png_write_row(png, reinterpret_cast<png_const_bytep>(image.row(y)));
+				}
+
+				::png_write_end(png, info);
+
+				// Release objects.
+				::png_destroy_write_struct(&png, &info);
+			}
+			catch (...)
+			{
+				// Release objects.
+				::png_destroy_write_struct(&png, &info);
+
+				throw;
+			}
+		}
+
+		// Arena for the libpng allocations reused by the images decoded one after another on a thread.
+		class PngMemory final
+			: private Uncopyable
+		{
+			static constexpr std::size_t chunkSize = 64 * 1024;
+			static constexpr std::size_t alignment = 16;
+
+			struct Chunk
+			{
+				std::unique_ptr<Byte[]> data;
+				std::size_t             size;
+			};
+
+			std::vector<Chunk> chunks_;
+			std::size_t        current_ = 0;
+			std::size_t        used_    = 0;
+			bool               inUse_   = false;
+
+		public:
+			// Row pointers reused by the whole image reads.
+			std::vector<::png_bytep> rows;
+
+			PngMemory() =default;
+
+			~PngMemory() =default;
+
+			// Returns the arena of the thread, or `nullptr` while it is in use.
+			[[nodiscard]]
+			static PngMemory* acquire() noexcept
+			{
+				thread_local PngMemory memory;
+
+				if (memory.inUse_)
+				{
+					return nullptr;
+				}
+
+				memory.inUse_ = true;
+
+				return &memory;
+			}
+
+			// Frees all the allocations at once.
+			void release() noexcept
+			{
+				current_ = 0;
+				used_    = 0;
+				inUse_   = false;
+			}
+
+			void* allocate(std::size_t size)
+			{
+				size = (size + alignment - 1) & ~(alignment - 1);
+
+				for (; current_ < chunks_.size(); current_++, used_ = 0)
+				{
+					if (used_ + size <= chunks_[current_].size)
+					{
+						const auto p = chunks_[current_].data.get() + used_;
+						used_ += size;
+
+						return p;
+					}
+				}
+
+				// Allocate a new chunk.
+				const auto chunk = (std::max)(size, chunkSize);
+
+				chunks_.push_back({ std::make_unique<Byte[]>(chunk), chunk });
+				used_ = size;
+
+				return chunks_.back().data.get();
+			}
+		};
+
+		::png_voidp allocate(::png_structp png, ::png_alloc_size_t size)
+		{
+			try
+			{
+				return static_cast<PngMemory*>(::png_get_mem_ptr(png))->allocate(size);
+			}
+			catch (const std::bad_alloc&)
+			{
+				return nullptr;
+			}
+		}
+
+		void deallocate([[maybe_unused]] ::png_structp png, [[maybe_unused]] ::png_voidp p)
+		{
+			// Released with the arena.
+		}
+
+		class PngDecoder final
+			: public  IImageDecoder
+			, private Uncopyable
+		{
+			png_structp png_    = nullptr;
+			png_infop   info_   = nullptr;
+			PngMemory*  memory_ = nullptr;
+
+			ImageInfo   imageInfo_ = {};
+			PixelFormat format_    = PixelFormat::rgba8;
+			Int32       row_       = 0;
+
+			// Interlaced images are decoded whole by the first read.
+			std::optional<Image> buffer_;
+
+			void initialize(IReader& reader, bool native)
+			{
+				// Initialize libpng.
+				png_ = memory_
+					? ::png_create_read_struct_2(PNG_LIBPNG_VER_STRING, nullptr, error, warning, memory_, allocate, deallocate)
+					: ::png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, error, warning);
+
+				if (!png_)
+				{
+					throw PngImageFormatException { u8"Failed to create png read struct." };
+				}
+
+				if (!(info_ = ::png_create_info_struct(png_)))
+				{
+					throw PngImageFormatException { u8"Failed to cerate png info struct." };
+				}
+
+				// Set callback.
+				::png_set_read_fn(png_, &reader, readData);
+
+				// Read information header.
+				::png_read_info(png_, info_);
+
+				png_uint_32 width, height;
+				int bitDepth, colorType, interlaceType;
+
+				::png_get_IHDR(png_, info_, &width, &height, &bitDepth, &colorType, &interlaceType, nullptr, nullptr);
+
+				// Choose the output pixel format.
+				const bool gray     = colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA;
+				const bool hasAlpha = (colorType & PNG_COLOR_MASK_ALPHA) || ::png_get_valid(png_, info_, PNG_INFO_tRNS);
+
+				imageInfo_ =
+				{
+					Size2Di { static_cast<Int32>(width), static_cast<Int32>(height) },
+					static_cast<Int32>(::png_get_channels(png_, info_)),
+					bitDepth,
+					hasAlpha,
+					interlaceType != PNG_INTERLACE_NONE,
+				};
+
+				if (native && gray)
+				{
+					format_ = hasAlpha ? PixelFormat::rg8 : bitDepth == 16 ? PixelFormat::r16 : PixelFormat::r8;
+				}
+
+				// Expand element into 8bit.
+				::png_set_packing(png_);
+
+				if (colorType == PNG_COLOR_TYPE_PALETTE)
+				{
+					// Convert palette image into rgb image.
+					::png_set_palette_to_rgb(png_);
+				}
+
+				if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8)
+				{
+					// Convert (1/2/4)bit gray scale image into 8bit gray scale image.
+					::png_set_expand_gray_1_2_4_to_8(png_);
+				}
+
+				if (::png_get_valid(png_, info_, PNG_INFO_tRNS))
+				{
+					// Convert tRNS chunk into alpha channel.
+					::png_set_tRNS_to_alpha(png_);
+				}
+
+				if (bitDepth == 16)
+				{
+					if (format_ == PixelFormat::r16)
+					{
+#if defined(NENE_LITTLE_ENDIAN)
+						// Convert big endian element into native byte order.
+						::png_set_swap(png_);
+#endif
+					}
+					else
+					{
+						// Narrow element into 8bit.
+						::png_set_scale_16(png_);
+					}
+				}
+
+				if (gray && format_ == PixelFormat::rgba8)
+				{
+					// Convert gray scale into rgb.
+					::png_set_gray_to_rgb(png_);
+				}
+
+				if (interlaceType != PNG_INTERLACE_NONE)
+				{
+					// Handling image interlace.
+					::png_set_interlace_handling(png_);
+				}
+
+				if (format_ == PixelFormat::rgba8)
+				{
+					// Add alpha.
+					::png_set_add_alpha(png_, 0xff, PNG_FILLER_AFTER);
+				}
+
+				// Set gamma.
+				double gamma;
+
+				if (::png_get_gAMA(png_, info_, &gamma))
+				{
+					// Windows screen gamma.
+					constexpr double screenGamma = 2.2;
+
+					::png_set_gamma(png_, screenGamma, gamma);
+				}
+
+				// Update information.
+				::png_read_update_info(png_, info_);
+			}
+
+			void destroy() noexcept
+			{
+				// Release objects.
+				::png_destroy_read_struct(&png_, &info_, nullptr);
+
+				if (memory_)
+				{
+					memory_->release();
+				}
+			}
+
+		public:
+			// `memory` is released with the decoder.
+			explicit PngDecoder(IReader& reader, bool native, PngMemory* memory = nullptr)
+				: memory_(memory)
+			{
+				try
+				{
+					initialize(reader, native);
+				}
+				catch (...)
+				{
+					destroy();
+
+					throw;
+				}
+			}
+
+			~PngDecoder()
+			{
+				destroy();
+			}
+
+			[[nodiscard]]
+			PixelFormat format() const noexcept
+			{
+				return format_;
+			}
+
+			[[nodiscard]]
+			const ImageInfo& info() const noexcept override
+			{
+				return imageInfo_;
+			}
+
+			[[nodiscard]]
+			Int32 currentRow() const noexcept override
+			{
+				return row_;
+			}
+
+			// Reads all the rows at once.
+			template <typename Pixel>
+			void readImage(BasicMutableImageView<Pixel> image)
+			{
+				assert(row_ == 0);
+
+				std::vector<::png_bytep> local;
+				auto& rows = memory_ ? memory_->rows : local;
+
+				// Create list of row pointers.
+				rows.resize(image.height());
+
+				for (Int32 y = 0; y < image.height(); y++)
+				{
+					rows[y] = reinterpret_cast<::png_bytep>(image.row(y));
+				}
+
+				::png_read_image(png_, rows.data());
+				::png_read_end(png_, info_);
+
+				row_ = image.height();
+			}
+
+			Int32 readRows(MutableImageView rows) override
+			{
+				assert(format_ == PixelFormat::rgba8);
+				assert(rows.width() == imageInfo_.size.width);
+
+				const auto count = (std::min)(rows.height(), imageInfo_.size.height - row_);
+
+				if (imageInfo_.interlaced)
+				{
+					if (!buffer_)
+					{
+						readImage(buffer_.emplace(imageInfo_.size).mutableView());
+						row_ = 0;
+					}
+
+					rows.rows(0, count).copyFrom(buffer_->view().rows(row_, count));
+				}
+				else
+				{
+					for (Int32 y = 0; y < count; y++)
+					{
+						::png_read_row(png_, reinterpret_cast<png_bytep>(rows.row(y)), nullptr);
+					}
+
+					if (count > 0 && row_ + count == imageInfo_.size.height)
+					{
+						::png_read_end(png_, info_);
+					}
+				}
+
+				row_ += count;
+
+				return count;
+			}
+		};
+
+		AnyImage readPng(IReader& reader, bool native)
+		{
+			PngDecoder decoder { reader, native, PngMemory::acquire() };
+
+			const auto read = [&](auto image) -> AnyImage
+			{
+				decoder.readImage(image.mutableView());
+
+				return image;
+			};
+
+			const auto size = decoder.info().size;
+
+			switch (decoder.format())
+			{
+				case PixelFormat::r8 : return read(ImageR8  { size });
+				case PixelFormat::rg8: return read(ImageRG8 { size });
+				case PixelFormat::r16: return read(ImageR16 { size });
+				default              : return read(Image    { size });
+			}
+		}
 	}
 
 	PngImageFormat::PngImageFormat(std::string_view name)
@@ -90,174 +851,144 @@ namespace Nene
 		return std::memcmp(header.data(), signature, sizeof(signature)) == 0;
 	}
 
-	Image PngImageFormat::decode(IReader& reader)
+	ImageInfo PngImageFormat::probe(IReader& reader)
 	{
-		png_structp png  = nullptr;
-		png_infop   info = nullptr;
+		const auto position = reader.position();
 
-		// Release objects.
 		[[maybe_unused]] const auto _ = scopeExit([&]()
 		{
-			::png_destroy_read_struct(&png, &info, nullptr);
+			reader.position(position);
 		});
 
-		// Initialize libpng.
-		if (!(png = ::png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, error, warning)))
-		{
-			throw PngImageFormatException { u8"Failed to create png read struct." };
-		}
+		std::array<Byte, 16> signature = {};
 
-		if (!(info = ::png_create_info_struct(png)))
+		if (reader.read(signature.data(), 8) != 8 || !isImageHeader(signature))
 		{
-			throw PngImageFormatException { u8"Failed to cerate png info struct." };
+			throw PngImageFormatException { u8"Invalid PNG signature." };
 		}
 
-		// Set callback.
-		::png_set_read_fn(png, &reader, readData);
-
-		// Read information header.
-		::png_read_info(png, info);
-
-		png_uint_32 width, height;
-		int bitDepth, colorType, interlaceType;
-
-		::png_get_IHDR(png, info, &width, &height, &bitDepth, &colorType, &interlaceType, nullptr, nullptr);
+		Serialization::BinaryDeserializer archive { reader, Endian::Order::big };
 
-		// Expand element into 8bit.
-		::png_set_packing(png);
+		// Read IHDR chunk.
+		UInt32 length, type;
+		archive.serialize(length).serialize(type);
 
-		if (colorType == PNG_COLOR_TYPE_PALETTE)
+		if (type != chunkType("IHDR") || length != 13)
 		{
-			// Convert palette image into rgb image.
-			::png_set_palette_to_rgb(png);
+			throw PngImageFormatException { u8"Invalid PNG header." };
 		}
 
-		if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8)
-		{
-			// Convert (1/2/4)bit gray scale image into 8bit gray scale image.
-			::png_set_expand_gray_1_2_4_to_8(png);
-		}
+		UInt32 width, height;
+		UInt8  bitDepth, colorType, compressionType, filterType, interlaceType;
 
-		if (::png_get_valid(png, info, PNG_INFO_tRNS))
-		{
-			// Convert tRNS chunk into alpha channel.
-			::png_set_tRNS_to_alpha(png);
-		}
+		archive
+			.serialize(width)
+			.serialize(height)
+			.serialize(bitDepth)
+			.serialize(colorType)
+			.serialize(compressionType)
+			.serialize(filterType)
+			.serialize(interlaceType)
+		;
 
-		if (bitDepth == 16)
-		{
-			// Narrow element into 8bit.
-			::png_set_scale_16(png);
-		}
+		// Skip CRC.
+		reader.position(reader.position() + 4);
 
-		if (colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
-		{
-			// Convert gray scale into rgb.
-			::png_set_gray_to_rgb(png);
-		}
+		// tRNS chunk precedes the image data.
+		bool hasAlpha = (colorType & PNG_COLOR_MASK_ALPHA) != 0;
 
-		if (interlaceType != PNG_INTERLACE_NONE)
+		while (!hasAlpha)
 		{
-			// Handling image interlace.
-			::png_set_interlace_handling(png);
-		}
-
-		// Add alpha.
-		::png_set_add_alpha(png, 0xff, PNG_FILLER_AFTER);
+			archive.serialize(length).serialize(type);
 
-		// Set gamma.
-		double gamma;
+			if (type == chunkType("IDAT") || type == chunkType("IEND"))
+			{
+				break;
+			}
 
-		if (::png_get_gAMA(png, info, &gamma))
-		{
-			// Windows screen gamma.
-			constexpr double screenGamma = 2.2;
+			hasAlpha = type == chunkType("tRNS");
 
-			::png_set_gamma(png, screenGamma, gamma);
+			reader.position(reader.position() + length + 4);
 		}
 
-		// Update information.
-		::png_read_update_info(png, info);
-
-		// Create image buffer.
-		Image image { static_cast<Int32>(width), static_cast<Int32>(height) };
+		Int32 channels;
 
-		// Create list of row pointers.
-		std::vector<::png_bytep> rows(height);
-
-		for (png_uint_32 i = 0; i < height; i++)
+		switch (colorType)
 		{
-			rows[i] = reinterpret_cast<png_bytep>(image.dataBytes()) + i * width * sizeof(Color4);
+			case PNG_COLOR_TYPE_GRAY      : channels = 1; break;
+			case PNG_COLOR_TYPE_GRAY_ALPHA: channels = 2; break;
+			case PNG_COLOR_TYPE_RGB       : channels = 3; break;
+			case PNG_COLOR_TYPE_RGB_ALPHA : channels = 4; break;
+			case PNG_COLOR_TYPE_PALETTE   : channels = 1; break;
+			default: throw PngImageFormatException { u8"Invalid PNG color type." };
 		}
 
-		::png_read_image(png, rows.data());
-		::png_read_end(png, info);
-
-		return image;
+		return
+		{
+			Size2Di { static_cast<Int32>(width), static_cast<Int32>(height) },
+			channels,
+			bitDepth,
+			hasAlpha,
+			interlaceType != PNG_INTERLACE_NONE,
+		};
 	}
 
-	void PngImageFormat::encode(const Image& image, IWriter& writer)
+	Image PngImageFormat::decode(IReader& reader)
 	{
-		png_structp png  = nullptr;
-		png_infop   info = nullptr;
-
-		try
-		{
-			// Initialize libpng.
-			if (!(png = ::png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, error, warning)))
-			{
-				throw PngImageFormatException { u8"Failed to create png write struct." };
-			}
-
-			if (!(info = ::png_create_info_struct(png)))
-			{
-				throw PngImageFormatException { u8"Failed to cerate png info struct." };
-			}
-
-			// Set callback.
-			::png_set_write_fn(png, &writer, writeData, nullptr);
-
+		return std::get<Image>(readPng(reader, false));
+	}
 
-			// Set information header.
-			const auto width           = static_cast<png_uint_32>(image.width()  );
-			const auto height          = static_cast<png_uint_32>(image.height() );
-			const int  bitDepth        = 8;
-			const int  colorType       = PNG_COLOR_TYPE_RGBA;
-			const int  interlaceType   = PNG_INTERLACE_NONE;
-			const int  compressionType = PNG_COMPRESSION_TYPE_DEFAULT;
-			const int  filterType      = PNG_FILTER_TYPE_DEFAULT;
+	AnyImage PngImageFormat::decodeNative(IReader& reader)
+	{
+		return readPng(reader, true);
+	}
 
-			::png_set_IHDR(png, info, width, height, bitDepth, colorType, interlaceType, compressionType, filterType);
+	void PngImageFormat::decodeInto(IReader& reader, MutableImageView image)
+	{
+		PngDecoder decoder { reader, false, PngMemory::acquire() };
 
-			// Write information header.
-			::png_write_info(png, info);
+		if (decoder.info().size != image.size())
+		{
+			throw PngImageFormatException { u8"Image size mismatch." };
+		}
 
-			// Write image data.
-			png_const_bytep data = reinterpret_cast<png_const_bytep>(image.dataBytes());
+		decoder.readImage(image);
+	}
 
-			for (png_uint_32 y = 0; y < height; y++)
-			{
-				::png_write_row(png, data);
+	std::unique_ptr<IImageDecoder> PngImageFormat::createDecoder(IReader& reader)
+	{
+		return std::make_unique<PngDecoder>(reader, false);
+	}
 
-				data += width * sizeof(Color4);
-			}
+	void PngImageFormat::encode(ImageView image, IWriter& writer)
+	{
+		encode(image, writer, PngEncodeOptions {});
+	}
 
-			::png_write_end(png, info);
+	void PngImageFormat::encode(ImageView image, IWriter& writer, [[maybe_unused]] Int32 quality)
+	{
+		encode(image, writer);
+	}
 
-			// Release objects.
-			::png_destroy_write_struct(&png, &info);
-		}
-		catch (...)
+	void PngImageFormat::encode(ImageView image, IWriter& writer, const PngEncodeOptions& options)
+	{
+		if (options.parallel)
 		{
-			// Release objects.
-			::png_destroy_write_struct(&png, &info);
-
-			throw;
+			encode(image, writer, options, ThreadPool::shared());
+			return;
 		}
+
+		writePng(image, writer, options);
 	}
 
-	void PngImageFormat::encode(const Image& image, IWriter& writer, [[maybe_unused]] Int32 quality)
+	void PngImageFormat::encode(ImageView image, IWriter& writer, const PngEncodeOptions& options, ThreadPool& pool)
 	{
-		encode(image, writer);
+		if (options.parallel && image.height() > 0)
+		{
+			writeStrips(image, writer, options, pool);
+			return;
+		}
+
+		writePng(image, writer, options);
 	}
 }
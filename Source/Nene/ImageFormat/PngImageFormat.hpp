@@ -30,6 +30,61 @@
 
 namespace Nene
 {
+	// Forward declarations.
+	class ThreadPool;
+
+	/**
+	 * @brief      PNG row filters.
+	 */
+	enum class PngFilter: Int32
+	{
+		none,
+		sub,
+		up,
+		average,
+		paeth,
+		adaptive,
+	};
+
+	/**
+	 * @brief      zlib compression strategies.
+	 */
+	enum class PngStrategy: Int32
+	{
+		normal,
+		filtered,
+		huffmanOnly,
+		rle,
+		fixed,
+	};
+
+	/**
+	 * @brief      PNG encoding options.
+	 */
+	class PngEncodeOptions
+	{
+	public:
+		/**
+		 * @brief      The zlib compression level from `0` to `9`.
+		 */
+		Int32 compressionLevel = 6;
+
+		/**
+		 * @brief      The zlib compression strategy.
+		 */
+		PngStrategy strategy = PngStrategy::filtered;
+
+		/**
+		 * @brief      The row filter, or `PngFilter::adaptive` to choose per row.
+		 */
+		PngFilter filter = PngFilter::adaptive;
+
+		/**
+		 * @brief      `true` to filter and deflate horizontal strips in parallel.
+		 */
+		bool parallel = false;
+	};
+
 	/**
 	 * @brief      PNG image format.
 	 */
@@ -70,21 +125,65 @@ namespace Nene
 		[[nodiscard]]
 		bool isImageHeader(const std::array<Byte, 16>& header) const noexcept override;
 
+		/**
+		 * @see        `Nene::IImageFormat::probe()`.
+		 */
+		[[nodiscard]]
+		ImageInfo probe(IReader& reader) override;
+
 		/**
 		 * @see        `Nene::IImageFormat::decode()`.
 		 */
 		[[nodiscard]]
 		Image decode(IReader& reader) override;
 
+		/**
+		 * @see        `Nene::IImageFormat::decodeNative()`.
+		 */
+		[[nodiscard]]
+		AnyImage decodeNative(IReader& reader) override;
+
+		/**
+		 * @see        `Nene::IImageFormat::decodeInto()`.
+		 */
+		void decodeInto(IReader& reader, MutableImageView image) override;
+
+		/**
+		 * @see        `Nene::IImageFormat::createDecoder()`.
+		 */
+		[[nodiscard]]
+		std::unique_ptr<IImageDecoder> createDecoder(IReader& reader) override;
+
 		/**
 		 * @see        `Nene::IImageFormat::encode()`.
 		 */
-		void encode(const Image& image, IWriter& writer) override;
+		void encode(ImageView image, IWriter& writer) override;
 
 		/**
 		 * @see        `Nene::IImageFormat::encode()`.
 		 */
-		void encode(const Image& image, IWriter& writer, Int32 quality) override;
+		void encode(ImageView image, IWriter& writer, Int32 quality) override;
+
+		/**
+		 * @brief      Writes a image to a writer.
+		 *
+		 * @param[in]  image    The image data to write.
+		 * @param      writer   The image data writer.
+		 * @param[in]  options  The encoding options.
+		 */
+		void encode(ImageView image, IWriter& writer, const PngEncodeOptions& options);
+
+		/**
+		 * @brief      Writes a image to a writer.
+		 *
+		 *             The strips are compressed on `pool` if `options.parallel` is `true`.
+		 *
+		 * @param[in]  image    The image data to write.
+		 * @param      writer   The image data writer.
+		 * @param[in]  options  The encoding options.
+		 * @param      pool     The thread pool.
+		 */
+		void encode(ImageView image, IWriter& writer, const PngEncodeOptions& options, ThreadPool& pool);
 	};
 }
 
@@ -0,0 +1,526 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <vector>
+#include "QoiImageFormat.hpp"
+#include "QoiImageFormatException.hpp"
+#include "../Scope.hpp"
+#include "../Uncopyable.hpp"
+#include "../Reader/IReader.hpp"
+#include "../Serialization/BinaryDeserializer.hpp"
+#include "../Writer/IWriter.hpp"
+
+namespace Nene
+{
+	namespace
+	{
+		constexpr std::size_t headerSize  = 14;
+		constexpr std::size_t paddingSize = 8;
+
+		// The format limits the images to 400 million pixels.
+		constexpr UInt64 maxPixels = 400'000'000;
+
+		constexpr UInt8 opIndex = 0x00;
+		constexpr UInt8 opDiff  = 0x40;
+		constexpr UInt8 opLuma  = 0x80;
+		constexpr UInt8 opRun   = 0xc0;
+		constexpr UInt8 opRgb   = 0xfe;
+		constexpr UInt8 opRgba  = 0xff;
+
+		constexpr UInt8 padding[paddingSize] =
+		{
+			0, 0, 0, 0, 0, 0, 0, 1,
+		};
+
+		struct QoiHeader
+		{
+			UInt32 magic;
+			UInt32 width;
+			UInt32 height;
+			UInt8  channels;
+			UInt8  colorSpace;
+		};
+
+		void load(Serialization::BinaryDeserializer& archive, QoiHeader& header)
+		{
+			archive
+				.serialize(header.magic)
+				.serialize(header.width)
+				.serialize(header.height)
+				.serialize(header.channels)
+				.serialize(header.colorSpace)
+			;
+		}
+
+		// "qoif"
+		constexpr UInt32 magic = 0x716f6966;
+
+		[[nodiscard]]
+		constexpr std::size_t hash(const Color4& c) noexcept
+		{
+			return (c.red * 3 + c.green * 5 + c.blue * 7 + c.alpha * 11) & 63;
+		}
+
+		[[nodiscard]]
+		constexpr bool equals(const Color4& a, const Color4& b) noexcept
+		{
+			return a.red == b.red && a.green == b.green && a.blue == b.blue && a.alpha == b.alpha;
+		}
+
+		[[nodiscard]]
+		QoiHeader readHeader(IReader& reader)
+		{
+			Serialization::BinaryDeserializer archive { reader, Endian::Order::big };
+
+			QoiHeader header;
+			archive.serialize(header);
+
+			if (header.magic != magic)
+			{
+				throw QoiImageFormatException { u8"Unknown QOI file format." };
+			}
+
+			if (header.width == 0 || header.height == 0 || UInt64 { header.width } * header.height > maxPixels)
+			{
+				throw QoiImageFormatException { u8"Invalid QOI image size." };
+			}
+
+			if ((header.channels != 3 && header.channels != 4) || header.colorSpace > 1)
+			{
+				throw QoiImageFormatException { u8"Invalid QOI image format." };
+			}
+
+			return header;
+		}
+
+		[[nodiscard]]
+		ImageInfo imageInfo(const QoiHeader& header) noexcept
+		{
+			return
+			{
+				Size2Di { static_cast<Int32>(header.width), static_cast<Int32>(header.height) },
+				header.channels,
+				8,
+				header.channels == 4,
+				false,
+			};
+		}
+
+		// Compressed data buffer reused by the images on the thread.
+		std::vector<UInt8>& threadBuffer() noexcept
+		{
+			thread_local std::vector<UInt8> buffer;
+
+			return buffer;
+		}
+
+		class QoiDecoder final
+			: public  IImageDecoder
+			, private Uncopyable
+		{
+			ImageInfo               info_;
+			Int32                   row_;
+			std::vector<UInt8>      own_;
+			std::vector<UInt8>&     data_;
+			std::size_t             position_;
+			std::size_t             end_;
+			Color4                  pixel_;
+			UInt32                  run_;
+			std::array<Color4, 64>  index_;
+
+		public:
+			// `scratch` is used instead of the own buffer if given.
+			explicit QoiDecoder(IReader& reader, std::vector<UInt8>* scratch = nullptr)
+				: info_(imageInfo(readHeader(reader)))
+				, row_(0)
+				, own_()
+				, data_(scratch ? *scratch : own_)
+				, position_(0)
+				, end_(0)
+				, pixel_(0, 0, 0, 255)
+				, run_(0)
+				, index_()
+			{
+				// Read all the chunks at once.
+				const auto size = reader.size() - reader.position();
+
+				data_.resize(size);
+
+				if (reader.read(data_.data(), size) != size || size < paddingSize)
+				{
+					throw QoiImageFormatException { u8"Unexpected end of QOI data." };
+				}
+
+				// The padding lets the operations read ahead without checks.
+				end_ = size - paddingSize;
+
+				index_.fill(Color4 { 0, 0, 0, 0 });
+			}
+
+			~QoiDecoder() =default;
+
+			[[nodiscard]]
+			const ImageInfo& info() const noexcept override
+			{
+				return info_;
+			}
+
+			[[nodiscard]]
+			Int32 currentRow() const noexcept override
+			{
+				return row_;
+			}
+
+			Int32 readRows(MutableImageView rows) override
+			{
+				assert(rows.width() == info_.size.width);
+
+				const auto width = info_.size.width;
+				const auto count = (std::min)(rows.height(), info_.size.height - row_);
+				const auto p     = data_.data();
+
+				auto pos   = position_;
+				auto pixel = pixel_;
+				auto run   = run_;
+
+				for (Int32 y = 0; y < count; y++)
+				{
+					const auto row = rows.row(y);
+
+					for (Int32 x = 0; x < width; )
+					{
+						if (run > 0)
+						{
+							// Fill the run.
+							const auto n = static_cast<Int32>((std::min)(run, static_cast<UInt32>(width - x)));
+
+							std::fill_n(row + x, n, pixel);
+
+							x   += n;
+							run -= n;
+							continue;
+						}
+
+						if (pos >= end_)
+						{
+							throw QoiImageFormatException { u8"Unexpected end of QOI data." };
+						}
+
+						const UInt8 b1 = p[pos++];
+
+						if (b1 == opRgb)
+						{
+							pixel.red   = p[pos + 0];
+							pixel.green = p[pos + 1];
+							pixel.blue  = p[pos + 2];
+							pos += 3;
+						}
+						else if (b1 == opRgba)
+						{
+							pixel.red   = p[pos + 0];
+							pixel.green = p[pos + 1];
+							pixel.blue  = p[pos + 2];
+							pixel.alpha = p[pos + 3];
+							pos += 4;
+						}
+						else
+						{
+							switch (b1 & 0xc0)
+							{
+								case opIndex:
+									pixel = index_[b1];
+									row[x++] = pixel;
+									continue;
+
+								case opDiff:
+									pixel.red   += ((b1 >> 4) & 0x03) - 2;
+									pixel.green += ((b1 >> 2) & 0x03) - 2;
+									pixel.blue  += ( b1       & 0x03) - 2;
+									break;
+
+								case opLuma:
+								{
+									const Int32 dg = (b1 & 0x3f) - 32;
+									const UInt8 b2 = p[pos++];
+
+									pixel.red   += dg - 8 + ((b2 >> 4) & 0x0f);
+									pixel.green += dg;
+									pixel.blue  += dg - 8 + ( b2       & 0x0f);
+									break;
+								}
+
+								default:
+									// The reference decoder indexes the pixel after runs too.
+									run = (b1 & 0x3f) + 1;
+									index_[hash(pixel)] = pixel;
+									continue;
+							}
+						}
+
+						index_[hash(pixel)] = pixel;
+						row[x++] = pixel;
+					}
+				}
+
+				position_ = pos;
+				pixel_    = pixel;
+				run_      = run;
+				row_     += count;
+
+				return count;
+			}
+		};
+
+		class QoiEncoder final
+			: private Uncopyable
+		{
+			std::vector<UInt8>&    out_;
+			Color4                 previous_;
+			UInt32                 run_;
+			std::array<Color4, 64> index_;
+
+			void flushRun()
+			{
+				if (run_ > 0)
+				{
+					out_.push_back(static_cast<UInt8>(opRun | (run_ - 1)));
+					run_ = 0;
+				}
+			}
+
+		public:
+			explicit QoiEncoder(std::vector<UInt8>& out)
+				: out_(out)
+				, previous_(0, 0, 0, 255)
+				, run_(0)
+				, index_()
+			{
+				index_.fill(Color4 { 0, 0, 0, 0 });
+			}
+
+			~QoiEncoder() =default;
+
+			void encode(const Color4* pixels, std::size_t count)
+			{
+				for (std::size_t i = 0; i < count; i++)
+				{
+					const auto& pixel = pixels[i];
+
+					if (equals(pixel, previous_))
+					{
+						if (++run_ == 62)
+						{
+							flushRun();
+						}
+						continue;
+					}
+
+					flushRun();
+
+					const auto h = hash(pixel);
+
+					if (equals(index_[h], pixel))
+					{
+						out_.push_back(static_cast<UInt8>(opIndex | h));
+					}
+					else
+					{
+						index_[h] = pixel;
+
+						if (pixel.alpha == previous_.alpha)
+						{
+							const auto dr = static_cast<Int8>(pixel.red   - previous_.red  );
+							const auto dg = static_cast<Int8>(pixel.green - previous_.green);
+							const auto db = static_cast<Int8>(pixel.blue  - previous_.blue );
+
+							const auto dgr = dr - dg;
+							const auto dgb = db - dg;
+
+							if (-2 <= dr && dr <= 1 && -2 <= dg && dg <= 1 && -2 <= db && db <= 1)
+							{
+								out_.push_back(static_cast<UInt8>(opDiff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+							}
+							else if (-32 <= dg && dg <= 31 && -8 <= dgr && dgr <= 7 && -8 <= dgb && dgb <= 7)
+							{
+								out_.push_back(static_cast<UInt8>(opLuma | (dg + 32)));
+								out_.push_back(static_cast<UInt8>((dgr + 8) << 4 | (dgb + 8)));
+							}
+							else
+							{
+								out_.insert(out_.end(), { opRgb, pixel.red, pixel.green, pixel.blue });
+							}
+						}
+						else
+						{
+							out_.insert(out_.end(), { opRgba, pixel.red, pixel.green, pixel.blue, pixel.alpha });
+						}
+					}
+
+					previous_ = pixel;
+				}
+			}
+
+			void finish()
+			{
+				flushRun();
+
+				out_.insert(out_.end(), std::begin(padding), std::end(padding));
+			}
+		};
+	}
+
+	QoiImageFormat::QoiImageFormat(std::string_view name)
+		: name_(name) {}
+
+	const std::string& QoiImageFormat::name() const noexcept
+	{
+		return name_;
+	}
+
+	ArrayView<IImageFormat::path_type> QoiImageFormat::possibleExtensions() const noexcept
+	{
+		static const path_type extensions[] =
+		{
+			".qoi",
+		};
+
+		return extensions;
+	}
+
+	bool QoiImageFormat::isImageHeader(const std::array<Byte, 16>& header) const noexcept
+	{
+		constexpr Byte signature[4] =
+		{
+			byte(0x71), byte(0x6f), byte(0x69), byte(0x66),
+		};
+
+		const auto channels   = static_cast<UInt8>(header[12]);
+		const auto colorSpace = static_cast<UInt8>(header[13]);
+
+		return std::memcmp(header.data(), signature, sizeof(signature)) == 0
+			&& (channels == 3 || channels == 4)
+			&& colorSpace <= 1;
+	}
+
+	ImageInfo QoiImageFormat::probe(IReader& reader)
+	{
+		const auto position = reader.position();
+
+		[[maybe_unused]] const auto _ = scopeExit([&]()
+		{
+			reader.position(position);
+		});
+
+		return imageInfo(readHeader(reader));
+	}
+
+	Image QoiImageFormat::decode(IReader& reader)
+	{
+		QoiDecoder decoder { reader, &threadBuffer() };
+
+		Image image { decoder.info().size };
+		decoder.readRows(image.mutableView());
+
+		return image;
+	}
+
+	void QoiImageFormat::decodeInto(IReader& reader, MutableImageView image)
+	{
+		QoiDecoder decoder { reader, &threadBuffer() };
+
+		if (decoder.info().size != image.size())
+		{
+			throw QoiImageFormatException { u8"Image size mismatch." };
+		}
+
+		decoder.readRows(image);
+	}
+
+	std::unique_ptr<IImageDecoder> QoiImageFormat::createDecoder(IReader& reader)
+	{
+		return std::make_unique<QoiDecoder>(reader);
+	}
+
+	void QoiImageFormat::encode(ImageView image, IWriter& writer)
+	{
+		const auto width  = static_cast<std::size_t>(image.width());
+		const auto height = static_cast<std::size_t>(image.height());
+
+		if (width == 0 || height == 0 || UInt64 { width } * height > maxPixels)
+		{
+			throw QoiImageFormatException { u8"Invalid QOI image size." };
+		}
+
+		// The channels are informative; opaque images are tagged as RGB.
+		bool opaque = true;
+
+		for (Int32 y = 0; y < image.height() && opaque; y++)
+		{
+			const auto row = image.row(y);
+
+			opaque = std::all_of(row, row + width, [](const Color4& c) { return c.alpha == 255; });
+		}
+
+		auto& out = threadBuffer();
+		out.clear();
+		out.reserve(headerSize + width * height * 4 / 2 + paddingSize);
+
+		// Write header.
+		const UInt32 fields[3] = { magic, static_cast<UInt32>(width), static_cast<UInt32>(height) };
+
+		for (const auto field : fields)
+		{
+			for (Int32 shift = 24; shift >= 0; shift -= 8)
+			{
+				out.push_back(static_cast<UInt8>(field >> shift));
+			}
+		}
+
+		out.push_back(opaque ? 3 : 4);
+		out.push_back(0); // sRGB with linear alpha.
+
+		// Write chunks.
+		QoiEncoder encoder { out };
+
+		for (Int32 y = 0; y < image.height(); y++)
+		{
+			encoder.encode(image.row(y), width);
+		}
+
+		encoder.finish();
+
+		if (writer.write(out.data(), out.size()) != out.size())
+		{
+			throw QoiImageFormatException { u8"Failed to write QOI data." };
+		}
+	}
+
+	void QoiImageFormat::encode(ImageView image, IWriter& writer, [[maybe_unused]] Int32 quality)
+	{
+		encode(image, writer);
+	}
+}
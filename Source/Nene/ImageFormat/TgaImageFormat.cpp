@@ -0,0 +1,763 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+#include "TgaImageFormat.hpp"
+#include "TgaImageFormatException.hpp"
+#include "../Platform.hpp"
+#include "../Scope.hpp"
+#include "../ImageProcessing/Convert.hpp"
+#include "../Reader/IReader.hpp"
+#include "../Serialization/BinaryDeserializer.hpp"
+#include "../Writer/IWriter.hpp"
+
+#if defined(NENE_SIMD_SSE2)
+#  include <emmintrin.h>
+#endif
+
+#if defined(NENE_SIMD_SSSE3)
+#  include <tmmintrin.h>
+#endif
+
+namespace Nene
+{
+	namespace
+	{
+		constexpr std::size_t headerSize = 18;
+
+		// Encoded data is written in batches of this size.
+		constexpr std::size_t batchBytes = 64 * 1024;
+
+		// Packets hold up to 128 pixels.
+		constexpr Int32 maxPacketPixels = 128;
+
+		// Image descriptor flags.
+		constexpr UInt8 descriptorAlphaBits   = 0x0f;
+		constexpr UInt8 descriptorRightToLeft = 0x10;
+		constexpr UInt8 descriptorTopToBottom = 0x20;
+
+		constexpr char footerSignature[18] = "TRUEVISION-XFILE.";
+
+		enum class TgaImageType: UInt8
+		{
+			none           = 0,
+			colorMapped    = 1,
+			trueColor      = 2,
+			grayScale      = 3,
+			rleColorMapped = 9,
+			rleTrueColor   = 10,
+			rleGrayScale   = 11,
+		};
+
+		struct TgaHeader
+		{
+			UInt8  idLength;
+			UInt8  colorMapType;
+			UInt8  imageType;
+			UInt16 colorMapFirst;
+			UInt16 colorMapLength;
+			UInt8  colorMapEntrySize;
+			UInt16 xOrigin;
+			UInt16 yOrigin;
+			UInt16 width;
+			UInt16 height;
+			UInt8  pixelDepth;
+			UInt8  descriptor;
+		};
+
+		void load(Serialization::BinaryDeserializer& archive, TgaHeader& header)
+		{
+			archive
+				.serialize(header.idLength)
+				.serialize(header.colorMapType)
+				.serialize(header.imageType)
+				.serialize(header.colorMapFirst)
+				.serialize(header.colorMapLength)
+				.serialize(header.colorMapEntrySize)
+				.serialize(header.xOrigin)
+				.serialize(header.yOrigin)
+				.serialize(header.width)
+				.serialize(header.height)
+				.serialize(header.pixelDepth)
+				.serialize(header.descriptor)
+			;
+		}
+
+		[[nodiscard]]
+		constexpr bool isRle(TgaImageType type) noexcept
+		{
+			return type == TgaImageType::rleColorMapped || type == TgaImageType::rleTrueColor || type == TgaImageType::rleGrayScale;
+		}
+
+		[[nodiscard]]
+		constexpr TgaImageType baseType(TgaImageType type) noexcept
+		{
+			return static_cast<TgaImageType>(static_cast<UInt8>(type) & 0x07);
+		}
+
+		[[nodiscard]]
+		constexpr bool isValidEntrySize(UInt32 size) noexcept
+		{
+			return size == 15 || size == 16 || size == 24 || size == 32;
+		}
+
+		[[nodiscard]]
+		TgaHeader readHeader(IReader& reader)
+		{
+			Serialization::BinaryDeserializer archive { reader, Endian::Order::little };
+
+			TgaHeader header;
+			archive.serialize(header);
+
+			const auto type = static_cast<TgaImageType>(header.imageType);
+
+			if (header.width == 0 || header.height == 0)
+			{
+				throw TgaImageFormatException { u8"Invalid TGA image size." };
+			}
+
+			if (header.colorMapType > 1 || (header.colorMapType == 1 && !isValidEntrySize(header.colorMapEntrySize)))
+			{
+				throw TgaImageFormatException { u8"Invalid TGA color map." };
+			}
+
+			switch (baseType(type))
+			{
+				case TgaImageType::colorMapped:
+					if (header.colorMapType != 1 || (header.pixelDepth != 8 && header.pixelDepth != 16))
+					{
+						throw TgaImageFormatException { u8"Unsupported TGA image format." };
+					}
+					break;
+
+				case TgaImageType::trueColor:
+					if (!isValidEntrySize(header.pixelDepth))
+					{
+						throw TgaImageFormatException { u8"Unsupported TGA image format." };
+					}
+					break;
+
+				case TgaImageType::grayScale:
+					if (header.pixelDepth != 8 && header.pixelDepth != 16)
+					{
+						throw TgaImageFormatException { u8"Unsupported TGA image format." };
+					}
+					break;
+
+				default:
+					throw TgaImageFormatException { u8"Unknown TGA image type." };
+			}
+
+			if (header.imageType != static_cast<UInt8>(baseType(type)) && !isRle(type))
+			{
+				throw TgaImageFormatException { u8"Unknown TGA image type." };
+			}
+
+			return header;
+		}
+
+		[[nodiscard]]
+		bool hasAlpha(const TgaHeader& header) noexcept
+		{
+			const auto type = baseType(static_cast<TgaImageType>(header.imageType));
+
+			if (type == TgaImageType::colorMapped)
+			{
+				return header.colorMapEntrySize == 32 || (header.colorMapEntrySize == 16 && (header.descriptor & descriptorAlphaBits));
+			}
+
+			if (type == TgaImageType::grayScale)
+			{
+				return header.pixelDepth == 16;
+			}
+
+			// The alpha of 16bit and 32bit pixels is only meaningful if the descriptor says so.
+			return (header.pixelDepth == 16 || header.pixelDepth == 32) && (header.descriptor & descriptorAlphaBits);
+		}
+
+		[[nodiscard]]
+		ImageInfo imageInfo(const TgaHeader& header) noexcept
+		{
+			const auto type  = baseType(static_cast<TgaImageType>(header.imageType));
+			const auto alpha = hasAlpha(header);
+
+			const auto channels = type == TgaImageType::grayScale ? (alpha ? 2 : 1) : (alpha ? 4 : 3);
+
+			return { Size2Di { header.width, header.height }, channels, 8, alpha, false };
+		}
+
+		// Compressed data buffer reused by the images on the thread.
+		std::vector<UInt8>& threadBuffer() noexcept
+		{
+			thread_local std::vector<UInt8> buffer;
+
+			return buffer;
+		}
+
+		// Expanded pixel buffer reused by the images on the thread.
+		std::vector<UInt8>& threadPixelBuffer() noexcept
+		{
+			thread_local std::vector<UInt8> buffer;
+
+			return buffer;
+		}
+
+		// Color map indexed by the raw pixel values.
+		std::vector<Color4>& threadPalette() noexcept
+		{
+			thread_local std::vector<Color4> palette;
+
+			return palette;
+		}
+
+		[[nodiscard]]
+		constexpr Color4 decode16(UInt32 v, bool alpha) noexcept
+		{
+			const auto expand = [](UInt32 c) { return static_cast<UInt8>(c << 3 | c >> 2); };
+
+			return Color4
+			{
+				expand((v >> 10) & 0x1f),
+				expand((v >>  5) & 0x1f),
+				expand( v        & 0x1f),
+				static_cast<UInt8>(!alpha || (v & 0x8000) ? 255 : 0),
+			};
+		}
+
+		// Swizzles 24bit BGR pixels into RGBA.
+		void convertBgr(const UInt8* source, Color4* destination, std::size_t count) noexcept
+		{
+			std::size_t i = 0;
+
+#if defined(NENE_SIMD_SSSE3)
+			const auto shuffle = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+			const auto alpha   = _mm_set1_epi32(static_cast<int>(0xff000000));
+
+			// Each load covers 16 bytes of the 12 bytes used.
+			for (; i * 3 + 16 <= count * 3; i += 4)
+			{
+				const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 3));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alpha));
+			}
+#endif
+
+			for (; i < count; i++)
+			{
+				destination[i].red   = source[i*3 + 2];
+				destination[i].green = source[i*3 + 1];
+				destination[i].blue  = source[i*3 + 0];
+				destination[i].alpha = 255;
+			}
+		}
+
+		// Decodes a color map entry or a true color pixel.
+		[[nodiscard]]
+		Color4 decodeColor(const UInt8* p, UInt32 depth, bool alpha) noexcept
+		{
+			switch (depth)
+			{
+				case 15:
+				case 16:
+					return decode16(p[0] | p[1] << 8, alpha);
+
+				case 24:
+					return Color4 { p[2], p[1], p[0], 255 };
+
+				default:
+					return Color4 { p[2], p[1], p[0], alpha ? p[3] : UInt8 { 255 } };
+			}
+		}
+
+		// Expands the run length encoded pixels; packets may cross the rows.
+		void expandRle(const UInt8* data, std::size_t size, std::size_t pixelBytes, std::size_t count, UInt8* pixels)
+		{
+			std::size_t i = 0;
+			std::size_t n = 0;
+
+			while (n < count)
+			{
+				if (i >= size)
+				{
+					throw TgaImageFormatException { u8"Unexpected end of TGA data." };
+				}
+
+				const auto packet = data[i++];
+				const auto length = (std::min)(static_cast<std::size_t>(packet & 0x7f) + 1, count - n);
+				const auto bytes  = packet & 0x80 ? pixelBytes : pixelBytes * length;
+
+				if (size - i < bytes)
+				{
+					throw TgaImageFormatException { u8"Unexpected end of TGA data." };
+				}
+
+				if (packet & 0x80)
+				{
+					// Run-length packet.
+					for (std::size_t k = 0; k < length; k++)
+					{
+						std::memcpy(pixels + (n + k) * pixelBytes, data + i, pixelBytes);
+					}
+				}
+				else
+				{
+					// Raw packet.
+					std::memcpy(pixels + n * pixelBytes, data + i, bytes);
+				}
+
+				i += bytes;
+				n += length;
+			}
+		}
+
+		void decodeImage(IReader& reader, const TgaHeader& header, MutableImageView image)
+		{
+			const auto type       = static_cast<TgaImageType>(header.imageType);
+			const auto base       = baseType(type);
+			const auto alpha      = hasAlpha(header);
+			const auto width      = static_cast<std::size_t>(header.width);
+			const auto height     = static_cast<Int32>(header.height);
+			const auto pixelBytes = static_cast<std::size_t>((header.pixelDepth + 7) / 8);
+			const auto rowBytes   = width * pixelBytes;
+			const auto imageBytes = rowBytes * height;
+
+			// Skip image ID.
+			reader.position(reader.position() + header.idLength);
+
+			// Read color map into a table indexed by the pixel values.
+			auto& palette = threadPalette();
+
+			if (header.colorMapType == 1)
+			{
+				const auto entryBytes = static_cast<std::size_t>((header.colorMapEntrySize + 7) / 8);
+				const auto mapBytes   = entryBytes * header.colorMapLength;
+
+				auto& buffer = threadBuffer();
+				buffer.resize(mapBytes);
+
+				if (reader.read(buffer.data(), mapBytes) != mapBytes)
+				{
+					throw TgaImageFormatException { u8"Unexpected end of TGA data." };
+				}
+
+				if (base == TgaImageType::colorMapped)
+				{
+					palette.assign(std::size_t { 1 } << header.pixelDepth, Color4 { 0, 0, 0, 255 });
+
+					for (std::size_t i = 0; i < header.colorMapLength && header.colorMapFirst + i < palette.size(); i++)
+					{
+						palette[header.colorMapFirst + i] = decodeColor(buffer.data() + i * entryBytes, header.colorMapEntrySize, alpha);
+					}
+				}
+			}
+
+			// Read pixel data at once.
+			auto& buffer = threadBuffer();
+
+			const auto available = reader.size() - reader.position();
+			const auto readBytes = isRle(type) ? available : (std::min)(available, imageBytes);
+
+			buffer.resize(readBytes);
+
+			if (reader.read(buffer.data(), readBytes) != readBytes || readBytes < (isRle(type) ? 0 : imageBytes))
+			{
+				throw TgaImageFormatException { u8"Unexpected end of TGA data." };
+			}
+
+			const UInt8* pixels = buffer.data();
+
+			if (isRle(type))
+			{
+				auto& expanded = threadPixelBuffer();
+				expanded.resize(imageBytes);
+
+				expandRle(buffer.data(), buffer.size(), pixelBytes, width * height, expanded.data());
+
+				pixels = expanded.data();
+			}
+
+			const bool topDown    = (header.descriptor & descriptorTopToBottom) != 0;
+			const bool rightToLeft = (header.descriptor & descriptorRightToLeft) != 0;
+
+			for (Int32 y = 0; y < height; y++)
+			{
+				const auto p   = pixels + rowBytes * y;
+				const auto row = image.row(topDown ? y : height - 1 - y);
+
+				switch (base)
+				{
+					case TgaImageType::colorMapped:
+						if (pixelBytes == 1)
+						{
+							for (std::size_t x = 0; x < width; x++)
+							{
+								row[x] = palette[p[x]];
+							}
+						}
+						else
+						{
+							for (std::size_t x = 0; x < width; x++)
+							{
+								row[x] = palette[p[x*2] | p[x*2 + 1] << 8];
+							}
+						}
+						break;
+
+					case TgaImageType::grayScale:
+						if (pixelBytes == 1)
+						{
+							ImageProcessing::convertRow(reinterpret_cast<const PixelR8*>(p), row, width);
+						}
+						else
+						{
+							for (std::size_t x = 0; x < width; x++)
+							{
+								row[x] = Color4 { p[x*2], p[x*2], p[x*2], p[x*2 + 1] };
+							}
+						}
+						break;
+
+					default:
+						switch (header.pixelDepth)
+						{
+							case 32:
+								ImageProcessing::convertRow(reinterpret_cast<const PixelBGRA8*>(p), row, width);
+
+								if (!alpha)
+								{
+									std::for_each(row, row + width, [](Color4& c) { c.alpha = 255; });
+								}
+								break;
+
+							case 24:
+								convertBgr(p, row, width);
+								break;
+
+							default:
+								for (std::size_t x = 0; x < width; x++)
+								{
+									row[x] = decode16(p[x*2] | p[x*2 + 1] << 8, alpha);
+								}
+								break;
+						}
+						break;
+				}
+
+				if (rightToLeft)
+				{
+					std::reverse(row, row + width);
+				}
+			}
+		}
+
+		// Lookup of the lowest set bit of 4bit masks.
+		constexpr Int32 lowestBit[16] =
+		{
+			4, 0, 1, 0, 2, 0, 1, 0, 3, 0, 1, 0, 2, 0, 1, 0,
+		};
+
+		[[nodiscard]]
+		bool equals(const Color4& a, const Color4& b) noexcept
+		{
+			return a.red == b.red && a.green == b.green && a.blue == b.blue && a.alpha == b.alpha;
+		}
+
+		// Returns number of the pixels equal to the first one.
+		[[nodiscard]]
+		Int32 runLength(const Color4* pixels, Int32 limit) noexcept
+		{
+			Int32 n = 1;
+
+#if defined(NENE_SIMD_SSE2)
+			const auto first = _mm_set1_epi32(*reinterpret_cast<const int*>(pixels));
+
+			for (; n + 4 <= limit; n += 4)
+			{
+				const auto v    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + n));
+				const auto mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, first)));
+
+				if (mask != 0x0f)
+				{
+					return n + lowestBit[~mask & 0x0f];
+				}
+			}
+#endif
+
+			while (n < limit && equals(pixels[n], pixels[0]))
+			{
+				n++;
+			}
+
+			return n;
+		}
+
+		// Returns number of the pixels before the next pair of equal pixels.
+		[[nodiscard]]
+		Int32 rawLength(const Color4* pixels, Int32 limit) noexcept
+		{
+			Int32 n = 0;
+
+#if defined(NENE_SIMD_SSE2)
+			for (; n + 5 <= limit; n += 4)
+			{
+				const auto a    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + n));
+				const auto b    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + n + 1));
+				const auto mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)));
+
+				if (mask != 0)
+				{
+					return (std::max)(n + lowestBit[mask], 1);
+				}
+			}
+#endif
+
+			for (; n + 1 < limit; n++)
+			{
+				if (equals(pixels[n], pixels[n + 1]))
+				{
+					return (std::max)(n, 1);
+				}
+			}
+
+			return limit;
+		}
+
+		// Writes BGR or BGRA pixels.
+		UInt8* putPixels(const Color4* pixels, Int32 count, bool alpha, UInt8* out) noexcept
+		{
+			if (alpha)
+			{
+				ImageProcessing::convertRow(pixels, reinterpret_cast<PixelBGRA8*>(out), static_cast<std::size_t>(count));
+
+				return out + count * 4;
+			}
+
+			for (Int32 i = 0; i < count; i++, out += 3)
+			{
+				out[0] = pixels[i].blue;
+				out[1] = pixels[i].green;
+				out[2] = pixels[i].red;
+			}
+
+			return out;
+		}
+
+		// Encodes a row and returns the end of the packets; packets do not cross the rows.
+		UInt8* encodeRow(const Color4* row, Int32 width, bool alpha, UInt8* out) noexcept
+		{
+			for (Int32 x = 0; x < width; )
+			{
+				const auto limit = (std::min)(width - x, maxPacketPixels);
+				const auto run   = runLength(row + x, limit);
+
+				if (run >= 2)
+				{
+					*out++ = static_cast<UInt8>(0x80 | (run - 1));
+					out = putPixels(row + x, 1, alpha, out);
+
+					x += run;
+					continue;
+				}
+
+				const auto raw = rawLength(row + x, limit);
+
+				*out++ = static_cast<UInt8>(raw - 1);
+				out = putPixels(row + x, raw, alpha, out);
+
+				x += raw;
+			}
+
+			return out;
+		}
+
+		void writeBuffer(IWriter& writer, const std::vector<UInt8>& buffer)
+		{
+			if (writer.write(buffer.data(), buffer.size()) != buffer.size())
+			{
+				throw TgaImageFormatException { u8"Failed to write TGA data." };
+			}
+		}
+	}
+
+	TgaImageFormat::TgaImageFormat(std::string_view name)
+		: name_(name) {}
+
+	const std::string& TgaImageFormat::name() const noexcept
+	{
+		return name_;
+	}
+
+	ArrayView<IImageFormat::path_type> TgaImageFormat::possibleExtensions() const noexcept
+	{
+		static const path_type extensions[] =
+		{
+			".tga",
+			".tpic",
+		};
+
+		return extensions;
+	}
+
+	bool TgaImageFormat::isImageHeader(const std::array<Byte, 16>& header) const noexcept
+	{
+		// TGA has no signature; check the header fields are consistent.
+		const auto byteAt = [&](std::size_t i) { return static_cast<UInt32>(header[i]); };
+		const auto wordAt = [&](std::size_t i) { return byteAt(i) | byteAt(i + 1) << 8; };
+
+		const auto colorMapType = byteAt(1);
+		const auto type         = static_cast<TgaImageType>(byteAt(2));
+		const auto base         = baseType(type);
+
+		if (colorMapType > 1 || wordAt(12) == 0 || wordAt(14) == 0)
+		{
+			return false;
+		}
+
+		if (base != TgaImageType::colorMapped && base != TgaImageType::trueColor && base != TgaImageType::grayScale)
+		{
+			return false;
+		}
+
+		if (byteAt(2) != static_cast<UInt32>(base) && !isRle(type))
+		{
+			return false;
+		}
+
+		if (colorMapType == 1)
+		{
+			return wordAt(5) > 0 && isValidEntrySize(byteAt(7));
+		}
+
+		// The color map specification must be empty without the color map.
+		return base != TgaImageType::colorMapped && wordAt(3) == 0 && wordAt(5) == 0 && byteAt(7) == 0;
+	}
+
+	bool TgaImageFormat::hasSignature() const noexcept
+	{
+		return false;
+	}
+
+	ImageInfo TgaImageFormat::probe(IReader& reader)
+	{
+		const auto position = reader.position();
+
+		[[maybe_unused]] const auto _ = scopeExit([&]()
+		{
+			reader.position(position);
+		});
+
+		return imageInfo(readHeader(reader));
+	}
+
+	Image TgaImageFormat::decode(IReader& reader)
+	{
+		const auto header = readHeader(reader);
+
+		Image image { Size2Di { header.width, header.height } };
+		decodeImage(reader, header, image.mutableView());
+
+		return image;
+	}
+
+	void TgaImageFormat::decodeInto(IReader& reader, MutableImageView image)
+	{
+		const auto header = readHeader(reader);
+
+		if (Size2Di { header.width, header.height } != image.size())
+		{
+			throw TgaImageFormatException { u8"Image size mismatch." };
+		}
+
+		decodeImage(reader, header, image);
+	}
+
+	void TgaImageFormat::encode(ImageView image, IWriter& writer)
+	{
+		if (image.width() <= 0 || image.width() > 0xffff || image.height() <= 0 || image.height() > 0xffff)
+		{
+			throw TgaImageFormatException { u8"Invalid TGA image size." };
+		}
+
+		bool alpha = false;
+
+		for (Int32 y = 0; y < image.height() && !alpha; y++)
+		{
+			const auto row = image.row(y);
+
+			alpha = std::any_of(row, row + image.width(), [](const Color4& c) { return c.alpha != 255; });
+		}
+
+		auto& buffer = threadBuffer();
+		buffer.clear();
+
+		// Write header.
+		const UInt8 header[headerSize] =
+		{
+			0,                                              // ID length
+			0,                                              // Color map type
+			static_cast<UInt8>(TgaImageType::rleTrueColor), // Image type
+			0, 0, 0, 0, 0,                                  // Color map specification
+			0, 0, 0, 0,                                     // Origin
+			static_cast<UInt8>(image.width()),  static_cast<UInt8>(image.width()  >> 8),
+			static_cast<UInt8>(image.height()), static_cast<UInt8>(image.height() >> 8),
+			static_cast<UInt8>(alpha ? 32 : 24),
+			static_cast<UInt8>(descriptorTopToBottom | (alpha ? 8 : 0)),
+		};
+
+		buffer.insert(buffer.end(), std::begin(header), std::end(header));
+
+		// Write packets in batches; a row takes at most a packet header per pixel.
+		const auto maxRowBytes = static_cast<std::size_t>(image.width()) * (alpha ? 5 : 4);
+
+		for (Int32 y = 0; y < image.height(); y++)
+		{
+			const auto offset = buffer.size();
+
+			buffer.resize(offset + maxRowBytes);
+
+			const auto end = encodeRow(image.row(y), image.width(), alpha, buffer.data() + offset);
+
+			buffer.resize(static_cast<std::size_t>(end - buffer.data()));
+
+			if (buffer.size() >= batchBytes)
+			{
+				writeBuffer(writer, buffer);
+				buffer.clear();
+			}
+		}
+
+		// Write TGA 2.0 footer without the extension and developer areas.
+		buffer.insert(buffer.end(), 8, 0);
+		buffer.insert(buffer.end(), std::begin(footerSignature), std::end(footerSignature));
+
+		writeBuffer(writer, buffer);
+	}
+
+	void TgaImageFormat::encode(ImageView image, IWriter& writer, [[maybe_unused]] Int32 quality)
+	{
+		encode(image, writer);
+	}
+}
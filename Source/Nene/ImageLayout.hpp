@@ -0,0 +1,114 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_IMAGELAYOUT_HPP
+#define INCLUDE_NENE_IMAGELAYOUT_HPP
+
+#include <cassert>
+#include <cstddef>
+#include "Types.hpp"
+
+namespace Nene
+{
+	/**
+	 * @brief      Pixel storage layout of images.
+	 *
+	 *             The first row starts at an address aligned to `alignment`
+	 *             and every row pitch is rounded up to a multiple of
+	 *             `pitchAlignment`.
+	 */
+	class ImageLayout
+	{
+	public:
+		std::size_t alignment;
+		std::size_t pitchAlignment;
+
+		/**
+		 * @brief      Returns 64 byte aligned layout without row padding.
+		 *
+		 * @return     The packed layout.
+		 */
+		[[nodiscard]]
+		static constexpr ImageLayout packed() noexcept
+		{
+			return ImageLayout { 64, 1 };
+		}
+
+		/**
+		 * @brief      Returns the layout whose every row is aligned.
+		 *
+		 * @param[in]  alignment  The row alignment in bytes.
+		 *
+		 * @return     The padded layout.
+		 */
+		[[nodiscard]]
+		static constexpr ImageLayout padded(std::size_t alignment = 64) noexcept
+		{
+			return ImageLayout { alignment, alignment };
+		}
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  alignment       The alignment of the first row in bytes, a power of two.
+		 * @param[in]  pitchAlignment  The row pitch granularity in bytes.
+		 */
+		constexpr explicit ImageLayout(std::size_t alignment = 64, std::size_t pitchAlignment = 1) noexcept
+			: alignment(alignment)
+			, pitchAlignment(pitchAlignment)
+		{
+			assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+			assert(pitchAlignment > 0);
+		}
+
+		/**
+		 * @brief      Computes the row pitch.
+		 *
+		 * @param[in]  width      The image width.
+		 * @param[in]  pixelSize  The size of a pixel in bytes.
+		 *
+		 * @return     The row pitch in bytes.
+		 */
+		[[nodiscard]]
+		constexpr std::size_t pitch(Int32 width, std::size_t pixelSize) const noexcept
+		{
+			const auto bytes = static_cast<std::size_t>(width) * pixelSize;
+
+			return (bytes + pitchAlignment - 1) / pitchAlignment * pitchAlignment;
+		}
+
+		[[nodiscard]]
+		constexpr bool operator==(const ImageLayout& layout) const noexcept
+		{
+			return alignment == layout.alignment && pitchAlignment == layout.pitchAlignment;
+		}
+
+		[[nodiscard]]
+		constexpr bool operator!=(const ImageLayout& layout) const noexcept
+		{
+			return !(*this == layout);
+		}
+	};
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGELAYOUT_HPP
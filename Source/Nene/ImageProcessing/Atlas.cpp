@@ -0,0 +1,583 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include "../Exceptions/EngineException.hpp"
+#include "../Thread/ThreadPool.hpp"
+#include "Atlas.hpp"
+#include "Composite.hpp"
+
+namespace Nene::ImageProcessing
+{
+	namespace
+	{
+		class Packer
+		{
+		public:
+			virtual ~Packer() =default;
+
+			virtual std::optional<Vector2Di> insert(const Size2Di& size) =0;
+		};
+
+		// MaxRects with the best short side fit heuristic.
+		class MaxRectsPacker final
+			: public Packer
+		{
+			std::vector<Rectanglei> free_;
+
+			[[nodiscard]]
+			static bool contains(const Rectanglei& a, const Rectanglei& b) noexcept
+			{
+				return a.left() <= b.left() && b.right() <= a.right() && a.top() <= b.top() && b.bottom() <= a.bottom();
+			}
+
+			[[nodiscard]]
+			static bool intersects(const Rectanglei& a, const Rectanglei& b) noexcept
+			{
+				return a.left() < b.right() && b.left() < a.right() && a.top() < b.bottom() && b.top() < a.bottom();
+			}
+
+			void split(const Rectanglei& used)
+			{
+				const auto count = free_.size();
+
+				for (std::size_t i = 0; i < count; i++)
+				{
+					const auto rect = free_[i];
+
+					if (!intersects(rect, used))
+					{
+						continue;
+					}
+
+					if (rect.left() < used.left())
+					{
+						free_.emplace_back(rect.left(), rect.top(), used.left(), rect.bottom());
+					}
+
+					if (used.right() < rect.right())
+					{
+						free_.emplace_back(used.right(), rect.top(), rect.right(), rect.bottom());
+					}
+
+					if (rect.top() < used.top())
+					{
+						free_.emplace_back(rect.left(), rect.top(), rect.right(), used.top());
+					}
+
+					if (used.bottom() < rect.bottom())
+					{
+						free_.emplace_back(rect.left(), used.bottom(), rect.right(), rect.bottom());
+					}
+
+					free_[i].size = {};
+				}
+
+				// Remove the split and the redundant rectangles.
+				free_.erase(std::remove_if(free_.begin(), free_.end(), [](const Rectanglei& r) { return r.size.width == 0; }), free_.end());
+
+				for (std::size_t i = 0; i < free_.size(); i++)
+				{
+					for (std::size_t j = i + 1; j < free_.size(); )
+					{
+						if (contains(free_[j], free_[i]))
+						{
+							free_.erase(free_.begin() + i);
+							i--;
+							break;
+						}
+
+						if (contains(free_[i], free_[j]))
+						{
+							free_.erase(free_.begin() + j);
+						}
+						else
+						{
+							j++;
+						}
+					}
+				}
+			}
+
+		public:
+			explicit MaxRectsPacker(const Size2Di& size)
+				: free_ { Rectanglei { Vector2Di { 0, 0 }, size } } {}
+
+			std::optional<Vector2Di> insert(const Size2Di& size) override
+			{
+				const Rectanglei* best = nullptr;
+				Int32 bestShort = 0;
+				Int32 bestLong  = 0;
+
+				for (const auto& rect : free_)
+				{
+					if (rect.size.width < size.width || rect.size.height < size.height)
+					{
+						continue;
+					}
+
+					const auto dx = rect.size.width  - size.width;
+					const auto dy = rect.size.height - size.height;
+					const auto shortSide = (std::min)(dx, dy);
+					const auto longSide  = (std::max)(dx, dy);
+
+					if (!best || shortSide < bestShort || (shortSide == bestShort && longSide < bestLong))
+					{
+						best      = &rect;
+						bestShort = shortSide;
+						bestLong  = longSide;
+					}
+				}
+
+				if (!best)
+				{
+					return std::nullopt;
+				}
+
+				const auto position = best->position;
+
+				split({ position, size });
+
+				return position;
+			}
+		};
+
+		// Skyline with the bottom left heuristic.
+		class SkylinePacker final
+			: public Packer
+		{
+			struct Segment
+			{
+				Int32 x, y, width;
+			};
+
+			Size2Di              size_;
+			std::vector<Segment> skyline_;
+
+			// Returns the top of the rectangle placed at the segment, or -1.
+			[[nodiscard]]
+			Int32 fit(std::size_t index, const Size2Di& size) const noexcept
+			{
+				if (skyline_[index].x + size.width > size_.width)
+				{
+					return -1;
+				}
+
+				Int32 y = 0;
+
+				for (Int32 remaining = size.width; remaining > 0; index++)
+				{
+					y = (std::max)(y, skyline_[index].y);
+
+					if (y + size.height > size_.height)
+					{
+						return -1;
+					}
+
+					remaining -= skyline_[index].width;
+				}
+
+				return y;
+			}
+
+		public:
+			explicit SkylinePacker(const Size2Di& size)
+				: size_(size)
+				, skyline_ { Segment { 0, 0, size.width } } {}
+
+			std::optional<Vector2Di> insert(const Size2Di& size) override
+			{
+				std::size_t bestIndex  = skyline_.size();
+				Int32       bestBottom = 0;
+				Int32       bestWidth  = 0;
+				Int32       bestY      = 0;
+
+				for (std::size_t i = 0; i < skyline_.size(); i++)
+				{
+					const auto y = fit(i, size);
+
+					if (y < 0)
+					{
+						continue;
+					}
+
+					const auto bottom = y + size.height;
+
+					if (bestIndex == skyline_.size() || bottom < bestBottom || (bottom == bestBottom && skyline_[i].width < bestWidth))
+					{
+						bestIndex  = i;
+						bestBottom = bottom;
+						bestWidth  = skyline_[i].width;
+						bestY      = y;
+					}
+				}
+
+				if (bestIndex == skyline_.size())
+				{
+					return std::nullopt;
+				}
+
+				const Vector2Di position { skyline_[bestIndex].x, bestY };
+
+				skyline_.insert(skyline_.begin() + bestIndex, Segment { position.x, bestBottom, size.width });
+
+				// Shrink the segments covered by the new one.
+				const auto right = position.x + size.width;
+
+				for (auto i = bestIndex + 1; i < skyline_.size(); )
+				{
+					auto& segment = skyline_[i];
+
+					if (segment.x >= right)
+					{
+						break;
+					}
+
+					const auto overlap = right - segment.x;
+
+					if (overlap < segment.width)
+					{
+						segment.x     += overlap;
+						segment.width -= overlap;
+						break;
+					}
+
+					skyline_.erase(skyline_.begin() + i);
+				}
+
+				// Merge the neighbors at the same height.
+				for (std::size_t i = 0; i + 1 < skyline_.size(); )
+				{
+					if (skyline_[i].y == skyline_[i + 1].y)
+					{
+						skyline_[i].width += skyline_[i + 1].width;
+						skyline_.erase(skyline_.begin() + i + 1);
+					}
+					else
+					{
+						i++;
+					}
+				}
+
+				return position;
+			}
+		};
+
+		[[nodiscard]]
+		std::unique_ptr<Packer> createPacker(AtlasPacking packing, const Size2Di& size)
+		{
+			if (packing == AtlasPacking::skyline)
+			{
+				return std::make_unique<SkylinePacker>(size);
+			}
+
+			return std::make_unique<MaxRectsPacker>(size);
+		}
+
+		// Returns the bounds of the visible pixels, or the top left pixel if there are none.
+		[[nodiscard]]
+		Rectanglei trim(ImageView image) noexcept
+		{
+			const auto visible = [](const Color4* pixels, Int32 count) noexcept
+			{
+				return std::any_of(pixels, pixels + count, [](const Color4& c) { return c.alpha != 0; });
+			};
+
+			const auto width = image.width();
+
+			Int32 top = 0;
+			Int32 bottom = image.height();
+
+			while (top < bottom && !visible(image.row(top), width))
+			{
+				top++;
+			}
+
+			if (top == bottom)
+			{
+				return { Vector2Di { 0, 0 }, Size2Di { 1, 1 } };
+			}
+
+			while (!visible(image.row(bottom - 1), width))
+			{
+				bottom--;
+			}
+
+			Int32 left = width;
+			Int32 right = 0;
+
+			for (Int32 y = top; y < bottom; y++)
+			{
+				const auto row = image.row(y);
+
+				for (Int32 x = 0; x < left; x++)
+				{
+					if (row[x].alpha != 0)
+					{
+						left = x;
+						break;
+					}
+				}
+
+				for (Int32 x = width; x > right; x--)
+				{
+					if (row[x - 1].alpha != 0)
+					{
+						right = x;
+						break;
+					}
+				}
+			}
+
+			return { left, top, right, bottom };
+		}
+
+		// Spreads the colors of the visible pixels into the transparent ones up to `distance` pixels away.
+		void bleed(MutableImageView cell, Int32 distance)
+		{
+			const auto width  = cell.width();
+			const auto height = cell.height();
+
+			// 0 while unfilled, otherwise the pass that filled the pixel.
+			std::vector<UInt8> filled(static_cast<std::size_t>(width) * height);
+
+			for (Int32 y = 0; y < height; y++)
+			{
+				const auto row = cell.row(y);
+
+				for (Int32 x = 0; x < width; x++)
+				{
+					filled[static_cast<std::size_t>(y) * width + x] = row[x].alpha != 0 ? 1 : 0;
+				}
+			}
+
+			distance = (std::min)(distance, 254);
+
+			for (Int32 pass = 2; pass < distance + 2; pass++)
+			{
+				bool changed = false;
+
+				for (Int32 y = 0; y < height; y++)
+				{
+					const auto row = cell.row(y);
+
+					for (Int32 x = 0; x < width; x++)
+					{
+						if (filled[static_cast<std::size_t>(y) * width + x] != 0)
+						{
+							continue;
+						}
+
+						UInt32 red = 0, green = 0, blue = 0, count = 0;
+
+						for (Int32 ny = (std::max)(y - 1, 0); ny <= (std::min)(y + 1, height - 1); ny++)
+						{
+							const auto neighbors = cell.row(ny);
+
+							for (Int32 nx = (std::max)(x - 1, 0); nx <= (std::min)(x + 1, width - 1); nx++)
+							{
+								const auto f = filled[static_cast<std::size_t>(ny) * width + nx];
+
+								if (f != 0 && f < pass)
+								{
+									red   += neighbors[nx].red;
+									green += neighbors[nx].green;
+									blue  += neighbors[nx].blue;
+									count++;
+								}
+							}
+						}
+
+						if (count != 0)
+						{
+							row[x] = Color4
+							{
+								static_cast<UInt8>((red   + count / 2) / count),
+								static_cast<UInt8>((green + count / 2) / count),
+								static_cast<UInt8>((blue  + count / 2) / count),
+								0,
+							};
+
+							filled[static_cast<std::size_t>(y) * width + x] = static_cast<UInt8>(pass);
+							changed = true;
+						}
+					}
+				}
+
+				if (!changed)
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	Atlas buildAtlas(ArrayView<ImageView> images, const AtlasOptions& options)
+	{
+		return buildAtlas(images, options, ThreadPool::shared());
+	}
+
+	Atlas buildAtlas(ArrayView<ImageView> images, const AtlasOptions& options, ThreadPool& pool)
+	{
+		assert(options.pageSize.width > 0 && options.pageSize.height > 0);
+		assert(options.padding >= 0);
+
+		const auto count   = static_cast<Int32>(images.size());
+		const auto padding = options.padding;
+
+		Atlas atlas;
+		atlas.entries.resize(images.size());
+
+		// Trim the images.
+		pool.parallelFor(0, count, 1, [&](Int32 begin, Int32 end)
+		{
+			for (Int32 i = begin; i < end; i++)
+			{
+				const auto& image = images[i];
+				auto&       entry = atlas.entries[i];
+
+				assert(!image.empty());
+
+				entry.sourceSize = image.size();
+				entry.sourceRect = options.trim ? trim(image) : Rectanglei { Vector2Di { 0, 0 }, image.size() };
+			}
+		});
+
+		// Place the larger images first.
+		std::vector<Int32> order(images.size());
+		std::iota(order.begin(), order.end(), 0);
+
+		std::stable_sort(order.begin(), order.end(), [&](Int32 a, Int32 b)
+		{
+			const auto& sa = atlas.entries[a].sourceRect.size;
+			const auto& sb = atlas.entries[b].sourceRect.size;
+
+			const auto longA = (std::max)(sa.width, sa.height);
+			const auto longB = (std::max)(sb.width, sb.height);
+
+			return longA != longB ? longA > longB : (std::min)(sa.width, sa.height) > (std::min)(sb.width, sb.height);
+		});
+
+		std::vector<std::unique_ptr<Packer>> packers;
+
+		for (const auto index : order)
+		{
+			auto& entry = atlas.entries[index];
+
+			const Size2Di cellSize { entry.sourceRect.size.width + padding * 2, entry.sourceRect.size.height + padding * 2 };
+
+			if (cellSize.width > options.pageSize.width || cellSize.height > options.pageSize.height)
+			{
+				throw EngineException { u8"Image is too large for the atlas page." };
+			}
+
+			std::optional<Vector2Di> position;
+			Int32 page = 0;
+
+			for (; page < static_cast<Int32>(packers.size()); page++)
+			{
+				if ((position = packers[page]->insert(cellSize)))
+				{
+					break;
+				}
+			}
+
+			if (!position)
+			{
+				if (options.maxPages > 0 && static_cast<Int32>(packers.size()) >= options.maxPages)
+				{
+					throw EngineException { u8"Atlas page limit has been exceeded." };
+				}
+
+				packers.emplace_back(createPacker(options.packing, options.pageSize));
+				position = packers.back()->insert(cellSize);
+			}
+
+			entry.page = page;
+			entry.rect = { Vector2Di { position->x + padding, position->y + padding }, entry.sourceRect.size };
+			entry.uv   =
+			{
+				Vector2Df
+				{
+					static_cast<Float32>(entry.rect.position.x) / options.pageSize.width,
+					static_cast<Float32>(entry.rect.position.y) / options.pageSize.height,
+				},
+				Size2Df
+				{
+					static_cast<Float32>(entry.rect.size.width)  / options.pageSize.width,
+					static_cast<Float32>(entry.rect.size.height) / options.pageSize.height,
+				},
+			};
+		}
+
+		atlas.pages.reserve(packers.size());
+
+		for (std::size_t i = 0; i < packers.size(); i++)
+		{
+			atlas.pages.emplace_back(options.pageSize, Color4 { 0, 0, 0, 0 });
+		}
+
+		// Copy the images; the cells never overlap so they are written concurrently.
+		pool.parallelFor(0, count, 1, [&](Int32 begin, Int32 end)
+		{
+			for (Int32 i = begin; i < end; i++)
+			{
+				const auto& entry = atlas.entries[i];
+
+				const Rectanglei cellRect
+				{
+					Vector2Di { entry.rect.position.x - padding, entry.rect.position.y - padding },
+					Size2Di { entry.rect.size.width + padding * 2, entry.rect.size.height + padding * 2 },
+				};
+
+				const auto cell = atlas.pages[entry.page].mutableView(cellRect);
+
+				blit(images[i].subView(entry.sourceRect), cell, Vector2Di { padding, padding });
+				bleed(cell, (std::max)(padding, 1));
+			}
+		});
+
+		return atlas;
+	}
+
+	Atlas buildAtlas(ArrayView<Image> images, const AtlasOptions& options)
+	{
+		return buildAtlas(images, options, ThreadPool::shared());
+	}
+
+	Atlas buildAtlas(ArrayView<Image> images, const AtlasOptions& options, ThreadPool& pool)
+	{
+		std::vector<ImageView> views;
+		views.reserve(images.size());
+
+		for (const auto& image : images)
+		{
+			views.emplace_back(image.view());
+		}
+
+		return buildAtlas(views, options, pool);
+	}
+}
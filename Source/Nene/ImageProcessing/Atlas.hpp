@@ -0,0 +1,181 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_IMAGEPROCESSING_ATLAS_HPP
+#define INCLUDE_NENE_IMAGEPROCESSING_ATLAS_HPP
+
+#include <vector>
+#include "../ArrayView.hpp"
+#include "../Image.hpp"
+#include "../Geometry/Rectangle.hpp"
+
+namespace Nene
+{
+	// Forward declarations.
+	class ThreadPool;
+}
+
+namespace Nene::ImageProcessing
+{
+	/**
+	 * @brief      Rectangle packing algorithms.
+	 */
+	enum class AtlasPacking: Int32
+	{
+		maxRects,
+		skyline,
+	};
+
+	/**
+	 * @brief      Atlas building options.
+	 */
+	class AtlasOptions
+	{
+	public:
+		/**
+		 * @brief      The size of the atlas pages.
+		 */
+		Size2Di pageSize = { 2048, 2048 };
+
+		/**
+		 * @brief      Maximum number of the pages, `0` for unlimited.
+		 */
+		Int32 maxPages = 0;
+
+		/**
+		 * @brief      The border around each image filled by alpha bleeding.
+		 */
+		Int32 padding = 2;
+
+		/**
+		 * @brief      `true` to strip the fully transparent borders of the images.
+		 */
+		bool trim = true;
+
+		/**
+		 * @brief      The packing algorithm.
+		 */
+		AtlasPacking packing = AtlasPacking::maxRects;
+	};
+
+	/**
+	 * @brief      Placement of an image in the atlas.
+	 */
+	class AtlasEntry
+	{
+	public:
+		/**
+		 * @brief      The page index.
+		 */
+		Int32 page;
+
+		/**
+		 * @brief      The rectangle of the image in the page, in pixels.
+		 */
+		Rectanglei rect;
+
+		/**
+		 * @brief      The rectangle of the image in the page, in texture coordinates.
+		 */
+		Rectanglef uv;
+
+		/**
+		 * @brief      The part of the source image kept after trimming.
+		 */
+		Rectanglei sourceRect;
+
+		/**
+		 * @brief      The size of the source image.
+		 */
+		Size2Di sourceSize;
+	};
+
+	/**
+	 * @brief      Texture atlas pages with the placement of each image.
+	 */
+	class Atlas
+	{
+	public:
+		/**
+		 * @brief      The atlas pages.
+		 */
+		std::vector<Image> pages;
+
+		/**
+		 * @brief      The placements, in the order of the input images.
+		 */
+		std::vector<AtlasEntry> entries;
+	};
+
+	/**
+	 * @brief      Packs the images into texture atlas pages.
+	 *
+	 *             The transparent pixels of each image and its padding take
+	 *             the colors of their visible neighbors so that filtering
+	 *             does not bleed dark fringes.
+	 *
+	 * @param[in]  images   The images to pack.
+	 * @param[in]  options  The building options.
+	 *
+	 * @return     The atlas.
+	 */
+	[[nodiscard]]
+	Atlas buildAtlas(ArrayView<ImageView> images, const AtlasOptions& options = AtlasOptions {});
+
+	/**
+	 * @brief      Packs the images into texture atlas pages.
+	 *
+	 * @param[in]  images   The images to pack.
+	 * @param[in]  options  The building options.
+	 * @param      pool     The thread pool to trim and copy the images on.
+	 *
+	 * @return     The atlas.
+	 */
+	[[nodiscard]]
+	Atlas buildAtlas(ArrayView<ImageView> images, const AtlasOptions& options, ThreadPool& pool);
+
+	/**
+	 * @brief      Packs the images into texture atlas pages.
+	 *
+	 * @param[in]  images   The images to pack.
+	 * @param[in]  options  The building options.
+	 *
+	 * @return     The atlas.
+	 */
+	[[nodiscard]]
+	Atlas buildAtlas(ArrayView<Image> images, const AtlasOptions& options = AtlasOptions {});
+
+	/**
+	 * @brief      Packs the images into texture atlas pages.
+	 *
+	 * @param[in]  images   The images to pack.
+	 * @param[in]  options  The building options.
+	 * @param      pool     The thread pool to trim and copy the images on.
+	 *
+	 * @return     The atlas.
+	 */
+	[[nodiscard]]
+	Atlas buildAtlas(ArrayView<Image> images, const AtlasOptions& options, ThreadPool& pool);
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGEPROCESSING_ATLAS_HPP
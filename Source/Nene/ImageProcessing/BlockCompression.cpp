@@ -0,0 +1,1673 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "../Platform.hpp"
+#include "../Thread/ThreadPool.hpp"
+#include "BlockCompression.hpp"
+
+#if defined(NENE_SIMD_SSE2)
+#  include <emmintrin.h>
+#endif
+
+namespace Nene::ImageProcessing
+{
+	namespace
+	{
+		// BC7 4bit index interpolation weights.
+		constexpr UInt32 bc7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		// 128bit little endian bit stream.
+		class BitWriter
+		{
+			UInt64 bits_[2] = {};
+			Int32  position_ = 0;
+
+		public:
+			void write(UInt32 value, Int32 count) noexcept
+			{
+				const auto word  = position_ / 64;
+				const auto shift = position_ % 64;
+
+				bits_[word] |= static_cast<UInt64>(value) << shift;
+
+				if (shift + count > 64)
+				{
+					bits_[word + 1] |= static_cast<UInt64>(value) >> (64 - shift);
+				}
+
+				position_ += count;
+			}
+
+			void store(Byte* block) const noexcept
+			{
+				for (Int32 i = 0; i < 16; i++)
+				{
+					block[i] = byte(static_cast<unsigned char>(bits_[i / 8] >> (i % 8 * 8)));
+				}
+			}
+		};
+
+		class BitReader
+		{
+			UInt64 bits_[2] = {};
+			Int32  position_ = 0;
+
+		public:
+			explicit BitReader(const Byte* block) noexcept
+			{
+				for (Int32 i = 0; i < 16; i++)
+				{
+					bits_[i / 8] |= static_cast<UInt64>(block[i]) << (i % 8 * 8);
+				}
+			}
+
+			UInt32 read(Int32 count) noexcept
+			{
+				const auto word  = position_ / 64;
+				const auto shift = position_ % 64;
+
+				auto value = bits_[word] >> shift;
+
+				if (shift + count > 64)
+				{
+					value |= bits_[word + 1] << (64 - shift);
+				}
+
+				position_ += count;
+
+				return static_cast<UInt32>(value & ((UInt64 { 1 } << count) - 1));
+			}
+		};
+
+		[[nodiscard]]
+		UInt8 channel(const Color4& color, Int32 index) noexcept
+		{
+			switch (index)
+			{
+				case 0 : return color.red;
+				case 1 : return color.green;
+				case 2 : return color.blue;
+				default: return color.alpha;
+			}
+		}
+
+		[[nodiscard]]
+		UInt8 clampRound(Float32 x, Float32 max) noexcept
+		{
+			return static_cast<UInt8>(std::lround((std::clamp)(x, 0.0f, max)));
+		}
+
+		[[nodiscard]]
+		UInt32 distance(const Color4& a, const Color4& b) noexcept
+		{
+			const auto dr = static_cast<Int32>(a.red)   - b.red;
+			const auto dg = static_cast<Int32>(a.green) - b.green;
+			const auto db = static_cast<Int32>(a.blue)  - b.blue;
+			const auto da = static_cast<Int32>(a.alpha) - b.alpha;
+
+			return static_cast<UInt32>(dr * dr + dg * dg + db * db + da * da);
+		}
+
+		// Selects the nearest palette entry for each pixel and returns the total squared error.
+		UInt32 nearestIndicesScalar(const Color4* pixels, std::size_t count, const Color4* palette, Int32 paletteSize, UInt8* indices) noexcept
+		{
+			UInt32 total = 0;
+
+			for (std::size_t i = 0; i < count; i++)
+			{
+				UInt32 best  = (std::numeric_limits<UInt32>::max)();
+				UInt8  index = 0;
+
+				for (Int32 k = 0; k < paletteSize; k++)
+				{
+					const auto d = distance(pixels[i], palette[k]);
+
+					if (d < best)
+					{
+						best  = d;
+						index = static_cast<UInt8>(k);
+					}
+				}
+
+				indices[i] = index;
+				total += best;
+			}
+
+			return total;
+		}
+
+#if defined(NENE_SIMD_SSE2)
+		// 4 pixels per iteration; the squared channel differences are summed with `pmaddwd`.
+		UInt32 nearestIndicesSse2(const Color4* pixels, std::size_t count, const Color4* palette, Int32 paletteSize, UInt8* indices) noexcept
+		{
+			const auto zero = _mm_setzero_si128();
+
+			__m128i entries[16];
+
+			for (Int32 k = 0; k < paletteSize; k++)
+			{
+				Int32 c;
+				std::memcpy(&c, &palette[k], sizeof(c));
+
+				entries[k] = _mm_unpacklo_epi8(_mm_set1_epi32(c), zero);
+			}
+
+			UInt32 total = 0;
+			std::size_t i = 0;
+
+			for (; i + 4 <= count; i += 4)
+			{
+				const auto p  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+				const auto lo = _mm_unpacklo_epi8(p, zero);
+				const auto hi = _mm_unpackhi_epi8(p, zero);
+
+				auto best  = _mm_set1_epi32((std::numeric_limits<Int32>::max)());
+				auto index = zero;
+
+				for (Int32 k = 0; k < paletteSize; k++)
+				{
+					const auto dl = _mm_sub_epi16(lo, entries[k]);
+					const auto dh = _mm_sub_epi16(hi, entries[k]);
+
+					auto sl = _mm_madd_epi16(dl, dl);
+					auto sh = _mm_madd_epi16(dh, dh);
+
+					sl = _mm_add_epi32(sl, _mm_shuffle_epi32(sl, _MM_SHUFFLE(2, 3, 0, 1)));
+					sh = _mm_add_epi32(sh, _mm_shuffle_epi32(sh, _MM_SHUFFLE(2, 3, 0, 1)));
+
+					const auto d    = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(sl), _mm_castsi128_ps(sh), _MM_SHUFFLE(2, 0, 2, 0)));
+					const auto mask = _mm_cmplt_epi32(d, best);
+
+					best  = _mm_or_si128(_mm_and_si128(mask, d), _mm_andnot_si128(mask, best));
+					index = _mm_or_si128(_mm_and_si128(mask, _mm_set1_epi32(k)), _mm_andnot_si128(mask, index));
+				}
+
+				alignas(16) Int32 errors[4];
+				alignas(16) Int32 selected[4];
+
+				_mm_store_si128(reinterpret_cast<__m128i*>(errors), best);
+				_mm_store_si128(reinterpret_cast<__m128i*>(selected), index);
+
+				for (Int32 j = 0; j < 4; j++)
+				{
+					indices[i + j] = static_cast<UInt8>(selected[j]);
+					total += static_cast<UInt32>(errors[j]);
+				}
+			}
+
+			return total + nearestIndicesScalar(pixels + i, count - i, palette, paletteSize, indices + i);
+		}
+#endif
+
+		UInt32 nearestIndices(const Color4* pixels, std::size_t count, const Color4* palette, Int32 paletteSize, UInt8* indices) noexcept
+		{
+#if defined(NENE_SIMD_SSE2)
+			return nearestIndicesSse2(pixels, count, palette, paletteSize, indices);
+#else
+			return nearestIndicesScalar(pixels, count, palette, paletteSize, indices);
+#endif
+		}
+
+		// Fits a line through the pixels along their principal axis and returns its extent.
+		void principalEndpoints(const Color4* pixels, std::size_t count, Int32 channels, Float32 (&lo)[4], Float32 (&hi)[4]) noexcept
+		{
+			Float32 mean[4] = {};
+
+			for (std::size_t i = 0; i < count; i++)
+			{
+				for (Int32 c = 0; c < channels; c++)
+				{
+					mean[c] += channel(pixels[i], c);
+				}
+			}
+
+			for (Int32 c = 0; c < channels; c++)
+			{
+				mean[c] /= static_cast<Float32>(count);
+			}
+
+			Float32 covariance[4][4] = {};
+
+			for (std::size_t i = 0; i < count; i++)
+			{
+				Float32 d[4] = {};
+
+				for (Int32 c = 0; c < channels; c++)
+				{
+					d[c] = channel(pixels[i], c) - mean[c];
+				}
+
+				for (Int32 r = 0; r < channels; r++)
+				{
+					for (Int32 c = 0; c < channels; c++)
+					{
+						covariance[r][c] += d[r] * d[c];
+					}
+				}
+			}
+
+			// Power iteration from the row of the largest variance.
+			Int32 largest = 0;
+
+			for (Int32 c = 1; c < channels; c++)
+			{
+				if (covariance[c][c] > covariance[largest][largest])
+				{
+					largest = c;
+				}
+			}
+
+			Float32 axis[4] = {};
+
+			for (Int32 c = 0; c < channels; c++)
+			{
+				axis[c] = covariance[largest][c];
+			}
+
+			for (Int32 iteration = 0; iteration < 8; iteration++)
+			{
+				Float32 next[4] = {};
+				Float32 norm    = 0.0f;
+
+				for (Int32 r = 0; r < channels; r++)
+				{
+					for (Int32 c = 0; c < channels; c++)
+					{
+						next[r] += covariance[r][c] * axis[c];
+					}
+
+					norm = (std::max)(norm, std::abs(next[r]));
+				}
+
+				if (norm == 0.0f)
+				{
+					break;
+				}
+
+				for (Int32 c = 0; c < channels; c++)
+				{
+					axis[c] = next[c] / norm;
+				}
+			}
+
+			Float32 length = 0.0f;
+
+			for (Int32 c = 0; c < channels; c++)
+			{
+				length += axis[c] * axis[c];
+			}
+
+			Float32 tmin = 0.0f;
+			Float32 tmax = 0.0f;
+
+			if (length > 0.0f)
+			{
+				tmin = (std::numeric_limits<Float32>::max)();
+				tmax = std::numeric_limits<Float32>::lowest();
+
+				for (std::size_t i = 0; i < count; i++)
+				{
+					Float32 t = 0.0f;
+
+					for (Int32 c = 0; c < channels; c++)
+					{
+						t += (channel(pixels[i], c) - mean[c]) * axis[c];
+					}
+
+					tmin = (std::min)(tmin, t / length);
+					tmax = (std::max)(tmax, t / length);
+				}
+			}
+
+			for (Int32 c = 0; c < 4; c++)
+			{
+				lo[c] = c < channels ? (std::clamp)(mean[c] + axis[c] * tmin, 0.0f, 255.0f) : 255.0f;
+				hi[c] = c < channels ? (std::clamp)(mean[c] + axis[c] * tmax, 0.0f, 255.0f) : 255.0f;
+			}
+		}
+
+		// Solves the endpoints minimizing the error of the pixels interpolated with the index weights.
+		bool leastSquares(const Color4* pixels, std::size_t count, const UInt8* indices, const Float32* weights, Int32 channels, Float32 (&lo)[4], Float32 (&hi)[4]) noexcept
+		{
+			Float32 aa = 0.0f, ab = 0.0f, bb = 0.0f;
+			Float32 ax[4] = {}, bx[4] = {};
+
+			for (std::size_t i = 0; i < count; i++)
+			{
+				const auto w = weights[indices[i]];
+				const auto v = 1.0f - w;
+
+				aa += v * v;
+				ab += v * w;
+				bb += w * w;
+
+				for (Int32 c = 0; c < channels; c++)
+				{
+					ax[c] += v * channel(pixels[i], c);
+					bx[c] += w * channel(pixels[i], c);
+				}
+			}
+
+			const auto det = aa * bb - ab * ab;
+
+			if (std::abs(det) < 1e-6f)
+			{
+				return false;
+			}
+
+			for (Int32 c = 0; c < channels; c++)
+			{
+				lo[c] = (std::clamp)((bb * ax[c] - ab * bx[c]) / det, 0.0f, 255.0f);
+				hi[c] = (std::clamp)((aa * bx[c] - ab * ax[c]) / det, 0.0f, 255.0f);
+			}
+
+			return true;
+		}
+
+		[[nodiscard]]
+		Int32 refinements(BlockQuality quality) noexcept
+		{
+			switch (quality)
+			{
+				case BlockQuality::fast  : return 0;
+				case BlockQuality::normal: return 1;
+				default                  : return 3;
+			}
+		}
+
+		//
+		// BC1 color blocks.
+		//
+
+		[[nodiscard]]
+		UInt16 pack565(const Float32 (&color)[4]) noexcept
+		{
+			const auto r = clampRound(color[0] * 31.0f / 255.0f, 31.0f);
+			const auto g = clampRound(color[1] * 63.0f / 255.0f, 63.0f);
+			const auto b = clampRound(color[2] * 31.0f / 255.0f, 31.0f);
+
+			return static_cast<UInt16>(r << 11 | g << 5 | b);
+		}
+
+		[[nodiscard]]
+		Color4 unpack565(UInt32 color) noexcept
+		{
+			const auto r = color >> 11 & 0x1f;
+			const auto g = color >>  5 & 0x3f;
+			const auto b = color       & 0x1f;
+
+			return
+			{
+				static_cast<UInt8>(r << 3 | r >> 2),
+				static_cast<UInt8>(g << 2 | g >> 4),
+				static_cast<UInt8>(b << 3 | b >> 2),
+				255,
+			};
+		}
+
+		[[nodiscard]]
+		Color4 mix(const Color4& a, const Color4& b, UInt32 wa, UInt32 wb) noexcept
+		{
+			const auto total = wa + wb;
+
+			return
+			{
+				static_cast<UInt8>((a.red   * wa + b.red   * wb) / total),
+				static_cast<UInt8>((a.green * wa + b.green * wb) / total),
+				static_cast<UInt8>((a.blue  * wa + b.blue  * wb) / total),
+				255,
+			};
+		}
+
+		// Returns number of the opaque colors: 4, or 3 with a transparent 4th entry.
+		Int32 colorPalette(UInt16 c0, UInt16 c1, bool fourColors, Color4 (&palette)[4]) noexcept
+		{
+			const auto a = unpack565(c0);
+			const auto b = unpack565(c1);
+
+			palette[0] = a;
+			palette[1] = b;
+
+			if (fourColors || c0 > c1)
+			{
+				palette[2] = mix(a, b, 2, 1);
+				palette[3] = mix(a, b, 1, 2);
+
+				return 4;
+			}
+
+			palette[2] = mix(a, b, 1, 1);
+			palette[3] = Color4 { 0, 0, 0, 0 };
+
+			return 3;
+		}
+
+		class ColorEncoder
+		{
+			Color4 pixels_[16];
+			UInt8  slots_[16];
+			Int32  count_;
+			bool   transparent_;
+			bool   bc1_;
+
+			UInt16 c0_ = 0;
+			UInt16 c1_ = 0;
+			UInt8  indices_[16] = {};
+			UInt32 error_ = (std::numeric_limits<UInt32>::max)();
+
+			// Evaluates the endpoints in 4 color order, or 3 color order if `threeColors`.
+			void attempt(UInt16 a, UInt16 b, bool threeColors) noexcept
+			{
+				const auto c0 = threeColors ? (std::min)(a, b) : (std::max)(a, b);
+				const auto c1 = threeColors ? (std::max)(a, b) : (std::min)(a, b);
+
+				Color4 palette[4];
+				const auto size = colorPalette(c0, c1, !bc1_, palette);
+
+				UInt8 indices[16];
+				const auto error = nearestIndices(pixels_, count_, palette, size, indices);
+
+				if (error < error_)
+				{
+					c0_    = c0;
+					c1_    = c1;
+					error_ = error;
+					std::memcpy(indices_, indices, sizeof(indices));
+				}
+			}
+
+			void refine(bool threeColors) noexcept
+			{
+				static constexpr Float32 four[4]  = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+				static constexpr Float32 three[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+				const auto fourColors = !bc1_ || c0_ > c1_;
+
+				if (fourColors == threeColors)
+				{
+					return;
+				}
+
+				Float32 lo[4], hi[4];
+
+				if (leastSquares(pixels_, count_, indices_, fourColors ? four : three, 3, lo, hi))
+				{
+					attempt(pack565(lo), pack565(hi), threeColors);
+				}
+			}
+
+			void perturb(bool threeColors) noexcept
+			{
+				static constexpr struct { Int32 shift, mask; } fields[] = { { 11, 0x1f }, { 5, 0x3f }, { 0, 0x1f } };
+
+				for (Int32 endpoint = 0; endpoint < 2; endpoint++)
+				{
+					for (const auto& field : fields)
+					{
+						for (const Int32 delta : { -1, 1 })
+						{
+							const auto c = endpoint == 0 ? c0_ : c1_;
+							const auto v = static_cast<Int32>(c >> field.shift & field.mask) + delta;
+
+							if (v < 0 || v > field.mask)
+							{
+								continue;
+							}
+
+							const auto moved = static_cast<UInt16>((c & ~(field.mask << field.shift)) | v << field.shift);
+
+							attempt(endpoint == 0 ? moved : c0_, endpoint == 0 ? c1_ : moved, threeColors);
+						}
+					}
+				}
+			}
+
+		public:
+			explicit ColorEncoder(const Color4* pixels, bool bc1) noexcept
+				: count_(0)
+				, transparent_(false)
+				, bc1_(bc1)
+			{
+				for (Int32 i = 0; i < 16; i++)
+				{
+					if (bc1 && pixels[i].alpha < 128)
+					{
+						transparent_ = true;
+						continue;
+					}
+
+					pixels_[count_] = Color4 { pixels[i].red, pixels[i].green, pixels[i].blue, 255 };
+					slots_[count_]  = static_cast<UInt8>(i);
+					count_++;
+				}
+			}
+
+			void encode(BlockQuality quality, Byte* block) noexcept
+			{
+				UInt32 bits = 0;
+
+				if (count_ == 0)
+				{
+					// Every pixel takes the transparent entry.
+					c0_  = 0;
+					c1_  = 0;
+					bits = 0xffffffff;
+				}
+				else
+				{
+					Float32 lo[4], hi[4];
+					principalEndpoints(pixels_, count_, 3, lo, hi);
+
+					attempt(pack565(lo), pack565(hi), transparent_);
+
+					for (Int32 i = 0; i < refinements(quality); i++)
+					{
+						refine(transparent_);
+					}
+
+					if (quality == BlockQuality::high)
+					{
+						perturb(transparent_);
+
+						if (bc1_ && !transparent_)
+						{
+							// The midpoint of the 3 color mode occasionally fits better.
+							attempt(c0_, c1_, true);
+							refine(true);
+						}
+					}
+
+					if (transparent_)
+					{
+						bits = 0xffffffff;
+					}
+
+					for (Int32 i = 0; i < count_; i++)
+					{
+						bits &= ~(UInt32 { 3 } << (slots_[i] * 2));
+						bits |= static_cast<UInt32>(indices_[i]) << (slots_[i] * 2);
+					}
+				}
+
+				block[0] = byte(static_cast<unsigned char>(c0_));
+				block[1] = byte(static_cast<unsigned char>(c0_ >> 8));
+				block[2] = byte(static_cast<unsigned char>(c1_));
+				block[3] = byte(static_cast<unsigned char>(c1_ >> 8));
+
+				for (Int32 i = 0; i < 4; i++)
+				{
+					block[4 + i] = byte(static_cast<unsigned char>(bits >> (i * 8)));
+				}
+			}
+		};
+
+		void decodeColorBlock(const Byte* block, bool bc1, Color4* pixels) noexcept
+		{
+			const auto c0 = static_cast<UInt16>(static_cast<UInt32>(block[0]) | static_cast<UInt32>(block[1]) << 8);
+			const auto c1 = static_cast<UInt16>(static_cast<UInt32>(block[2]) | static_cast<UInt32>(block[3]) << 8);
+
+			Color4 palette[4];
+			colorPalette(c0, c1, !bc1, palette);
+
+			for (Int32 i = 0; i < 16; i++)
+			{
+				const auto index = static_cast<UInt32>(block[4 + i / 4]) >> (i % 4 * 2) & 3;
+
+				pixels[i] = palette[index];
+			}
+		}
+
+		//
+		// BC4 single channel blocks.
+		//
+
+		void scalarPalette(UInt8 e0, UInt8 e1, UInt8 (&palette)[8]) noexcept
+		{
+			palette[0] = e0;
+			palette[1] = e1;
+
+			if (e0 > e1)
+			{
+				for (UInt32 i = 1; i < 7; i++)
+				{
+					palette[i + 1] = static_cast<UInt8>(((7 - i) * e0 + i * e1 + 3) / 7);
+				}
+			}
+			else
+			{
+				for (UInt32 i = 1; i < 5; i++)
+				{
+					palette[i + 1] = static_cast<UInt8>(((5 - i) * e0 + i * e1 + 2) / 5);
+				}
+
+				palette[6] = 0;
+				palette[7] = 255;
+			}
+		}
+
+		class ScalarEncoder
+		{
+			const UInt8* values_;
+
+			UInt8  e0_ = 0;
+			UInt8  e1_ = 0;
+			UInt8  indices_[16] = {};
+			UInt32 error_ = (std::numeric_limits<UInt32>::max)();
+
+			void attempt(Int32 e0, Int32 e1) noexcept
+			{
+				e0 = (std::clamp)(e0, 0, 255);
+				e1 = (std::clamp)(e1, 0, 255);
+
+				UInt8 palette[8];
+				scalarPalette(static_cast<UInt8>(e0), static_cast<UInt8>(e1), palette);
+
+				UInt8  indices[16];
+				UInt32 error = 0;
+
+				for (Int32 i = 0; i < 16; i++)
+				{
+					UInt32 best = (std::numeric_limits<UInt32>::max)();
+
+					for (Int32 k = 0; k < 8; k++)
+					{
+						const auto d = static_cast<Int32>(values_[i]) - palette[k];
+						const auto e = static_cast<UInt32>(d * d);
+
+						if (e < best)
+						{
+							best       = e;
+							indices[i] = static_cast<UInt8>(k);
+						}
+					}
+
+					error += best;
+				}
+
+				if (error < error_)
+				{
+					e0_    = static_cast<UInt8>(e0);
+					e1_    = static_cast<UInt8>(e1);
+					error_ = error;
+					std::memcpy(indices_, indices, sizeof(indices));
+				}
+			}
+
+			// Refits the endpoints of the 8 value mode.
+			void refine() noexcept
+			{
+				static constexpr Float32 weights[8] = { 0.0f, 1.0f, 1 / 7.0f, 2 / 7.0f, 3 / 7.0f, 4 / 7.0f, 5 / 7.0f, 6 / 7.0f };
+
+				if (e0_ <= e1_)
+				{
+					return;
+				}
+
+				Float32 aa = 0.0f, ab = 0.0f, bb = 0.0f, ax = 0.0f, bx = 0.0f;
+
+				for (Int32 i = 0; i < 16; i++)
+				{
+					const auto w = weights[indices_[i]];
+					const auto v = 1.0f - w;
+
+					aa += v * v;
+					ab += v * w;
+					bb += w * w;
+					ax += v * values_[i];
+					bx += w * values_[i];
+				}
+
+				const auto det = aa * bb - ab * ab;
+
+				if (std::abs(det) < 1e-6f)
+				{
+					return;
+				}
+
+				const auto e0 = static_cast<Int32>(std::lround((bb * ax - ab * bx) / det));
+				const auto e1 = static_cast<Int32>(std::lround((aa * bx - ab * ax) / det));
+
+				if (e0 > e1)
+				{
+					attempt(e0, e1);
+				}
+			}
+
+		public:
+			explicit ScalarEncoder(const UInt8* values) noexcept
+				: values_(values) {}
+
+			void encode(BlockQuality quality, Byte* block) noexcept
+			{
+				const auto [minimum, maximum] = std::minmax_element(values_, values_ + 16);
+
+				if (*minimum == *maximum)
+				{
+					attempt(*maximum, *minimum);
+				}
+				else
+				{
+					attempt(*maximum, *minimum);
+
+					for (Int32 i = 0; i < refinements(quality); i++)
+					{
+						refine();
+					}
+
+					if (quality == BlockQuality::high)
+					{
+						// The 6 value mode represents 0 and 255 exactly.
+						Int32 lo = 255, hi = 0;
+
+						for (Int32 i = 0; i < 16; i++)
+						{
+							if (values_[i] != 0 && values_[i] != 255)
+							{
+								lo = (std::min)(lo, static_cast<Int32>(values_[i]));
+								hi = (std::max)(hi, static_cast<Int32>(values_[i]));
+							}
+						}
+
+						attempt((std::min)(lo, hi), (std::max)(lo, hi));
+
+						const auto e0 = e0_, e1 = e1_;
+
+						for (Int32 d0 = -1; d0 <= 1; d0++)
+						{
+							for (Int32 d1 = -1; d1 <= 1; d1++)
+							{
+								if ((e0 > e1) == (e0 + d0 > e1 + d1))
+								{
+									attempt(e0 + d0, e1 + d1);
+								}
+							}
+						}
+					}
+				}
+
+				UInt64 bits = 0;
+
+				for (Int32 i = 0; i < 16; i++)
+				{
+					bits |= static_cast<UInt64>(indices_[i]) << (i * 3);
+				}
+
+				block[0] = byte(e0_);
+				block[1] = byte(e1_);
+
+				for (Int32 i = 0; i < 6; i++)
+				{
+					block[2 + i] = byte(static_cast<unsigned char>(bits >> (i * 8)));
+				}
+			}
+		};
+
+		void decodeScalarBlock(const Byte* block, UInt8* values, std::size_t stride) noexcept
+		{
+			UInt8 palette[8];
+			scalarPalette(static_cast<UInt8>(block[0]), static_cast<UInt8>(block[1]), palette);
+
+			UInt64 bits = 0;
+
+			for (Int32 i = 0; i < 6; i++)
+			{
+				bits |= static_cast<UInt64>(block[2 + i]) << (i * 8);
+			}
+
+			for (Int32 i = 0; i < 16; i++)
+			{
+				values[i * stride] = palette[bits >> (i * 3) & 7];
+			}
+		}
+
+		//
+		// BC7 blocks.
+		//
+
+		struct Bc7Mode
+		{
+			Int32 subsets;
+			Int32 partitionBits;
+			Int32 rotationBits;
+			Int32 selectionBits;
+			Int32 colorBits;
+			Int32 alphaBits;
+			Int32 endpointPbits;
+			Int32 sharedPbits;
+			Int32 indexBits;
+			Int32 secondaryIndexBits;
+		};
+
+		constexpr Bc7Mode bc7Modes[8] =
+		{
+			{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+			{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+			{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+			{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+			{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+			{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+			{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+			{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+		};
+
+		// Subsets of the pixels, a bit per pixel for two subsets and two bits for three.
+		constexpr UInt16 bc7Partitions2[64] =
+		{
+			0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80,
+			0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+			0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce,
+			0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+			0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a,
+			0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+			0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c,
+			0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22,
+		};
+
+		constexpr UInt32 bc7Partitions3[64] =
+		{
+			0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8, 0xa5a50000, 0xa0a05050, 0x5555a0a0, 0x5a5a5050,
+			0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090, 0x94949494, 0xa4a4a4a4, 0xa9a59450, 0x2a0a4250,
+			0xa5945040, 0x0a425054, 0xa5a5a500, 0x55a0a0a0, 0xa8a85454, 0x6a6a4040, 0xa4a45000, 0x1a1a0500,
+			0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400, 0xa08585a0, 0xaa821414, 0x50a4a450, 0x6a5a0200,
+			0xa9a58000, 0x5090a0a8, 0xa8a09050, 0x24242424, 0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50,
+			0x500aa550, 0xaaaa4444, 0x66660000, 0xa5a0a5a0, 0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600,
+			0xaa444444, 0x54a854a8, 0x95809580, 0x96969600, 0xa85454a8, 0x80959580, 0xaa141414, 0x96960000,
+			0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000, 0x40804080, 0xa9a8a9a8, 0xaaaaaa44, 0x2a4a5254,
+		};
+
+		// Anchor pixels of the second and the third subsets; the first subset is anchored at the pixel 0.
+		constexpr UInt8 bc7Anchors2[64] =
+		{
+			15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+			15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+			15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+			 6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15,
+		};
+
+		constexpr UInt8 bc7Anchors3Second[64] =
+		{
+			 3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+			 3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+			 8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+			 3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3,
+		};
+
+		constexpr UInt8 bc7Anchors3Third[64] =
+		{
+			15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+			15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+			15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+			15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8,
+		};
+
+		// BC7 2bit and 3bit index interpolation weights.
+		constexpr UInt32 bc7Weights2[4] = { 0, 21, 43, 64 };
+		constexpr UInt32 bc7Weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+
+		// The encoder produces mode 6, RGBA 7bit endpoints with a p-bit each and 4bit indices, and tries mode 3 for the opaque blocks.
+
+		class Bc7Endpoints
+		{
+		public:
+			UInt8 color[2][4];
+			UInt8 pbit[2];
+
+			void palette(const UInt32* weights, Int32 size, Color4* entries) const noexcept
+			{
+				UInt32 e[2][4];
+
+				for (Int32 i = 0; i < 2; i++)
+				{
+					for (Int32 c = 0; c < 4; c++)
+					{
+						e[i][c] = static_cast<UInt32>(color[i][c]) << 1 | pbit[i];
+					}
+				}
+
+				for (Int32 k = 0; k < size; k++)
+				{
+					const auto w = weights[k];
+
+					const auto lerp = [&](Int32 c)
+					{
+						return static_cast<UInt8>(((64 - w) * e[0][c] + w * e[1][c] + 32) >> 6);
+					};
+
+					entries[k] = Color4 { lerp(0), lerp(1), lerp(2), lerp(3) };
+				}
+			}
+		};
+
+		// Quantizes the endpoint to 7bit channels, choosing the p-bit unless given.
+		void quantizeBc7(const Float32 (&value)[4], Int32 fixedPbit, UInt8 (&color)[4], UInt8& pbit) noexcept
+		{
+			Float32 bestError = (std::numeric_limits<Float32>::max)();
+
+			for (Int32 p = 0; p < 2; p++)
+			{
+				if (fixedPbit >= 0 && p != fixedPbit)
+				{
+					continue;
+				}
+
+				UInt8   c[4];
+				Float32 error = 0.0f;
+
+				for (Int32 i = 0; i < 4; i++)
+				{
+					c[i] = clampRound((value[i] - p) / 2.0f, 127.0f);
+
+					const auto d = static_cast<Float32>(c[i] * 2 + p) - value[i];
+
+					error += d * d;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					pbit = static_cast<UInt8>(p);
+					std::memcpy(color, c, sizeof(c));
+				}
+			}
+		}
+
+		// Mode 3: RGB 7bit endpoints with a p-bit each and 2bit indices in two subsets. The alpha is always 255, so
+		// either p-bit can be used, which mode 6 allows only at the cost of an alpha of 254.
+		class Bc7OpaqueEncoder
+		{
+			const Color4* pixels_;
+
+			Int32        partition_ = 0;
+			Bc7Endpoints endpoints_[2] = {};
+			UInt8        indices_[16] = {};
+			UInt32       error_ = (std::numeric_limits<UInt32>::max)();
+
+			// Fits the endpoints of a subset for each combination of the p-bits.
+			[[nodiscard]]
+			static UInt32 fit(const Color4* pixels, std::size_t count, Bc7Endpoints& endpoints, UInt8* indices) noexcept
+			{
+				static const Float32 weights[4] = { 0.0f, 21.0f / 64.0f, 43.0f / 64.0f, 1.0f };
+
+				UInt32 bestError = (std::numeric_limits<UInt32>::max)();
+
+				const auto attempt = [&](const Float32 (&lo)[4], const Float32 (&hi)[4])
+				{
+					for (Int32 p = 0; p < 4; p++)
+					{
+						Bc7Endpoints candidate;
+						quantizeBc7(lo, p & 1, candidate.color[0], candidate.pbit[0]);
+						quantizeBc7(hi, p >> 1, candidate.color[1], candidate.pbit[1]);
+
+						Color4 palette[4];
+						candidate.palette(bc7Weights2, 4, palette);
+
+						for (auto& entry : palette)
+						{
+							entry.alpha = 255;
+						}
+
+						UInt8 candidateIndices[16];
+						const auto error = nearestIndices(pixels, count, palette, 4, candidateIndices);
+
+						if (error < bestError)
+						{
+							bestError = error;
+							endpoints = candidate;
+							std::memcpy(indices, candidateIndices, count);
+						}
+					}
+				};
+
+				Float32 lo[4], hi[4];
+				principalEndpoints(pixels, count, 3, lo, hi);
+				attempt(lo, hi);
+
+				if (leastSquares(pixels, count, indices, weights, 3, lo, hi))
+				{
+					attempt(lo, hi);
+				}
+
+				return bestError;
+			}
+
+		public:
+			explicit Bc7OpaqueEncoder(const Color4* pixels) noexcept
+				: pixels_(pixels) {}
+
+			[[nodiscard]]
+			UInt32 error() const noexcept
+			{
+				return error_;
+			}
+
+			void attempt(Int32 partition) noexcept
+			{
+				Color4       subsetPixels[2][16];
+				UInt8        subsetIndices[2][16];
+				std::size_t  counts[2] = {};
+				Bc7Endpoints endpoints[2];
+
+				for (Int32 i = 0; i < 16; i++)
+				{
+					const auto subset = bc7Partitions2[partition] >> i & 1;
+
+					subsetPixels[subset][counts[subset]++] = pixels_[i];
+				}
+
+				const auto error = fit(subsetPixels[0], counts[0], endpoints[0], subsetIndices[0]) + fit(subsetPixels[1], counts[1], endpoints[1], subsetIndices[1]);
+
+				if (error < error_)
+				{
+					partition_ = partition;
+					error_     = error;
+					std::memcpy(endpoints_, endpoints, sizeof(endpoints));
+
+					std::size_t next[2] = {};
+
+					for (Int32 i = 0; i < 16; i++)
+					{
+						const auto subset = bc7Partitions2[partition] >> i & 1;
+
+						indices_[i] = subsetIndices[subset][next[subset]++];
+					}
+				}
+			}
+
+			void encode(Byte* block) noexcept
+			{
+				const Int32 anchors[2] = { 0, bc7Anchors2[partition_] };
+
+				// The anchor indices must have their most significant bits clear.
+				for (Int32 subset = 0; subset < 2; subset++)
+				{
+					if (indices_[anchors[subset]] & 2)
+					{
+						std::swap(endpoints_[subset].color[0], endpoints_[subset].color[1]);
+						std::swap(endpoints_[subset].pbit[0], endpoints_[subset].pbit[1]);
+
+						for (Int32 i = 0; i < 16; i++)
+						{
+							if ((bc7Partitions2[partition_] >> i & 1) == static_cast<UInt32>(subset))
+							{
+								indices_[i] = static_cast<UInt8>(3 - indices_[i]);
+							}
+						}
+					}
+				}
+
+				BitWriter writer;
+				writer.write(1 << 3, 4);
+				writer.write(static_cast<UInt32>(partition_), 6);
+
+				for (Int32 c = 0; c < 3; c++)
+				{
+					for (const auto& endpoints : endpoints_)
+					{
+						writer.write(endpoints.color[0][c], 7);
+						writer.write(endpoints.color[1][c], 7);
+					}
+				}
+
+				for (const auto& endpoints : endpoints_)
+				{
+					writer.write(endpoints.pbit[0], 1);
+					writer.write(endpoints.pbit[1], 1);
+				}
+
+				for (Int32 i = 0; i < 16; i++)
+				{
+					writer.write(indices_[i], i == anchors[0] || i == anchors[1] ? 1 : 2);
+				}
+
+				writer.store(block);
+			}
+		};
+
+		class Bc7Encoder
+		{
+			const Color4* pixels_;
+			bool          opaque_;
+
+			Bc7Endpoints endpoints_ = {};
+			UInt8        indices_[16] = {};
+			UInt32       error_ = (std::numeric_limits<UInt32>::max)();
+
+			void attempt(const Bc7Endpoints& endpoints) noexcept
+			{
+				Color4 palette[16];
+				endpoints.palette(bc7Weights, 16, palette);
+
+				UInt8 indices[16];
+				const auto error = nearestIndices(pixels_, 16, palette, 16, indices);
+
+				if (error < error_)
+				{
+					endpoints_ = endpoints;
+					error_     = error;
+					std::memcpy(indices_, indices, sizeof(indices));
+				}
+			}
+
+			void attempt(const Float32 (&lo)[4], const Float32 (&hi)[4], Int32 pbit0, Int32 pbit1) noexcept
+			{
+				Bc7Endpoints endpoints;
+				quantizeBc7(lo, pbit0, endpoints.color[0], endpoints.pbit[0]);
+				quantizeBc7(hi, pbit1, endpoints.color[1], endpoints.pbit[1]);
+
+				attempt(endpoints);
+			}
+
+			[[nodiscard]]
+			Int32 fixedPbit() const noexcept
+			{
+				// Opaque blocks keep alpha exactly 255 in mode 6.
+				return opaque_ ? 1 : -1;
+			}
+
+			void refine() noexcept
+			{
+				static const auto weights = []
+				{
+					std::array<Float32, 16> w {};
+
+					for (Int32 i = 0; i < 16; i++)
+					{
+						w[i] = bc7Weights[i] / 64.0f;
+					}
+
+					return w;
+				}();
+
+				Float32 lo[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+				Float32 hi[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+
+				if (leastSquares(pixels_, 16, indices_, weights.data(), opaque_ ? 3 : 4, lo, hi))
+				{
+					attempt(lo, hi, fixedPbit(), fixedPbit());
+				}
+			}
+
+			void perturb() noexcept
+			{
+				for (Int32 endpoint = 0; endpoint < 2; endpoint++)
+				{
+					for (Int32 c = 0; c < (opaque_ ? 3 : 4); c++)
+					{
+						for (const Int32 delta : { -1, 1 })
+						{
+							auto endpoints = endpoints_;
+							const auto v = endpoints.color[endpoint][c] + delta;
+
+							if (0 <= v && v <= 127)
+							{
+								endpoints.color[endpoint][c] = static_cast<UInt8>(v);
+								attempt(endpoints);
+							}
+						}
+					}
+
+					if (!opaque_)
+					{
+						auto endpoints = endpoints_;
+						endpoints.pbit[endpoint] ^= 1;
+						attempt(endpoints);
+					}
+				}
+			}
+
+		public:
+			explicit Bc7Encoder(const Color4* pixels) noexcept
+				: pixels_(pixels)
+				, opaque_(std::all_of(pixels, pixels + 16, [](const Color4& c) { return c.alpha == 255; })) {}
+
+			void encode(BlockQuality quality, Byte* block) noexcept
+			{
+				Float32 lo[4], hi[4];
+				principalEndpoints(pixels_, 16, opaque_ ? 3 : 4, lo, hi);
+
+				attempt(lo, hi, fixedPbit(), fixedPbit());
+
+				for (Int32 i = 0; i < refinements(quality); i++)
+				{
+					refine();
+				}
+
+				if (quality == BlockQuality::high)
+				{
+					if (!opaque_)
+					{
+						for (Int32 p = 0; p < 4; p++)
+						{
+							attempt(lo, hi, p & 1, p >> 1);
+						}
+					}
+
+					perturb();
+				}
+
+				// Mode 3 on the vertical half, and the horizontal half unless fast.
+				if (opaque_)
+				{
+					Bc7OpaqueEncoder opaque { pixels_ };
+					opaque.attempt(0);
+
+					if (quality != BlockQuality::fast)
+					{
+						opaque.attempt(13);
+					}
+
+					if (opaque.error() < error_)
+					{
+						opaque.encode(block);
+						return;
+					}
+				}
+
+				// The anchor index must have its most significant bit clear.
+				if (indices_[0] & 8)
+				{
+					std::swap(endpoints_.color[0], endpoints_.color[1]);
+					std::swap(endpoints_.pbit[0], endpoints_.pbit[1]);
+
+					for (auto& index : indices_)
+					{
+						index = static_cast<UInt8>(15 - index);
+					}
+				}
+
+				BitWriter writer;
+				writer.write(1 << 6, 7);
+
+				for (Int32 c = 0; c < 4; c++)
+				{
+					writer.write(endpoints_.color[0][c], 7);
+					writer.write(endpoints_.color[1][c], 7);
+				}
+
+				writer.write(endpoints_.pbit[0], 1);
+				writer.write(endpoints_.pbit[1], 1);
+				writer.write(indices_[0], 3);
+
+				for (Int32 i = 1; i < 16; i++)
+				{
+					writer.write(indices_[i], 4);
+				}
+
+				writer.store(block);
+			}
+		};
+
+		[[nodiscard]]
+		const UInt32* bc7WeightsOf(Int32 bits) noexcept
+		{
+			switch (bits)
+			{
+				case 2 : return bc7Weights2;
+				case 3 : return bc7Weights3;
+				default: return bc7Weights;
+			}
+		}
+
+		// Expands the endpoint to 8bit by repeating the high bits.
+		[[nodiscard]]
+		UInt8 expandBc7(UInt32 value, Int32 bits) noexcept
+		{
+			value <<= 8 - bits;
+
+			return static_cast<UInt8>(value | value >> bits);
+		}
+
+		void decodeBc7(const Byte* block, Color4* pixels) noexcept
+		{
+			BitReader reader { block };
+
+			// The mode is the number of the leading zero bits.
+			Int32 mode = 0;
+
+			while (mode < 8 && reader.read(1) == 0)
+			{
+				mode++;
+			}
+
+			// Reserved modes decode as transparent black.
+			if (mode == 8)
+			{
+				std::fill_n(pixels, 16, Color4 { 0, 0, 0, 0 });
+				return;
+			}
+
+			const auto& m = bc7Modes[mode];
+
+			const auto partition = reader.read(m.partitionBits);
+			const auto rotation  = reader.read(m.rotationBits);
+			const auto selection = reader.read(m.selectionBits);
+
+			const auto numEndpoints = m.subsets * 2;
+
+			UInt32 endpoints[6][4];
+
+			for (Int32 c = 0; c < 3; c++)
+			{
+				for (Int32 i = 0; i < numEndpoints; i++)
+				{
+					endpoints[i][c] = reader.read(m.colorBits);
+				}
+			}
+
+			for (Int32 i = 0; i < numEndpoints; i++)
+			{
+				endpoints[i][3] = reader.read(m.alphaBits);
+			}
+
+			auto colorBits = m.colorBits;
+			auto alphaBits = m.alphaBits;
+
+			// The p-bits are the least significant bits of the endpoints, shared in each subset or not.
+			if (m.endpointPbits || m.sharedPbits)
+			{
+				UInt32 pbits[6];
+
+				for (Int32 i = 0; i < numEndpoints; i++)
+				{
+					pbits[i] = m.endpointPbits || i % 2 == 0 ? reader.read(1) : pbits[i - 1];
+				}
+
+				for (Int32 i = 0; i < numEndpoints; i++)
+				{
+					for (Int32 c = 0; c < 4; c++)
+					{
+						endpoints[i][c] = endpoints[i][c] << 1 | pbits[i];
+					}
+				}
+
+				colorBits++;
+
+				if (alphaBits > 0)
+				{
+					alphaBits++;
+				}
+			}
+
+			Color4 colors[6];
+
+			for (Int32 i = 0; i < numEndpoints; i++)
+			{
+				colors[i] = Color4
+				{
+					expandBc7(endpoints[i][0], colorBits),
+					expandBc7(endpoints[i][1], colorBits),
+					expandBc7(endpoints[i][2], colorBits),
+					alphaBits > 0 ? expandBc7(endpoints[i][3], alphaBits) : UInt8 { 255 },
+				};
+			}
+
+			const auto subsetOf = [&](Int32 i) -> Int32
+			{
+				switch (m.subsets)
+				{
+					case 2 : return bc7Partitions2[partition] >> i & 1;
+					case 3 : return bc7Partitions3[partition] >> (i * 2) & 3;
+					default: return 0;
+				}
+			};
+
+			const auto anchorOf = [&](Int32 subset) -> Int32
+			{
+				switch (subset)
+				{
+					case 1 : return m.subsets == 2 ? bc7Anchors2[partition] : bc7Anchors3Second[partition];
+					case 2 : return bc7Anchors3Third[partition];
+					default: return 0;
+				}
+			};
+
+			// The most significant bits of the anchor indices are implicitly zero.
+			UInt32 indices[16];
+			UInt32 secondaryIndices[16] = {};
+
+			for (Int32 i = 0; i < 16; i++)
+			{
+				indices[i] = reader.read(m.indexBits - (i == anchorOf(subsetOf(i)) ? 1 : 0));
+			}
+
+			if (m.secondaryIndexBits > 0)
+			{
+				for (Int32 i = 0; i < 16; i++)
+				{
+					secondaryIndices[i] = reader.read(m.secondaryIndexBits - (i == 0 ? 1 : 0));
+				}
+			}
+
+			// The selection bit swaps the index sets of the color and the alpha.
+			const auto colorWeights  = bc7WeightsOf(selection ? m.secondaryIndexBits : m.indexBits);
+			const auto alphaWeights  = bc7WeightsOf(m.secondaryIndexBits > 0 && !selection ? m.secondaryIndexBits : m.indexBits);
+			const auto& colorIndices = selection ? secondaryIndices : indices;
+			const auto& alphaIndices = m.secondaryIndexBits > 0 && !selection ? secondaryIndices : indices;
+
+			for (Int32 i = 0; i < 16; i++)
+			{
+				const auto  subset = subsetOf(i);
+				const auto& e0     = colors[subset * 2 + 0];
+				const auto& e1     = colors[subset * 2 + 1];
+
+				const auto lerp = [](UInt32 a, UInt32 b, UInt32 w)
+				{
+					return static_cast<UInt8>(((64 - w) * a + w * b + 32) >> 6);
+				};
+
+				const auto cw = colorWeights[colorIndices[i]];
+				const auto aw = alphaWeights[alphaIndices[i]];
+
+				auto pixel = Color4
+				{
+					lerp(e0.red  , e1.red  , cw),
+					lerp(e0.green, e1.green, cw),
+					lerp(e0.blue , e1.blue , cw),
+					lerp(e0.alpha, e1.alpha, aw),
+				};
+
+				// The rotation swaps the alpha with one of the color channels.
+				switch (rotation)
+				{
+					case 1: std::swap(pixel.alpha, pixel.red  ); break;
+					case 2: std::swap(pixel.alpha, pixel.green); break;
+					case 3: std::swap(pixel.alpha, pixel.blue ); break;
+					default: break;
+				}
+
+				pixels[i] = pixel;
+			}
+		}
+
+		[[nodiscard]]
+		Int32 rowsPerTask(Int32 height, const ThreadPool& pool) noexcept
+		{
+			// A few chunks per worker keep the threads busy until the end.
+			const auto chunks = static_cast<Int32>(pool.numThreads() + 1) * 4;
+
+			return (std::max)((height + chunks - 1) / chunks, 1);
+		}
+	}
+
+	std::size_t blockBytes(BlockFormat format) noexcept
+	{
+		return format == BlockFormat::bc1 || format == BlockFormat::bc4 ? 8 : 16;
+	}
+
+	std::size_t compressedBytes(const Size2Di& size, BlockFormat format) noexcept
+	{
+		const auto blocksX = static_cast<std::size_t>((size.width  + 3) / 4);
+		const auto blocksY = static_cast<std::size_t>((size.height + 3) / 4);
+
+		return blocksX * blocksY * blockBytes(format);
+	}
+
+	void compressBlock(const Color4* pixels, BlockFormat format, BlockQuality quality, Byte* block) noexcept
+	{
+		const auto channelOf = [&](Int32 c, UInt8 (&values)[16])
+		{
+			for (Int32 i = 0; i < 16; i++)
+			{
+				values[i] = channel(pixels[i], c);
+			}
+		};
+
+		UInt8 values[16];
+
+		switch (format)
+		{
+			case BlockFormat::bc1:
+				ColorEncoder { pixels, true }.encode(quality, block);
+				break;
+
+			case BlockFormat::bc3:
+				channelOf(3, values);
+				ScalarEncoder { values }.encode(quality, block);
+				ColorEncoder { pixels, false }.encode(quality, block + 8);
+				break;
+
+			case BlockFormat::bc4:
+				channelOf(0, values);
+				ScalarEncoder { values }.encode(quality, block);
+				break;
+
+			case BlockFormat::bc5:
+				channelOf(0, values);
+				ScalarEncoder { values }.encode(quality, block);
+				channelOf(1, values);
+				ScalarEncoder { values }.encode(quality, block + 8);
+				break;
+
+			case BlockFormat::bc7:
+				Bc7Encoder { pixels }.encode(quality, block);
+				break;
+		}
+	}
+
+	void decompressBlock(const Byte* block, BlockFormat format, Color4* pixels) noexcept
+	{
+		switch (format)
+		{
+			case BlockFormat::bc1:
+				decodeColorBlock(block, true, pixels);
+				break;
+
+			case BlockFormat::bc3:
+				decodeColorBlock(block + 8, false, pixels);
+				decodeScalarBlock(block, &pixels[0].alpha, sizeof(Color4));
+				break;
+
+			case BlockFormat::bc4:
+				std::fill_n(pixels, 16, Color4 { 0, 0, 0, 255 });
+				decodeScalarBlock(block, &pixels[0].red, sizeof(Color4));
+				break;
+
+			case BlockFormat::bc5:
+				std::fill_n(pixels, 16, Color4 { 0, 0, 0, 255 });
+				decodeScalarBlock(block, &pixels[0].red, sizeof(Color4));
+				decodeScalarBlock(block + 8, &pixels[0].green, sizeof(Color4));
+				break;
+
+			case BlockFormat::bc7:
+				decodeBc7(block, pixels);
+				break;
+		}
+	}
+
+	std::vector<Byte> compressBlocks(ImageView image, BlockFormat format, BlockQuality quality)
+	{
+		return compressBlocks(image, format, quality, ThreadPool::shared());
+	}
+
+	std::vector<Byte> compressBlocks(ImageView image, BlockFormat format, BlockQuality quality, ThreadPool& pool)
+	{
+		assert(!image.empty());
+
+		const auto blocksX = (image.width()  + 3) / 4;
+		const auto blocksY = (image.height() + 3) / 4;
+		const auto size    = blockBytes(format);
+
+		std::vector<Byte> blocks(compressedBytes(image.size(), format));
+
+		pool.parallelFor(0, blocksY, rowsPerTask(blocksY, pool), [&](Int32 begin, Int32 end)
+		{
+			Color4 pixels[16];
+
+			for (Int32 by = begin; by < end; by++)
+			{
+				for (Int32 bx = 0; bx < blocksX; bx++)
+				{
+					for (Int32 y = 0; y < 4; y++)
+					{
+						const auto row = image.row((std::min)(by * 4 + y, image.height() - 1));
+
+						for (Int32 x = 0; x < 4; x++)
+						{
+							pixels[y * 4 + x] = row[(std::min)(bx * 4 + x, image.width() - 1)];
+						}
+					}
+
+					compressBlock(pixels, format, quality, blocks.data() + (static_cast<std::size_t>(by) * blocksX + bx) * size);
+				}
+			}
+		});
+
+		return blocks;
+	}
+
+	Image decompressBlocks(ByteArrayView blocks, const Size2Di& size, BlockFormat format)
+	{
+		assert(blocks.size() >= compressedBytes(size, format));
+
+		const auto blocksX = (size.width  + 3) / 4;
+		const auto blocksY = (size.height + 3) / 4;
+
+		Image image { size };
+		Color4 pixels[16];
+
+		for (Int32 by = 0; by < blocksY; by++)
+		{
+			for (Int32 bx = 0; bx < blocksX; bx++)
+			{
+				decompressBlock(blocks.data() + (static_cast<std::size_t>(by) * blocksX + bx) * blockBytes(format), format, pixels);
+
+				for (Int32 y = 0; y < 4 && by * 4 + y < size.height; y++)
+				{
+					const auto row = image.row(by * 4 + y);
+
+					for (Int32 x = 0; x < 4 && bx * 4 + x < size.width; x++)
+					{
+						row[bx * 4 + x] = pixels[y * 4 + x];
+					}
+				}
+			}
+		}
+
+		return image;
+	}
+}
@@ -0,0 +1,149 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_IMAGEPROCESSING_BLOCKCOMPRESSION_HPP
+#define INCLUDE_NENE_IMAGEPROCESSING_BLOCKCOMPRESSION_HPP
+
+#include <vector>
+#include "../ArrayView.hpp"
+#include "../Byte.hpp"
+#include "../Image.hpp"
+
+namespace Nene
+{
+	// Forward declarations.
+	class ThreadPool;
+}
+
+namespace Nene::ImageProcessing
+{
+	/**
+	 * @brief      Block compressed texture formats.
+	 *
+	 *             `bc4` stores the red channel and `bc5` the red and green
+	 *             channels; the other formats store all the channels.
+	 */
+	enum class BlockFormat: Int32
+	{
+		bc1,
+		bc3,
+		bc4,
+		bc5,
+		bc7,
+	};
+
+	/**
+	 * @brief      Block compression quality presets.
+	 */
+	enum class BlockQuality: Int32
+	{
+		fast,
+		normal,
+		high,
+	};
+
+	/**
+	 * @brief      Returns size of a 4x4 block.
+	 *
+	 * @param[in]  format  The block format.
+	 *
+	 * @return     Size of a block in bytes.
+	 */
+	[[nodiscard]]
+	std::size_t blockBytes(BlockFormat format) noexcept;
+
+	/**
+	 * @brief      Returns size of the compressed image.
+	 *
+	 * @param[in]  size    The image size.
+	 * @param[in]  format  The block format.
+	 *
+	 * @return     Size of the blocks covering the image in bytes.
+	 */
+	[[nodiscard]]
+	std::size_t compressedBytes(const Size2Di& size, BlockFormat format) noexcept;
+
+	/**
+	 * @brief      Compresses a 4x4 block.
+	 *
+	 * @param[in]  pixels   The 16 pixels of the block in row major order.
+	 * @param[in]  format   The block format.
+	 * @param[in]  quality  The quality preset.
+	 * @param[out] block    The compressed block.
+	 */
+	void compressBlock(const Color4* pixels, BlockFormat format, BlockQuality quality, Byte* block) noexcept;
+
+	/**
+	 * @brief      Decompresses a 4x4 block.
+	 *
+	 *             Missing channels are decoded as `0` and a missing alpha as
+	 *             `255`. BC7 blocks are decoded in all the modes; blocks of
+	 *             the reserved mode are decoded as transparent black.
+	 *
+	 * @param[in]  block   The compressed block.
+	 * @param[in]  format  The block format.
+	 * @param[out] pixels  The 16 pixels of the block in row major order.
+	 */
+	void decompressBlock(const Byte* block, BlockFormat format, Color4* pixels) noexcept;
+
+	/**
+	 * @brief      Compresses the image.
+	 *
+	 *             The edge pixels are repeated to fill the partial blocks.
+	 *
+	 * @param[in]  image    The image to compress.
+	 * @param[in]  format   The block format.
+	 * @param[in]  quality  The quality preset.
+	 *
+	 * @return     The blocks in row major order.
+	 */
+	[[nodiscard]]
+	std::vector<Byte> compressBlocks(ImageView image, BlockFormat format, BlockQuality quality = BlockQuality::normal);
+
+	/**
+	 * @brief      Compresses the image.
+	 *
+	 * @param[in]  image    The image to compress.
+	 * @param[in]  format   The block format.
+	 * @param[in]  quality  The quality preset.
+	 * @param      pool     The thread pool to compress the blocks on.
+	 *
+	 * @return     The blocks in row major order.
+	 */
+	[[nodiscard]]
+	std::vector<Byte> compressBlocks(ImageView image, BlockFormat format, BlockQuality quality, ThreadPool& pool);
+
+	/**
+	 * @brief      Decompresses the image.
+	 *
+	 * @param[in]  blocks  The blocks in row major order.
+	 * @param[in]  size    The image size.
+	 * @param[in]  format  The block format.
+	 *
+	 * @return     The decompressed image.
+	 */
+	[[nodiscard]]
+	Image decompressBlocks(ByteArrayView blocks, const Size2Di& size, BlockFormat format);
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGEPROCESSING_BLOCKCOMPRESSION_HPP
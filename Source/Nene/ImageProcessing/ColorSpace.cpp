@@ -0,0 +1,429 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "../Platform.hpp"
+#include "ColorSpace.hpp"
+
+#if defined(NENE_SIMD_SSE2)
+#  include <emmintrin.h>
+#endif
+
+namespace Nene::ImageProcessing
+{
+	namespace
+	{
+		static_assert(sizeof(Color4f) == sizeof(Float32) * 4);
+
+		// Linear values below the threshold are encoded linearly.
+		constexpr Float32 linearThreshold = 0.0031308f;
+		constexpr Float32 srgbThreshold   = 0.04045f;
+
+		// Chebyshev fit of `1.055 * u^(5/6) - 0.055` where `u = sqrt(linear)`.
+		constexpr Float32 toSrgb[] =
+		{
+			-0.0426948172f, 1.59299931f, -2.12463608f, 5.15651482f, -8.52494524f, 8.57523233f, -4.71921814f, 1.08676671f,
+		};
+
+		// Chebyshev fit of `((srgb + 0.055) / 1.055)^2.4`.
+		constexpr Float32 toLinear[] =
+		{
+			0.000858165285f, 0.0351695827f, 0.486915687f, 0.854134495f, -0.841327597f, 0.905310444f, -0.691233606f, 0.311784524f, -0.0616119373f,
+		};
+
+		template <std::size_t N>
+		Float32 horner(const Float32 (&coefficients)[N], Float32 x) noexcept
+		{
+			Float32 y = coefficients[N - 1];
+
+			for (std::size_t i = N - 1; i > 0; i--)
+			{
+				y = y * x + coefficients[i - 1];
+			}
+
+			return y;
+		}
+
+		Float32 approximateToSrgb(Float32 x) noexcept
+		{
+			x = std::clamp(x, 0.f, 1.f);
+
+			return x < linearThreshold ? x * 12.92f : horner(toSrgb, std::sqrt(x));
+		}
+
+		Float32 approximateToLinear(Float32 x) noexcept
+		{
+			x = std::clamp(x, 0.f, 1.f);
+
+			return x <= srgbThreshold ? x * (1.f / 12.92f) : horner(toLinear, x);
+		}
+
+		const std::array<Float32, 256>& srgbTable() noexcept
+		{
+			static const auto table = []()
+			{
+				std::array<Float32, 256> t;
+
+				for (std::size_t i = 0; i < t.size(); i++)
+				{
+					t[i] = srgbToLinear(i / 255.f);
+				}
+
+				return t;
+			}();
+
+			return table;
+		}
+
+		constexpr UInt32 mul255(UInt32 a, UInt32 b) noexcept
+		{
+			const UInt32 t = a * b + 128;
+
+			return (t + (t >> 8)) >> 8;
+		}
+
+		UInt8 unpremultiplyChannel(UInt8 c, Float32 factor) noexcept
+		{
+			return static_cast<UInt8>((std::min)(c * factor + 0.5f, 255.f));
+		}
+
+#if defined(NENE_SIMD_SSE2)
+		template <std::size_t N>
+		__m128 horner(const Float32 (&coefficients)[N], __m128 x) noexcept
+		{
+			__m128 y = _mm_set1_ps(coefficients[N - 1]);
+
+			for (std::size_t i = N - 1; i > 0; i--)
+			{
+				y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(coefficients[i - 1]));
+			}
+
+			return y;
+		}
+
+		__m128 select(__m128 mask, __m128 a, __m128 b) noexcept
+		{
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+		}
+
+		__m128 alphaMask() noexcept
+		{
+			return _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+		}
+
+		__m128 clamp01(__m128 x) noexcept
+		{
+			return _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), _mm_set1_ps(1.f));
+		}
+
+		// Converts a linear pixel into sRGB keeping alpha.
+		__m128 approximateToSrgb(__m128 pixel) noexcept
+		{
+			const auto x      = clamp01(pixel);
+			const auto linear = _mm_mul_ps(x, _mm_set1_ps(12.92f));
+			const auto curve  = horner(toSrgb, _mm_sqrt_ps(x));
+			const auto srgb   = select(_mm_cmplt_ps(x, _mm_set1_ps(linearThreshold)), linear, curve);
+
+			return select(alphaMask(), x, srgb);
+		}
+
+		// Converts a sRGB pixel into linear keeping alpha.
+		__m128 approximateToLinear(__m128 pixel) noexcept
+		{
+			const auto x      = clamp01(pixel);
+			const auto linear = _mm_mul_ps(x, _mm_set1_ps(1.f / 12.92f));
+			const auto curve  = horner(toLinear, x);
+			const auto value  = select(_mm_cmple_ps(x, _mm_set1_ps(srgbThreshold)), linear, curve);
+
+			return select(alphaMask(), x, value);
+		}
+
+		__m128i toUnorm8(__m128 pixel) noexcept
+		{
+			return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(pixel, _mm_set1_ps(255.f)), _mm_set1_ps(0.5f)));
+		}
+
+		__m128 loadColor4(const Color4& c) noexcept
+		{
+			const auto zero = _mm_setzero_si128();
+			const auto v    = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(&c));
+
+			return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(v, zero), zero));
+		}
+
+		void store4(Color4* destination, __m128i p0, __m128i p1, __m128i p2, __m128i p3) noexcept
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3)));
+		}
+
+		__m128 broadcastAlpha(__m128 x) noexcept
+		{
+			return _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3));
+		}
+#endif
+	}
+
+	Float32 srgbToLinear(Float32 x) noexcept
+	{
+		return x <= srgbThreshold ? x / 12.92f : std::pow((x + 0.055f) / 1.055f, 2.4f);
+	}
+
+	Float32 linearToSrgb(Float32 x) noexcept
+	{
+		return x < linearThreshold ? x * 12.92f : 1.055f * std::pow(x, 1.f / 2.4f) - 0.055f;
+	}
+
+	void srgbToLinear(ArrayView<Color4> source, Color4f* destination) noexcept
+	{
+		const auto& table = srgbTable();
+
+		for (std::size_t i = 0; i < source.size(); i++)
+		{
+			const auto c = source[i];
+
+			destination[i] = { table[c.red], table[c.green], table[c.blue], c.alpha / 255.f };
+		}
+	}
+
+	void srgbToLinear(ArrayView<Color4f> source, Color4f* destination) noexcept
+	{
+		for (std::size_t i = 0; i < source.size(); i++)
+		{
+#if defined(NENE_SIMD_SSE2)
+			_mm_storeu_ps(&destination[i].red, approximateToLinear(_mm_loadu_ps(&source[i].red)));
+#else
+			const auto c = source[i];
+
+			destination[i] = { approximateToLinear(c.red), approximateToLinear(c.green), approximateToLinear(c.blue), std::clamp(c.alpha, 0.f, 1.f) };
+#endif
+		}
+	}
+
+	void linearToSrgb(ArrayView<Color4f> source, Color4* destination) noexcept
+	{
+		std::size_t i = 0;
+
+#if defined(NENE_SIMD_SSE2)
+		for (; i + 4 <= source.size(); i += 4)
+		{
+			store4(
+				destination + i,
+				toUnorm8(approximateToSrgb(_mm_loadu_ps(&source[i + 0].red))),
+				toUnorm8(approximateToSrgb(_mm_loadu_ps(&source[i + 1].red))),
+				toUnorm8(approximateToSrgb(_mm_loadu_ps(&source[i + 2].red))),
+				toUnorm8(approximateToSrgb(_mm_loadu_ps(&source[i + 3].red))));
+		}
+#endif
+
+		for (; i < source.size(); i++)
+		{
+			const auto c = source[i];
+
+			destination[i] =
+			{
+				Detail::toUnorm8(approximateToSrgb(c.red)),
+				Detail::toUnorm8(approximateToSrgb(c.green)),
+				Detail::toUnorm8(approximateToSrgb(c.blue)),
+				Detail::toUnorm8(c.alpha),
+			};
+		}
+	}
+
+	void linearToSrgb(ArrayView<Color4f> source, Color4f* destination) noexcept
+	{
+		for (std::size_t i = 0; i < source.size(); i++)
+		{
+#if defined(NENE_SIMD_SSE2)
+			_mm_storeu_ps(&destination[i].red, approximateToSrgb(_mm_loadu_ps(&source[i].red)));
+#else
+			const auto c = source[i];
+
+			destination[i] = { approximateToSrgb(c.red), approximateToSrgb(c.green), approximateToSrgb(c.blue), std::clamp(c.alpha, 0.f, 1.f) };
+#endif
+		}
+	}
+
+	void premultiply(ArrayView<Color4> source, Color4* destination) noexcept
+	{
+		std::size_t i = 0;
+
+#if defined(NENE_SIMD_SSE2)
+		const auto zero  = _mm_setzero_si128();
+		const auto c255  = _mm_set1_epi16(255);
+		const auto half  = _mm_set1_epi16(128);
+		const auto alpha = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+
+		const auto premultiply2 = [&](__m128i c)
+		{
+			const auto a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, 0xff), 0xff);
+			const auto t = _mm_add_epi16(_mm_mullo_epi16(c, _mm_or_si128(_mm_and_si128(alpha, c255), _mm_andnot_si128(alpha, a))), half);
+
+			return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+		};
+
+		for (; i + 4 <= source.size(); i += 4)
+		{
+			const auto c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&source[i]));
+
+			_mm_storeu_si128(
+				reinterpret_cast<__m128i*>(destination + i),
+				_mm_packus_epi16(premultiply2(_mm_unpacklo_epi8(c, zero)), premultiply2(_mm_unpackhi_epi8(c, zero))));
+		}
+#endif
+
+		for (; i < source.size(); i++)
+		{
+			const auto c = source[i];
+
+			destination[i] =
+			{
+				static_cast<UInt8>(mul255(c.red  , c.alpha)),
+				static_cast<UInt8>(mul255(c.green, c.alpha)),
+				static_cast<UInt8>(mul255(c.blue , c.alpha)),
+				c.alpha,
+			};
+		}
+	}
+
+	void premultiply(ArrayView<Color4f> source, Color4f* destination) noexcept
+	{
+		for (std::size_t i = 0; i < source.size(); i++)
+		{
+#if defined(NENE_SIMD_SSE2)
+			const auto c = _mm_loadu_ps(&source[i].red);
+
+			_mm_storeu_ps(&destination[i].red, _mm_mul_ps(c, select(alphaMask(), _mm_set1_ps(1.f), broadcastAlpha(c))));
+#else
+			const auto c = source[i];
+
+			destination[i] = { c.red * c.alpha, c.green * c.alpha, c.blue * c.alpha, c.alpha };
+#endif
+		}
+	}
+
+	void unpremultiply(ArrayView<Color4> source, Color4* destination) noexcept
+	{
+		std::size_t i = 0;
+
+#if defined(NENE_SIMD_SSE2)
+		const auto unpremultiply1 = [](const Color4& color)
+		{
+			const auto c      = loadColor4(color);
+			const auto a      = broadcastAlpha(c);
+			const auto factor = _mm_andnot_ps(_mm_cmpeq_ps(a, _mm_setzero_ps()), _mm_div_ps(_mm_set1_ps(255.f), a));
+			const auto value  = _mm_min_ps(_mm_add_ps(_mm_mul_ps(c, factor), _mm_set1_ps(0.5f)), _mm_set1_ps(255.f));
+
+			return _mm_cvttps_epi32(select(alphaMask(), c, value));
+		};
+
+		for (; i + 4 <= source.size(); i += 4)
+		{
+			store4(
+				destination + i,
+				unpremultiply1(source[i + 0]),
+				unpremultiply1(source[i + 1]),
+				unpremultiply1(source[i + 2]),
+				unpremultiply1(source[i + 3]));
+		}
+#endif
+
+		for (; i < source.size(); i++)
+		{
+			const auto c      = source[i];
+			const auto factor = c.alpha > 0 ? 255.f / c.alpha : 0.f;
+
+			destination[i] =
+			{
+				unpremultiplyChannel(c.red  , factor),
+				unpremultiplyChannel(c.green, factor),
+				unpremultiplyChannel(c.blue , factor),
+				c.alpha,
+			};
+		}
+	}
+
+	void unpremultiply(ArrayView<Color4f> source, Color4f* destination) noexcept
+	{
+		for (std::size_t i = 0; i < source.size(); i++)
+		{
+#if defined(NENE_SIMD_SSE2)
+			const auto c      = _mm_loadu_ps(&source[i].red);
+			const auto a      = broadcastAlpha(c);
+			const auto factor = _mm_andnot_ps(_mm_cmpeq_ps(a, _mm_setzero_ps()), _mm_div_ps(_mm_set1_ps(1.f), a));
+
+			_mm_storeu_ps(&destination[i].red, _mm_mul_ps(c, select(alphaMask(), _mm_set1_ps(1.f), factor)));
+#else
+			const auto c      = source[i];
+			const auto factor = c.alpha != 0.f ? 1.f / c.alpha : 0.f;
+
+			destination[i] = { c.red * factor, c.green * factor, c.blue * factor, c.alpha };
+#endif
+		}
+	}
+
+	void premultiply(MutableImageView image) noexcept
+	{
+		for (Int32 y = 0; y < image.height(); y++)
+		{
+			const auto row = image.row(y);
+
+			premultiply(ArrayView<Color4> { row, static_cast<std::size_t>(image.width()) }, row);
+		}
+	}
+
+	void unpremultiply(MutableImageView image) noexcept
+	{
+		for (Int32 y = 0; y < image.height(); y++)
+		{
+			const auto row = image.row(y);
+
+			unpremultiply(ArrayView<Color4> { row, static_cast<std::size_t>(image.width()) }, row);
+		}
+	}
+
+	ImageRGBA32F srgbToLinear(ImageView image)
+	{
+		ImageRGBA32F result { image.size() };
+
+		for (Int32 y = 0; y < image.height(); y++)
+		{
+			srgbToLinear(ArrayView<Color4> { image.row(y), static_cast<std::size_t>(image.width()) }, result.row(y));
+		}
+
+		return result;
+	}
+
+	Image linearToSrgb(BasicImageView<Color4f> image)
+	{
+		Image result { image.size() };
+
+		for (Int32 y = 0; y < image.height(); y++)
+		{
+			linearToSrgb(ArrayView<Color4f> { image.row(y), static_cast<std::size_t>(image.width()) }, result.row(y));
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,157 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_IMAGEPROCESSING_COLORSPACE_HPP
+#define INCLUDE_NENE_IMAGEPROCESSING_COLORSPACE_HPP
+
+#include "../ArrayView.hpp"
+#include "../Image.hpp"
+
+namespace Nene::ImageProcessing
+{
+	/**
+	 * @brief      Converts a sRGB encoded value into linear.
+	 *
+	 * @param[in]  x     The sRGB value in [0, 1].
+	 *
+	 * @return     The linear value.
+	 */
+	[[nodiscard]]
+	Float32 srgbToLinear(Float32 x) noexcept;
+
+	/**
+	 * @brief      Converts a linear value into sRGB encoding.
+	 *
+	 * @param[in]  x     The linear value in [0, 1].
+	 *
+	 * @return     The sRGB value.
+	 */
+	[[nodiscard]]
+	Float32 linearToSrgb(Float32 x) noexcept;
+
+	/**
+	 * @brief      Converts sRGB colors into linear colors.
+	 *
+	 *             Alpha is kept linear.
+	 *
+	 * @param[in]  source       The sRGB colors.
+	 * @param[out] destination  The linear colors, `source.size()` elements.
+	 */
+	void srgbToLinear(ArrayView<Color4> source, Color4f* destination) noexcept;
+
+	/**
+	 * @brief      Converts sRGB colors into linear colors.
+	 *
+	 * @param[in]  source       The sRGB colors.
+	 * @param[out] destination  The linear colors, may be equal to `source`.
+	 */
+	void srgbToLinear(ArrayView<Color4f> source, Color4f* destination) noexcept;
+
+	/**
+	 * @brief      Converts linear colors into sRGB colors.
+	 *
+	 *             The encoding is approximated within 0.05 of the 8bit step.
+	 *
+	 * @param[in]  source       The linear colors.
+	 * @param[out] destination  The sRGB colors, `source.size()` elements.
+	 */
+	void linearToSrgb(ArrayView<Color4f> source, Color4* destination) noexcept;
+
+	/**
+	 * @brief      Converts linear colors into sRGB colors.
+	 *
+	 * @param[in]  source       The linear colors.
+	 * @param[out] destination  The sRGB colors, may be equal to `source`.
+	 */
+	void linearToSrgb(ArrayView<Color4f> source, Color4f* destination) noexcept;
+
+	/**
+	 * @brief      Multiplies the color channels by alpha.
+	 *
+	 * @param[in]  source       The straight alpha colors.
+	 * @param[out] destination  The premultiplied colors, may be equal to `source`.
+	 */
+	void premultiply(ArrayView<Color4> source, Color4* destination) noexcept;
+
+	/**
+	 * @brief      Multiplies the color channels by alpha.
+	 *
+	 * @param[in]  source       The straight alpha colors.
+	 * @param[out] destination  The premultiplied colors, may be equal to `source`.
+	 */
+	void premultiply(ArrayView<Color4f> source, Color4f* destination) noexcept;
+
+	/**
+	 * @brief      Divides the color channels by alpha.
+	 *
+	 *             Colors of transparent pixels become black.
+	 *
+	 * @param[in]  source       The premultiplied colors.
+	 * @param[out] destination  The straight alpha colors, may be equal to `source`.
+	 */
+	void unpremultiply(ArrayView<Color4> source, Color4* destination) noexcept;
+
+	/**
+	 * @brief      Divides the color channels by alpha.
+	 *
+	 * @param[in]  source       The premultiplied colors.
+	 * @param[out] destination  The straight alpha colors, may be equal to `source`.
+	 */
+	void unpremultiply(ArrayView<Color4f> source, Color4f* destination) noexcept;
+
+	/**
+	 * @brief      Multiplies the color channels of the image by alpha.
+	 *
+	 * @param      image  The image to convert in place.
+	 */
+	void premultiply(MutableImageView image) noexcept;
+
+	/**
+	 * @brief      Divides the color channels of the image by alpha.
+	 *
+	 * @param      image  The image to convert in place.
+	 */
+	void unpremultiply(MutableImageView image) noexcept;
+
+	/**
+	 * @brief      Converts the sRGB image into linear.
+	 *
+	 * @param[in]  image  The sRGB image.
+	 *
+	 * @return     The linear image.
+	 */
+	[[nodiscard]]
+	ImageRGBA32F srgbToLinear(ImageView image);
+
+	/**
+	 * @brief      Converts the linear image into sRGB.
+	 *
+	 * @param[in]  image  The linear image.
+	 *
+	 * @return     The sRGB image.
+	 */
+	[[nodiscard]]
+	Image linearToSrgb(BasicImageView<Color4f> image);
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGEPROCESSING_COLORSPACE_HPP
@@ -0,0 +1,564 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "../Platform.hpp"
+#include "Composite.hpp"
+
+#if defined(NENE_SIMD_SSE2)
+#  include <emmintrin.h>
+#endif
+
+#if defined(NENE_SIMD_AVX2)
+#  include <immintrin.h>
+#endif
+
+namespace Nene::ImageProcessing
+{
+	namespace
+	{
+		// Rounded `a * b / 255` for 8bit values.
+		constexpr UInt32 mul255(UInt32 a, UInt32 b) noexcept
+		{
+			const UInt32 t = a * b + 128;
+
+			return (t + (t >> 8)) >> 8;
+		}
+
+		template <BlendMode Mode, bool Premultiplied>
+		Color4 blendPixel(Color4 s, const Color4& d) noexcept
+		{
+			const UInt32 sa = s.alpha;
+
+			if constexpr (!Premultiplied)
+			{
+				s.red   = static_cast<UInt8>(mul255(s.red  , sa));
+				s.green = static_cast<UInt8>(mul255(s.green, sa));
+				s.blue  = static_cast<UInt8>(mul255(s.blue , sa));
+			}
+
+			const UInt32 inv = 255 - sa;
+
+			const auto channel = [&](UInt32 sc, UInt32 dc) -> UInt8
+			{
+				switch (Mode)
+				{
+					case BlendMode::additive: return static_cast<UInt8>((std::min)(sc + dc, 255u));
+					case BlendMode::multiply: return static_cast<UInt8>(mul255(dc, (std::min)(sc + inv, 255u)));
+					case BlendMode::screen  : return static_cast<UInt8>(sc + dc - mul255(sc, dc));
+					default                 : return static_cast<UInt8>((std::min)(sc + mul255(dc, inv), 255u));
+				}
+			};
+
+			return
+			{
+				channel(s.red  , d.red  ),
+				channel(s.green, d.green),
+				channel(s.blue , d.blue ),
+				static_cast<UInt8>(sa + mul255(d.alpha, inv)),
+			};
+		}
+
+		// Blends onto a straight alpha destination and normalizes the result by its alpha.
+		template <BlendMode Mode, bool Premultiplied>
+		Color4 blendStraightPixel(Color4 s, const Color4& d) noexcept
+		{
+			if (d.alpha == 255)
+			{
+				return blendPixel<Mode, Premultiplied>(s, d);
+			}
+
+			// Every mode keeps the destination under a transparent source.
+			if (s.alpha == 0)
+			{
+				return d;
+			}
+
+			const UInt32 sa = s.alpha;
+			const UInt32 da = d.alpha;
+			const UInt32 oa = sa + mul255(da, 255 - sa);
+
+			if (oa == 0)
+			{
+				return { 0, 0, 0, 0 };
+			}
+
+			if constexpr (!Premultiplied)
+			{
+				s.red   = static_cast<UInt8>(mul255(s.red  , sa));
+				s.green = static_cast<UInt8>(mul255(s.green, sa));
+				s.blue  = static_cast<UInt8>(mul255(s.blue , sa));
+			}
+
+			const auto channel = [&](UInt32 sc, UInt32 dc) -> UInt8
+			{
+				dc = mul255(dc, da);
+
+				UInt32 c;
+
+				switch (Mode)
+				{
+					case BlendMode::additive: c = sc + dc; break;
+					case BlendMode::multiply: c = mul255(sc, 255 - da) + mul255(dc, 255 - sa) + mul255(sc, dc); break;
+					case BlendMode::screen  : c = sc + dc - mul255(sc, dc); break;
+					default                 : c = sc + mul255(dc, 255 - sa); break;
+				}
+
+				return static_cast<UInt8>((std::min)((c * 255 + oa / 2) / oa, 255u));
+			};
+
+			return
+			{
+				channel(s.red  , d.red  ),
+				channel(s.green, d.green),
+				channel(s.blue , d.blue ),
+				static_cast<UInt8>(oa),
+			};
+		}
+
+#if defined(NENE_SIMD_SSE2)
+		// 16bit lane operations of 128bit vectors, 2 pixels per vector.
+		struct Sse2
+		{
+			using vector_type = __m128i;
+
+			static constexpr std::size_t pixels = 4;
+
+			static vector_type load(const void* p) noexcept { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+			static void store(void* p, vector_type a) noexcept { _mm_storeu_si128(static_cast<__m128i*>(p), a); }
+			static vector_type zero() noexcept { return _mm_setzero_si128(); }
+			static vector_type set1(Int16 x) noexcept { return _mm_set1_epi16(x); }
+			static vector_type alphaMask() noexcept { return _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0); }
+			static vector_type add(vector_type a, vector_type b) noexcept { return _mm_add_epi16(a, b); }
+			static vector_type sub(vector_type a, vector_type b) noexcept { return _mm_sub_epi16(a, b); }
+			static vector_type mullo(vector_type a, vector_type b) noexcept { return _mm_mullo_epi16(a, b); }
+			static vector_type min(vector_type a, vector_type b) noexcept { return _mm_min_epi16(a, b); }
+			static vector_type srli8(vector_type a) noexcept { return _mm_srli_epi16(a, 8); }
+			static vector_type select(vector_type mask, vector_type a, vector_type b) noexcept { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+			static vector_type broadcastAlpha(vector_type a) noexcept { return _mm_shufflehi_epi16(_mm_shufflelo_epi16(a, 0xff), 0xff); }
+			static vector_type unpacklo(vector_type a) noexcept { return _mm_unpacklo_epi8(a, _mm_setzero_si128()); }
+			static vector_type unpackhi(vector_type a) noexcept { return _mm_unpackhi_epi8(a, _mm_setzero_si128()); }
+			static vector_type pack(vector_type a, vector_type b) noexcept { return _mm_packus_epi16(a, b); }
+			static bool opaque(vector_type a) noexcept { return (_mm_movemask_epi8(_mm_cmpeq_epi8(a, _mm_set1_epi8(-1))) & 0x8888) == 0x8888; }
+		};
+#endif
+
+#if defined(NENE_SIMD_AVX2)
+		// 16bit lane operations of 256bit vectors, 4 pixels per vector.
+		struct Avx2
+		{
+			using vector_type = __m256i;
+
+			static constexpr std::size_t pixels = 8;
+
+			static vector_type load(const void* p) noexcept { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+			static void store(void* p, vector_type a) noexcept { _mm256_storeu_si256(static_cast<__m256i*>(p), a); }
+			static vector_type zero() noexcept { return _mm256_setzero_si256(); }
+			static vector_type set1(Int16 x) noexcept { return _mm256_set1_epi16(x); }
+			static vector_type alphaMask() noexcept { return _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0); }
+			static vector_type add(vector_type a, vector_type b) noexcept { return _mm256_add_epi16(a, b); }
+			static vector_type sub(vector_type a, vector_type b) noexcept { return _mm256_sub_epi16(a, b); }
+			static vector_type mullo(vector_type a, vector_type b) noexcept { return _mm256_mullo_epi16(a, b); }
+			static vector_type min(vector_type a, vector_type b) noexcept { return _mm256_min_epi16(a, b); }
+			static vector_type srli8(vector_type a) noexcept { return _mm256_srli_epi16(a, 8); }
+			static vector_type select(vector_type mask, vector_type a, vector_type b) noexcept { return _mm256_blendv_epi8(b, a, mask); }
+			static vector_type broadcastAlpha(vector_type a) noexcept { return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(a, 0xff), 0xff); }
+			static vector_type unpacklo(vector_type a) noexcept { return _mm256_unpacklo_epi8(a, _mm256_setzero_si256()); }
+			static vector_type unpackhi(vector_type a) noexcept { return _mm256_unpackhi_epi8(a, _mm256_setzero_si256()); }
+			static vector_type pack(vector_type a, vector_type b) noexcept { return _mm256_packus_epi16(a, b); }
+			static bool opaque(vector_type a) noexcept { return (static_cast<UInt32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, _mm256_set1_epi8(-1)))) & 0x88888888u) == 0x88888888u; }
+		};
+#endif
+
+		template <typename Simd>
+		typename Simd::vector_type mul255(typename Simd::vector_type a, typename Simd::vector_type b) noexcept
+		{
+			const auto t = Simd::add(Simd::mullo(a, b), Simd::set1(128));
+
+			return Simd::srli8(Simd::add(t, Simd::srli8(t)));
+		}
+
+		// Same arithmetic as `blendPixel()` on 16bit lanes.
+		template <typename Simd, BlendMode Mode, bool Premultiplied>
+		typename Simd::vector_type blendLanes(typename Simd::vector_type s, typename Simd::vector_type d) noexcept
+		{
+			const auto c255  = Simd::set1(255);
+			const auto alpha = Simd::alphaMask();
+			const auto sa    = Simd::broadcastAlpha(s);
+
+			if constexpr (!Premultiplied)
+			{
+				s = mul255<Simd>(s, Simd::select(alpha, c255, sa));
+			}
+
+			const auto inv  = Simd::sub(c255, sa);
+			const auto over = Simd::add(s, mul255<Simd>(d, inv));
+
+			switch (Mode)
+			{
+				case BlendMode::additive:
+					return Simd::select(alpha, over, Simd::min(Simd::add(s, d), c255));
+
+				case BlendMode::multiply:
+					return Simd::select(alpha, over, mul255<Simd>(d, Simd::min(Simd::add(s, inv), c255)));
+
+				case BlendMode::screen:
+					return Simd::select(alpha, over, Simd::sub(Simd::add(s, d), mul255<Simd>(s, d)));
+
+				default:
+					return over;
+			}
+		}
+
+		// The vector kernels treat the destination as premultiplied, which equals straight alpha only when it is opaque.
+		template <BlendMode Mode, bool Premultiplied, bool StraightDestination>
+		void blendRow(const Color4* source, Color4* destination, std::size_t count) noexcept
+		{
+			std::size_t i = 0;
+
+			[[maybe_unused]] const auto vectorize = [&](auto simd)
+			{
+				using Simd = decltype(simd);
+
+				for (; i + Simd::pixels <= count; i += Simd::pixels)
+				{
+					const auto s = Simd::load(source + i);
+					const auto d = Simd::load(destination + i);
+
+					if constexpr (StraightDestination)
+					{
+						if (!Simd::opaque(d))
+						{
+							for (std::size_t k = i; k < i + Simd::pixels; k++)
+							{
+								destination[k] = blendStraightPixel<Mode, Premultiplied>(source[k], destination[k]);
+							}
+							continue;
+						}
+					}
+
+					const auto lo = blendLanes<Simd, Mode, Premultiplied>(Simd::unpacklo(s), Simd::unpacklo(d));
+					const auto hi = blendLanes<Simd, Mode, Premultiplied>(Simd::unpackhi(s), Simd::unpackhi(d));
+
+					Simd::store(destination + i, Simd::pack(lo, hi));
+				}
+			};
+
+#if defined(NENE_SIMD_AVX2)
+			vectorize(Avx2 {});
+#endif
+
+#if defined(NENE_SIMD_SSE2)
+			vectorize(Sse2 {});
+#endif
+
+			for (; i < count; i++)
+			{
+				if constexpr (StraightDestination)
+				{
+					destination[i] = blendStraightPixel<Mode, Premultiplied>(source[i], destination[i]);
+				}
+				else
+				{
+					destination[i] = blendPixel<Mode, Premultiplied>(source[i], destination[i]);
+				}
+			}
+		}
+
+		template <bool Premultiplied, bool StraightDestination>
+		void blendRow(const Color4* source, Color4* destination, std::size_t count, BlendMode mode) noexcept
+		{
+			switch (mode)
+			{
+				case BlendMode::additive: blendRow<BlendMode::additive  , Premultiplied, StraightDestination>(source, destination, count); break;
+				case BlendMode::multiply: blendRow<BlendMode::multiply  , Premultiplied, StraightDestination>(source, destination, count); break;
+				case BlendMode::screen  : blendRow<BlendMode::screen    , Premultiplied, StraightDestination>(source, destination, count); break;
+				default                 : blendRow<BlendMode::sourceOver, Premultiplied, StraightDestination>(source, destination, count); break;
+			}
+		}
+
+		[[nodiscard]]
+		Rectanglei intersect(const Rectanglei& a, const Rectanglei& b) noexcept
+		{
+			const auto left   = (std::max)(a.left()  , b.left()  );
+			const auto top    = (std::max)(a.top()   , b.top()   );
+			const auto right  = (std::min)(a.right() , b.right() );
+			const auto bottom = (std::min)(a.bottom(), b.bottom());
+
+			return { left, top, (std::max)(left, right), (std::max)(top, bottom) };
+		}
+
+		[[nodiscard]]
+		Rectanglei bounds(const Size2Di& size) noexcept
+		{
+			return { { 0, 0 }, size };
+		}
+
+		template <typename Function>
+		void forEachRow(ImageView source, MutableImageView destination, const Vector2Di& position, const Rectanglei& clip, Function&& function) noexcept
+		{
+			const auto rect = intersect(intersect(Rectanglei { position, source.size() }, clip), bounds(destination.size()));
+
+			for (Int32 y = rect.top(); y < rect.bottom(); y++)
+			{
+				function(
+					source.row(y - position.y) + (rect.left() - position.x),
+					destination.row(y) + rect.left(),
+					static_cast<std::size_t>(rect.width()));
+			}
+		}
+
+		// Bilinear sampler returning premultiplied colors. Weights are 8bit.
+		class Sampler
+		{
+			ImageView source_;
+			bool      premultiplied_;
+
+			[[nodiscard]]
+			UInt32 fetch(Int32 x, Int32 y) const noexcept
+			{
+				if (x < 0 || y < 0 || x >= source_.width() || y >= source_.height())
+				{
+					return 0;
+				}
+
+				UInt32 p;
+				std::memcpy(&p, &source_(x, y), sizeof(p));
+
+				return p;
+			}
+
+		public:
+			explicit Sampler(ImageView source, bool premultiplied) noexcept
+				: source_(source)
+				, premultiplied_(premultiplied) {}
+
+			[[nodiscard]]
+			Color4 sample(Float32 u, Float32 v) const noexcept
+			{
+				const auto fu = std::floor(u);
+				const auto fv = std::floor(v);
+				const auto x  = static_cast<Int32>(fu);
+				const auto y  = static_cast<Int32>(fv);
+
+				if (x < -1 || y < -1 || x >= source_.width() || y >= source_.height())
+				{
+					return { 0, 0, 0, 0 };
+				}
+
+				const auto wx = static_cast<Int32>((u - fu) * 256.f + 0.5f);
+				const auto wy = static_cast<Int32>((v - fv) * 256.f + 0.5f);
+
+				UInt32 p[4];
+
+				if (x >= 0 && y >= 0 && x + 1 < source_.width() && y + 1 < source_.height())
+				{
+					std::memcpy(&p[0], &source_(x, y    ), sizeof(UInt32) * 2);
+					std::memcpy(&p[2], &source_(x, y + 1), sizeof(UInt32) * 2);
+				}
+				else
+				{
+					p[0] = fetch(x    , y    );
+					p[1] = fetch(x + 1, y    );
+					p[2] = fetch(x    , y + 1);
+					p[3] = fetch(x + 1, y + 1);
+				}
+
+#if defined(NENE_SIMD_SSE2)
+				const auto c255  = _mm_set1_epi16(255);
+				const auto alpha = Sse2::alphaMask();
+
+				auto top    = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&p[0])), _mm_setzero_si128());
+				auto bottom = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&p[2])), _mm_setzero_si128());
+
+				if (!premultiplied_)
+				{
+					top    = mul255<Sse2>(top   , Sse2::select(alpha, c255, Sse2::broadcastAlpha(top   )));
+					bottom = mul255<Sse2>(bottom, Sse2::select(alpha, c255, Sse2::broadcastAlpha(bottom)));
+				}
+
+				const auto half     = _mm_set1_epi16(128);
+				const auto vertical = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(
+					_mm_mullo_epi16(top   , _mm_set1_epi16(static_cast<Int16>(256 - wy))),
+					_mm_mullo_epi16(bottom, _mm_set1_epi16(static_cast<Int16>(wy)))), half), 8);
+
+				const auto weighted = _mm_mullo_epi16(vertical, _mm_set_epi16(
+					static_cast<Int16>(wx), static_cast<Int16>(wx), static_cast<Int16>(wx), static_cast<Int16>(wx),
+					static_cast<Int16>(256 - wx), static_cast<Int16>(256 - wx), static_cast<Int16>(256 - wx), static_cast<Int16>(256 - wx)));
+
+				const auto result = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(weighted, _mm_srli_si128(weighted, 8)), half), 8);
+
+				Color4 color;
+				const auto packed = _mm_cvtsi128_si32(_mm_packus_epi16(result, result));
+				std::memcpy(&color, &packed, sizeof(color));
+
+				return color;
+#else
+				Color4 c[4];
+				std::memcpy(c, p, sizeof(c));
+
+				if (!premultiplied_)
+				{
+					for (auto& texel : c)
+					{
+						texel = { static_cast<UInt8>(mul255(texel.red, texel.alpha)), static_cast<UInt8>(mul255(texel.green, texel.alpha)), static_cast<UInt8>(mul255(texel.blue, texel.alpha)), texel.alpha };
+					}
+				}
+
+				const auto lerp = [&](UInt8 Color4::* channel) -> UInt8
+				{
+					const UInt32 left  = (c[0].*channel * (256 - wy) + c[2].*channel * wy + 128) >> 8;
+					const UInt32 right = (c[1].*channel * (256 - wy) + c[3].*channel * wy + 128) >> 8;
+
+					return static_cast<UInt8>((left * (256 - wx) + right * wx + 128) >> 8);
+				};
+
+				return { lerp(&Color4::red), lerp(&Color4::green), lerp(&Color4::blue), lerp(&Color4::alpha) };
+#endif
+			}
+		};
+	}
+
+	void compositeRow(const Color4* source, Color4* destination, std::size_t count, BlendMode mode, AlphaMode alphaMode) noexcept
+	{
+		if (alphaMode == AlphaMode::premultiplied)
+		{
+			blendRow<true, false>(source, destination, count, mode);
+		}
+		else
+		{
+			blendRow<false, true>(source, destination, count, mode);
+		}
+	}
+
+	void blit(ImageView source, MutableImageView destination, const Vector2Di& position) noexcept
+	{
+		blit(source, destination, position, bounds(destination.size()));
+	}
+
+	void blit(ImageView source, MutableImageView destination, const Vector2Di& position, const Rectanglei& clip) noexcept
+	{
+		forEachRow(source, destination, position, clip, [](const Color4* s, Color4* d, std::size_t count)
+		{
+			std::memmove(d, s, sizeof(Color4) * count);
+		});
+	}
+
+	void composite(ImageView source, MutableImageView destination, const Vector2Di& position, BlendMode mode, AlphaMode alphaMode) noexcept
+	{
+		composite(source, destination, position, bounds(destination.size()), mode, alphaMode);
+	}
+
+	void composite(ImageView source, MutableImageView destination, const Vector2Di& position, const Rectanglei& clip, BlendMode mode, AlphaMode alphaMode) noexcept
+	{
+		forEachRow(source, destination, position, clip, [&](const Color4* s, Color4* d, std::size_t count)
+		{
+			compositeRow(s, d, count, mode, alphaMode);
+		});
+	}
+
+	void composite(ImageView source, MutableImageView destination, const Matrix3x2f& transform, BlendMode mode, AlphaMode alphaMode)
+	{
+		composite(source, destination, transform, bounds(destination.size()), mode, alphaMode);
+	}
+
+	void composite(ImageView source, MutableImageView destination, const Matrix3x2f& transform, const Rectanglei& clip, BlendMode mode, AlphaMode alphaMode)
+	{
+		const auto inverse = transform.inverse();
+
+		if (!inverse || source.empty())
+		{
+			return;
+		}
+
+		// Destination bounding box of the source.
+		const auto w = static_cast<Float32>(source.width());
+		const auto h = static_cast<Float32>(source.height());
+
+		const Vector2Df corners[] =
+		{
+			transform.transform({ 0, 0 }),
+			transform.transform({ w, 0 }),
+			transform.transform({ 0, h }),
+			transform.transform({ w, h }),
+		};
+
+		Float32 left = corners[0].x, top = corners[0].y, right = corners[0].x, bottom = corners[0].y;
+
+		for (const auto& corner : corners)
+		{
+			left   = (std::min)(left  , corner.x);
+			top    = (std::min)(top   , corner.y);
+			right  = (std::max)(right , corner.x);
+			bottom = (std::max)(bottom, corner.y);
+		}
+
+		// Clamp before converting into integers.
+		const auto clampToInt = [](Float32 x)
+		{
+			return static_cast<Int32>(std::clamp(x, -1.0e9f, 1.0e9f));
+		};
+
+		const auto rect = intersect(
+			intersect(Rectanglei { clampToInt(std::floor(left)), clampToInt(std::floor(top)), clampToInt(std::ceil(right)) + 1, clampToInt(std::ceil(bottom)) + 1 }, clip),
+			bounds(destination.size()));
+
+		if (rect.width() <= 0 || rect.height() <= 0)
+		{
+			return;
+		}
+
+		const Sampler sampler { source, alphaMode == AlphaMode::premultiplied };
+
+		std::vector<Color4> buffer(static_cast<std::size_t>(rect.width()));
+
+		for (Int32 y = rect.top(); y < rect.bottom(); y++)
+		{
+			// Sample at the pixel centers.
+			auto uv = inverse->transform({ rect.left() + 0.5f, y + 0.5f }) - Vector2Df { 0.5f, 0.5f };
+
+			for (auto& texel : buffer)
+			{
+				texel = sampler.sample(uv.x, uv.y);
+
+				uv.x += inverse->_11;
+				uv.y += inverse->_12;
+			}
+
+			// The samples are premultiplied regardless of the alpha mode.
+			const auto row = destination.row(y) + rect.left();
+
+			if (alphaMode == AlphaMode::premultiplied)
+			{
+				blendRow<true, false>(buffer.data(), row, buffer.size(), mode);
+			}
+			else
+			{
+				blendRow<true, true>(buffer.data(), row, buffer.size(), mode);
+			}
+		}
+	}
+}
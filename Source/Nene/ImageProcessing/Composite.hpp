@@ -0,0 +1,137 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_IMAGEPROCESSING_COMPOSITE_HPP
+#define INCLUDE_NENE_IMAGEPROCESSING_COMPOSITE_HPP
+
+#include "../ImageView.hpp"
+#include "../Matrix3x2.hpp"
+
+namespace Nene::ImageProcessing
+{
+	/**
+	 * @brief      Blend modes.
+	 *
+	 *             Every mode combines the alpha channels as source-over.
+	 */
+	enum class BlendMode: Int32
+	{
+		sourceOver,
+		additive,
+		multiply,
+		screen,
+	};
+
+	/**
+	 * @brief      Alpha representations of the images.
+	 *
+	 *             The mode applies to the source, the destination and the
+	 *             result alike.
+	 */
+	enum class AlphaMode: Int32
+	{
+		straight,
+		premultiplied,
+	};
+
+	/**
+	 * @brief      Blends a row of pixels onto another.
+	 *
+	 * @param[in]  source       The source pixels.
+	 * @param      destination  The destination pixels.
+	 * @param[in]  count        Number of the pixels.
+	 * @param[in]  mode         The blend mode.
+	 * @param[in]  alphaMode    The alpha representation of `source` and `destination`.
+	 */
+	void compositeRow(const Color4* source, Color4* destination, std::size_t count, BlendMode mode, AlphaMode alphaMode) noexcept;
+
+	/**
+	 * @brief      Copies the image onto another.
+	 *
+	 * @param[in]  source       The source image.
+	 * @param[out] destination  The destination image.
+	 * @param[in]  position     The destination position of the top left of `source`.
+	 */
+	void blit(ImageView source, MutableImageView destination, const Vector2Di& position) noexcept;
+
+	/**
+	 * @brief      Copies the image onto another.
+	 *
+	 * @param[in]  source       The source image.
+	 * @param[out] destination  The destination image.
+	 * @param[in]  position     The destination position of the top left of `source`.
+	 * @param[in]  clip         The destination rectangle to write.
+	 */
+	void blit(ImageView source, MutableImageView destination, const Vector2Di& position, const Rectanglei& clip) noexcept;
+
+	/**
+	 * @brief      Blends the image onto another.
+	 *
+	 * @param[in]  source       The source image.
+	 * @param      destination  The destination image.
+	 * @param[in]  position     The destination position of the top left of `source`.
+	 * @param[in]  mode         The blend mode.
+	 * @param[in]  alphaMode    The alpha representation of `source` and `destination`.
+	 */
+	void composite(ImageView source, MutableImageView destination, const Vector2Di& position, BlendMode mode = BlendMode::sourceOver, AlphaMode alphaMode = AlphaMode::straight) noexcept;
+
+	/**
+	 * @brief      Blends the image onto another.
+	 *
+	 * @param[in]  source       The source image.
+	 * @param      destination  The destination image.
+	 * @param[in]  position     The destination position of the top left of `source`.
+	 * @param[in]  clip         The destination rectangle to write.
+	 * @param[in]  mode         The blend mode.
+	 * @param[in]  alphaMode    The alpha representation of `source` and `destination`.
+	 */
+	void composite(ImageView source, MutableImageView destination, const Vector2Di& position, const Rectanglei& clip, BlendMode mode = BlendMode::sourceOver, AlphaMode alphaMode = AlphaMode::straight) noexcept;
+
+	/**
+	 * @brief      Blends the transformed image onto another.
+	 *
+	 *             The source is sampled bilinearly; outside of it is
+	 *             transparent.
+	 *
+	 * @param[in]  source       The source image.
+	 * @param      destination  The destination image.
+	 * @param[in]  transform    The transform from the source into the destination coordinates.
+	 * @param[in]  mode         The blend mode.
+	 * @param[in]  alphaMode    The alpha representation of `source` and `destination`.
+	 */
+	void composite(ImageView source, MutableImageView destination, const Matrix3x2f& transform, BlendMode mode = BlendMode::sourceOver, AlphaMode alphaMode = AlphaMode::straight);
+
+	/**
+	 * @brief      Blends the transformed image onto another.
+	 *
+	 * @param[in]  source       The source image.
+	 * @param      destination  The destination image.
+	 * @param[in]  transform    The transform from the source into the destination coordinates.
+	 * @param[in]  clip         The destination rectangle to write.
+	 * @param[in]  mode         The blend mode.
+	 * @param[in]  alphaMode    The alpha representation of `source` and `destination`.
+	 */
+	void composite(ImageView source, MutableImageView destination, const Matrix3x2f& transform, const Rectanglei& clip, BlendMode mode = BlendMode::sourceOver, AlphaMode alphaMode = AlphaMode::straight);
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGEPROCESSING_COMPOSITE_HPP
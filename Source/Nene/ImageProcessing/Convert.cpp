@@ -0,0 +1,195 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#include "../Platform.hpp"
+#include "Convert.hpp"
+
+#if defined(NENE_SIMD_SSSE3)
+#  include <tmmintrin.h>
+#elif defined(NENE_SIMD_SSE2)
+#  include <emmintrin.h>
+#endif
+
+namespace Nene::ImageProcessing
+{
+	namespace
+	{
+		static_assert(sizeof(PixelRGBA8) == 4 && sizeof(PixelBGRA8) == 4);
+
+		// Swaps the 1st and 3rd bytes of each 32bit pixel.
+		void swapRedBlue(const void* source, void* destination, std::size_t count) noexcept
+		{
+			auto src = static_cast<const UInt8*>(source);
+			auto dst = static_cast<UInt8*>(destination);
+
+			std::size_t i = 0;
+
+#if defined(NENE_SIMD_SSSE3)
+			const auto shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+			for (; i + 4 <= count; i += 4)
+			{
+				const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_shuffle_epi8(v, shuffle));
+			}
+#elif defined(NENE_SIMD_SSE2)
+			const auto maskGA = _mm_set1_epi32(0xff00ff00);
+			const auto maskR  = _mm_set1_epi32(0x000000ff);
+
+			for (; i + 4 <= count; i += 4)
+			{
+				const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+
+				const auto ga = _mm_and_si128(v, maskGA);
+				const auto r  = _mm_and_si128(_mm_srli_epi32(v, 16), maskR);
+				const auto b  = _mm_slli_epi32(_mm_and_si128(v, maskR), 16);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_or_si128(ga, _mm_or_si128(r, b)));
+			}
+#endif
+
+			for (; i < count; i++)
+			{
+				const UInt8 p0 = src[i * 4 + 0];
+				const UInt8 p2 = src[i * 4 + 2];
+
+				dst[i * 4 + 0] = p2;
+				dst[i * 4 + 1] = src[i * 4 + 1];
+				dst[i * 4 + 2] = p0;
+				dst[i * 4 + 3] = src[i * 4 + 3];
+			}
+		}
+
+		// ITU-R BT.601 luma in 8bit fixed point.
+		constexpr UInt8 luma8(UInt32 r, UInt32 g, UInt32 b) noexcept
+		{
+			return static_cast<UInt8>((77 * r + 150 * g + 29 * b + 128) >> 8);
+		}
+	}
+
+	template <>
+	void convertRow<PixelBGRA8, PixelRGBA8>(const PixelRGBA8* source, PixelBGRA8* destination, std::size_t count) noexcept
+	{
+		swapRedBlue(source, destination, count);
+	}
+
+	template <>
+	void convertRow<PixelRGBA8, PixelBGRA8>(const PixelBGRA8* source, PixelRGBA8* destination, std::size_t count) noexcept
+	{
+		swapRedBlue(source, destination, count);
+	}
+
+	template <>
+	void convertRow<PixelRGBA8, PixelR8>(const PixelR8* source, PixelRGBA8* destination, std::size_t count) noexcept
+	{
+		std::size_t i = 0;
+
+#if defined(NENE_SIMD_SSE2)
+		const auto alpha = _mm_set1_epi32(0xff000000);
+
+		for (; i + 16 <= count; i += 16)
+		{
+			const auto g  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+			const auto lo = _mm_unpacklo_epi8(g, g);
+			const auto hi = _mm_unpackhi_epi8(g, g);
+
+			auto dst = reinterpret_cast<__m128i*>(destination + i);
+
+			_mm_storeu_si128(dst + 0, _mm_or_si128(_mm_unpacklo_epi16(lo, lo), alpha));
+			_mm_storeu_si128(dst + 1, _mm_or_si128(_mm_unpackhi_epi16(lo, lo), alpha));
+			_mm_storeu_si128(dst + 2, _mm_or_si128(_mm_unpacklo_epi16(hi, hi), alpha));
+			_mm_storeu_si128(dst + 3, _mm_or_si128(_mm_unpackhi_epi16(hi, hi), alpha));
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			destination[i] = Color4::gray(source[i].red);
+		}
+	}
+
+	template <>
+	void convertRow<PixelR8, PixelRGBA8>(const PixelRGBA8* source, PixelR8* destination, std::size_t count) noexcept
+	{
+		std::size_t i = 0;
+
+#if defined(NENE_SIMD_SSE2)
+		const auto maskRB   = _mm_set1_epi32(0x00ff00ff);
+		const auto weightRB = _mm_set1_epi32((29 << 16) | 77);
+		const auto weightG  = _mm_set1_epi32(150);
+		const auto half     = _mm_set1_epi32(128);
+
+		const auto luma4 = [&](const PixelRGBA8* p)
+		{
+			const auto v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			const auto rb = _mm_madd_epi16(_mm_and_si128(v, maskRB), weightRB);
+			const auto g  = _mm_madd_epi16(_mm_and_si128(_mm_srli_epi32(v, 8), maskRB), weightG);
+
+			return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(rb, g), half), 8);
+		};
+
+		for (; i + 16 <= count; i += 16)
+		{
+			const auto lo = _mm_packs_epi32(luma4(source + i +  0), luma4(source + i +  4));
+			const auto hi = _mm_packs_epi32(luma4(source + i +  8), luma4(source + i + 12));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), _mm_packus_epi16(lo, hi));
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			destination[i] = luma8(source[i].red, source[i].green, source[i].blue);
+		}
+	}
+
+	template <>
+	void convertRow<PixelRGBA8, PixelRG8>(const PixelRG8* source, PixelRGBA8* destination, std::size_t count) noexcept
+	{
+		for (std::size_t i = 0; i < count; i++)
+		{
+			destination[i] = Color4::gray(source[i].red, source[i].green);
+		}
+	}
+
+	template <>
+	void convertRow<PixelRGBA8, PixelR16>(const PixelR16* source, PixelRGBA8* destination, std::size_t count) noexcept
+	{
+		for (std::size_t i = 0; i < count; i++)
+		{
+			destination[i] = Color4::gray(static_cast<UInt8>((source[i].red * 255u + 32767u) / 65535u));
+		}
+	}
+
+	template <>
+	void convertRow<PixelRGBA32F, PixelRGBA8>(const PixelRGBA8* source, PixelRGBA32F* destination, std::size_t count) noexcept
+	{
+		constexpr Float32 scale = 1.f / 255.f;
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			destination[i] = { source[i].red * scale, source[i].green * scale, source[i].blue * scale, source[i].alpha * scale };
+		}
+	}
+}
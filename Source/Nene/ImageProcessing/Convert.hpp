@@ -0,0 +1,180 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_IMAGEPROCESSING_CONVERT_HPP
+#define INCLUDE_NENE_IMAGEPROCESSING_CONVERT_HPP
+
+#include <cstring>
+#include <type_traits>
+#include "../Image.hpp"
+
+namespace Nene::ImageProcessing
+{
+	/**
+	 * @brief      Converts a row of pixels into another pixel format.
+	 *
+	 *             The generic version goes through `Color4f`. Common pairs are
+	 *             specialized with dedicated kernels.
+	 *
+	 * @param[in]  source       The source pixels.
+	 * @param[out] destination  The destination pixels.
+	 * @param[in]  count        The number of pixels.
+	 *
+	 * @tparam     To    The destination pixel type.
+	 * @tparam     From  The source pixel type.
+	 */
+	template <typename To, typename From>
+	void convertRow(const From* source, To* destination, std::size_t count) noexcept
+	{
+		if constexpr (std::is_same_v<To, From>)
+		{
+			std::memcpy(destination, source, sizeof(To) * count);
+		}
+		else
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				destination[i] = PixelTraits<To>::fromColor4f(PixelTraits<From>::toColor4f(source[i]));
+			}
+		}
+	}
+
+	template <>
+	void convertRow<PixelBGRA8, PixelRGBA8>(const PixelRGBA8* source, PixelBGRA8* destination, std::size_t count) noexcept;
+
+	template <>
+	void convertRow<PixelRGBA8, PixelBGRA8>(const PixelBGRA8* source, PixelRGBA8* destination, std::size_t count) noexcept;
+
+	template <>
+	void convertRow<PixelRGBA8, PixelR8>(const PixelR8* source, PixelRGBA8* destination, std::size_t count) noexcept;
+
+	template <>
+	void convertRow<PixelR8, PixelRGBA8>(const PixelRGBA8* source, PixelR8* destination, std::size_t count) noexcept;
+
+	template <>
+	void convertRow<PixelRGBA8, PixelRG8>(const PixelRG8* source, PixelRGBA8* destination, std::size_t count) noexcept;
+
+	template <>
+	void convertRow<PixelRGBA8, PixelR16>(const PixelR16* source, PixelRGBA8* destination, std::size_t count) noexcept;
+
+	template <>
+	void convertRow<PixelRGBA32F, PixelRGBA8>(const PixelRGBA8* source, PixelRGBA32F* destination, std::size_t count) noexcept;
+
+	/**
+	 * @brief      Converts the pixels of the image view into another view.
+	 *
+	 * @param[in]  source       The source image view.
+	 * @param[out] destination  The destination image view of the same size.
+	 *
+	 * @tparam     To    The destination pixel type.
+	 * @tparam     From  The source pixel type.
+	 */
+	template <typename To, typename From>
+	void convert(BasicImageView<From> source, BasicMutableImageView<To> destination) noexcept
+	{
+		assert(source.size() == destination.size());
+
+		if (source.isContiguous() && destination.isContiguous())
+		{
+			convertRow(source.row(0), destination.row(0), source.numPixels());
+			return;
+		}
+
+		for (Int32 y = 0; y < source.height(); y++)
+		{
+			convertRow(source.row(y), destination.row(y), static_cast<std::size_t>(source.width()));
+		}
+	}
+
+	/**
+	 * @brief      Converts the image view into another pixel format.
+	 *
+	 * @param[in]  source  The source image view.
+	 *
+	 * @tparam     To    The destination pixel type.
+	 * @tparam     From  The source pixel type.
+	 *
+	 * @return     The converted image.
+	 */
+	template <typename To, typename From>
+	[[nodiscard]]
+	BasicImage<To> convert(BasicImageView<From> source)
+	{
+		BasicImage<To> image { source.size() };
+
+		convert(source, image.mutableView());
+
+		return image;
+	}
+
+	/**
+	 * @brief      Converts the image into another pixel format.
+	 *
+	 * @param[in]  source  The source image.
+	 *
+	 * @tparam     To         The destination pixel type.
+	 * @tparam     From       The source pixel type.
+	 * @tparam     Allocator  The allocator type of the source image.
+	 *
+	 * @return     The converted image.
+	 */
+	template <typename To, typename From, typename Allocator>
+	[[nodiscard]]
+	BasicImage<To> convert(const BasicImage<From, Allocator>& source)
+	{
+		return convert<To>(source.view());
+	}
+
+	/**
+	 * @brief      Converts the image of any format into the pixel format.
+	 *
+	 *             The image is moved out without conversion when it already
+	 *             has the requested format.
+	 *
+	 * @param[in]  source  The source image.
+	 *
+	 * @tparam     To    The destination pixel type.
+	 *
+	 * @return     The converted image.
+	 */
+	template <typename To>
+	[[nodiscard]]
+	BasicImage<To> convert(AnyImage&& source)
+	{
+		return std::visit([](auto&& image) -> BasicImage<To>
+		{
+			using ImageType = std::decay_t<decltype(image)>;
+
+			if constexpr (std::is_same_v<ImageType, BasicImage<To>>)
+			{
+				return std::move(image);
+			}
+			else
+			{
+				return convert<To>(image.view());
+			}
+		}, std::move(source));
+	}
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGEPROCESSING_CONVERT_HPP
@@ -0,0 +1,324 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "../Thread/ThreadPool.hpp"
+#include "DistanceField.hpp"
+
+namespace Nene::ImageProcessing
+{
+	namespace
+	{
+		// Squared distance of the pixels without any feature; finite so that the intersections never become NaN.
+		constexpr Float32 infinity = 1e20f;
+
+		// Number of the columns transformed together.
+		constexpr Int32 stripWidth = 16;
+
+		[[nodiscard]]
+		Int32 rowsPerTask(Int32 height, ThreadPool& pool) noexcept
+		{
+			const auto chunks = static_cast<Int32>(pool.numThreads() + 1) * 4;
+
+			return (std::max)((height + chunks - 1) / chunks, 1);
+		}
+
+		/**
+		 * @brief      Scratch buffers of the one dimensional transform.
+		 */
+		class Transform
+		{
+			std::vector<Float64> f_;
+			std::vector<Float64> z_;
+			std::vector<Int32>   v_;
+
+		public:
+			explicit Transform(Int32 length)
+				: f_(length)
+				, z_(length + 1)
+				, v_(length) {}
+
+			/**
+			 * @brief      Computes the squared distances along the line in place.
+			 *
+			 *             The result is the lower envelope of the parabolas
+			 *             rooted at each sample.
+			 */
+			void operator()(Float32* grid, Int32 length) noexcept
+			{
+				const auto f = f_.data();
+				const auto z = z_.data();
+				const auto v = v_.data();
+
+				for (Int32 q = 0; q < length; q++)
+				{
+					f[q] = grid[q];
+				}
+
+				Int32 k = 0;
+
+				v[0] = 0;
+				z[0] = -std::numeric_limits<Float64>::infinity();
+				z[1] = +std::numeric_limits<Float64>::infinity();
+
+				for (Int32 q = 1; q < length; q++)
+				{
+					const auto fq = f[q] + static_cast<Float64>(q) * q;
+
+					// Intersection with the rightmost parabola of the envelope.
+					const auto intersect = [&](Int32 r)
+					{
+						return (fq - (f[r] + static_cast<Float64>(r) * r)) / (2 * (q - r));
+					};
+
+					auto s = intersect(v[k]);
+
+					while (s <= z[k])
+					{
+						k--;
+						s = intersect(v[k]);
+					}
+
+					k++;
+					v[k]     = q;
+					z[k]     = s;
+					z[k + 1] = +std::numeric_limits<Float64>::infinity();
+				}
+
+				k = 0;
+
+				for (Int32 q = 0; q < length; q++)
+				{
+					while (z[k + 1] < q)
+					{
+						k++;
+					}
+
+					const auto d = static_cast<Float64>(q - v[k]);
+
+					grid[q] = static_cast<Float32>(d * d + f[v[k]]);
+				}
+			}
+		};
+
+		/**
+		 * @brief      Computes the signed distances of the mask in the source pixels, positive outside.
+		 */
+		[[nodiscard]]
+		std::vector<Float32> computeDistances(ImageView mask, ThreadPool& pool)
+		{
+			const auto width  = mask.width();
+			const auto height = mask.height();
+			const auto pitch  = static_cast<std::size_t>(width);
+
+			// Squared distances to the inside and to the outside.
+			std::vector<Float32> outer(pitch * height);
+			std::vector<Float32> inner(pitch * height);
+
+			pool.parallelFor(0, height, rowsPerTask(height, pool), [&](Int32 begin, Int32 end)
+			{
+				for (Int32 y = begin; y < end; y++)
+				{
+					const auto row = mask.row(y);
+					const auto o   = outer.data() + y * pitch;
+					const auto i   = inner.data() + y * pitch;
+
+					for (Int32 x = 0; x < width; x++)
+					{
+						const auto alpha = row[x].alpha;
+
+						if (alpha == 255)
+						{
+							o[x] = 0.0f;
+							i[x] = infinity;
+						}
+						else if (alpha == 0)
+						{
+							o[x] = infinity;
+							i[x] = 0.0f;
+						}
+						else
+						{
+							// Partial coverage moves the edge within the pixel.
+							const auto d = 0.5f - alpha / 255.0f;
+
+							o[x] = d > 0.0f ? d * d : 0.0f;
+							i[x] = d < 0.0f ? d * d : 0.0f;
+						}
+					}
+				}
+			});
+
+			// Columns are copied out in strips to read the rows sequentially.
+			const auto numStrips = (width + stripWidth - 1) / stripWidth;
+
+			pool.parallelFor(0, numStrips, rowsPerTask(numStrips, pool), [&](Int32 begin, Int32 end)
+			{
+				Transform transform { height };
+
+				std::vector<Float32> strip(static_cast<std::size_t>(stripWidth) * height * 2);
+
+				for (Int32 s = begin; s < end; s++)
+				{
+					const auto x0 = s * stripWidth;
+					const auto n  = (std::min)(stripWidth, width - x0);
+
+					for (Int32 y = 0; y < height; y++)
+					{
+						const auto o = outer.data() + y * pitch + x0;
+						const auto i = inner.data() + y * pitch + x0;
+
+						for (Int32 x = 0; x < n; x++)
+						{
+							strip[(x * 2 + 0) * static_cast<std::size_t>(height) + y] = o[x];
+							strip[(x * 2 + 1) * static_cast<std::size_t>(height) + y] = i[x];
+						}
+					}
+
+					for (Int32 c = 0; c < n * 2; c++)
+					{
+						transform(strip.data() + static_cast<std::size_t>(c) * height, height);
+					}
+
+					for (Int32 y = 0; y < height; y++)
+					{
+						const auto o = outer.data() + y * pitch + x0;
+						const auto i = inner.data() + y * pitch + x0;
+
+						for (Int32 x = 0; x < n; x++)
+						{
+							o[x] = strip[(x * 2 + 0) * static_cast<std::size_t>(height) + y];
+							i[x] = strip[(x * 2 + 1) * static_cast<std::size_t>(height) + y];
+						}
+					}
+				}
+			});
+
+			pool.parallelFor(0, height, rowsPerTask(height, pool), [&](Int32 begin, Int32 end)
+			{
+				Transform transform { width };
+
+				for (Int32 y = begin; y < end; y++)
+				{
+					const auto o = outer.data() + y * pitch;
+					const auto i = inner.data() + y * pitch;
+
+					transform(o, width);
+					transform(i, width);
+
+					for (Int32 x = 0; x < width; x++)
+					{
+						o[x] = std::sqrt(o[x]) - std::sqrt(i[x]);
+					}
+				}
+			});
+
+			return outer;
+		}
+
+		[[nodiscard]]
+		UInt8 encode(Float32 distance, Float32 scale) noexcept
+		{
+			const auto value = 127.5f - distance * scale;
+
+			return static_cast<UInt8>((std::min)((std::max)(value, 0.0f), 255.0f) + 0.5f);
+		}
+	}
+
+	ImageR8 generateDistanceField(ImageView mask, const DistanceFieldOptions& options)
+	{
+		return generateDistanceField(mask, options, ThreadPool::shared());
+	}
+
+	ImageR8 generateDistanceField(ImageView mask, const DistanceFieldOptions& options, ThreadPool& pool)
+	{
+		assert(!mask.empty());
+		assert(options.spread > 0.0f);
+
+		const auto size = options.size.value_or(mask.size());
+
+		assert(size.width  > 0);
+		assert(size.height > 0);
+
+		const auto distances = computeDistances(mask, pool);
+
+		const auto width  = mask.width();
+		const auto height = mask.height();
+
+		// Source pixels per output pixel.
+		const auto sx = static_cast<Float32>(width)  / size.width;
+		const auto sy = static_cast<Float32>(height) / size.height;
+
+		// Maps the distances in the source pixels to the output values.
+		const auto scale = 127.5f / (options.spread * (sx + sy) * 0.5f);
+
+		ImageR8 field { size };
+
+		pool.parallelFor(0, size.height, rowsPerTask(size.height, pool), [&](Int32 begin, Int32 end)
+		{
+			for (Int32 y = begin; y < end; y++)
+			{
+				const auto row = field.row(y);
+
+				if (size == mask.size())
+				{
+					const auto d = distances.data() + static_cast<std::size_t>(y) * width;
+
+					for (Int32 x = 0; x < size.width; x++)
+					{
+						row[x] = encode(d[x], scale);
+					}
+
+					continue;
+				}
+
+				// Bilinear sample at the output pixel center.
+				const auto v  = (std::max)((y + 0.5f) * sy - 0.5f, 0.0f);
+				const auto y0 = (std::min)(static_cast<Int32>(v), height - 1);
+				const auto y1 = (std::min)(y0 + 1, height - 1);
+				const auto fy = (std::min)(v - y0, 1.0f);
+
+				const auto d0 = distances.data() + static_cast<std::size_t>(y0) * width;
+				const auto d1 = distances.data() + static_cast<std::size_t>(y1) * width;
+
+				for (Int32 x = 0; x < size.width; x++)
+				{
+					const auto u  = (std::max)((x + 0.5f) * sx - 0.5f, 0.0f);
+					const auto x0 = (std::min)(static_cast<Int32>(u), width - 1);
+					const auto x1 = (std::min)(x0 + 1, width - 1);
+					const auto fx = (std::min)(u - x0, 1.0f);
+
+					const auto top    = d0[x0] + (d0[x1] - d0[x0]) * fx;
+					const auto bottom = d1[x0] + (d1[x1] - d1[x0]) * fx;
+
+					row[x] = encode(top + (bottom - top) * fy, scale);
+				}
+			}
+		});
+
+		return field;
+	}
+}
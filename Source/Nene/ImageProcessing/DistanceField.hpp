@@ -0,0 +1,89 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+#ifndef INCLUDE_NENE_IMAGEPROCESSING_DISTANCEFIELD_HPP
+#define INCLUDE_NENE_IMAGEPROCESSING_DISTANCEFIELD_HPP
+
+#include <optional>
+#include "../Image.hpp"
+
+namespace Nene
+{
+	// Forward declarations.
+	class ThreadPool;
+}
+
+namespace Nene::ImageProcessing
+{
+	/**
+	 * @brief      Signed distance field generation options.
+	 */
+	class DistanceFieldOptions
+	{
+	public:
+		/**
+		 * @brief      Distance from the edge in the output pixels mapped to
+		 *             the minimum and the maximum values.
+		 */
+		Float32 spread = 4.0f;
+
+		/**
+		 * @brief      The output size, or `std::nullopt` for the mask size.
+		 */
+		std::optional<Size2Di> size = std::nullopt;
+	};
+
+	/**
+	 * @brief      Generates the signed distance field of the alpha mask.
+	 *
+	 *             The exact Euclidean distance transform of Felzenszwalb and
+	 *             Huttenlocher runs in linear time over the columns and then
+	 *             the rows, each pass split over the thread pool. Partial
+	 *             alpha places the edge between the pixels, so anti-aliased
+	 *             masks keep their sub-pixel shape. Smaller outputs are
+	 *             sampled from the field of the full resolution mask.
+	 *
+	 *             The edge maps to 128; inside is brighter and outside is
+	 *             darker, reaching 255 and 0 at `spread` pixels away.
+	 *
+	 * @param[in]  mask     The mask image whose alpha is the coverage.
+	 * @param[in]  options  The generation options.
+	 *
+	 * @return     The single channel distance field.
+	 */
+	[[nodiscard]]
+	ImageR8 generateDistanceField(ImageView mask, const DistanceFieldOptions& options = DistanceFieldOptions {});
+
+	/**
+	 * @brief      Generates the signed distance field of the alpha mask.
+	 *
+	 * @param[in]  mask     The mask image whose alpha is the coverage.
+	 * @param[in]  options  The generation options.
+	 * @param      pool     The thread pool to run the passes on.
+	 *
+	 * @return     The single channel distance field.
+	 */
+	[[nodiscard]]
+	ImageR8 generateDistanceField(ImageView mask, const DistanceFieldOptions& options, ThreadPool& pool);
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGEPROCESSING_DISTANCEFIELD_HPP
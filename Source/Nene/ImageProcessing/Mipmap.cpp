@@ -0,0 +1,397 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#include <cmath>
+#include <vector>
+#include "../Platform.hpp"
+#include "../Math/Constants.hpp"
+#include "../Thread/ThreadPool.hpp"
+#include "ColorSpace.hpp"
+#include "Convert.hpp"
+#include "Mipmap.hpp"
+
+#if defined(NENE_SIMD_SSE2)
+#  include <emmintrin.h>
+#endif
+
+namespace Nene::ImageProcessing
+{
+	namespace
+	{
+		// Kaiser window parameters: radius in destination pixels and shape.
+		constexpr Float64 kaiserRadius = 2.0;
+		constexpr Float64 kaiserBeta   = 4.0;
+
+		struct Weights
+		{
+			std::vector<Int32>   indices;
+			std::vector<Float32> weights;
+			Int32                stride;
+		};
+
+		class FloatImage
+		{
+		public:
+			Size2Di              size;
+			std::vector<Color4f> pixels;
+
+			explicit FloatImage(const Size2Di& size)
+				: size(size)
+				, pixels(static_cast<std::size_t>(size.width) * size.height) {}
+
+			[[nodiscard]]
+			Color4f* row(Int32 y) noexcept
+			{
+				return pixels.data() + static_cast<std::size_t>(y) * size.width;
+			}
+
+			[[nodiscard]]
+			const Color4f* row(Int32 y) const noexcept
+			{
+				return pixels.data() + static_cast<std::size_t>(y) * size.width;
+			}
+		};
+
+		Float64 besselI0(Float64 x) noexcept
+		{
+			Float64 sum  = 1.0;
+			Float64 term = 1.0;
+
+			for (Int32 k = 1; k < 32; k++)
+			{
+				term *= (x / (2 * k)) * (x / (2 * k));
+				sum  += term;
+
+				if (term < sum * 1e-12)
+				{
+					break;
+				}
+			}
+
+			return sum;
+		}
+
+		Float64 kaiser(Float64 x) noexcept
+		{
+			const auto t = x / kaiserRadius;
+
+			if (std::abs(t) >= 1.0)
+			{
+				return 0.0;
+			}
+
+			const auto sinc = x == 0.0 ? 1.0 : std::sin(Math::pi<Float64> * x) / (Math::pi<Float64> * x);
+
+			return sinc * besselI0(kaiserBeta * std::sqrt(1.0 - t * t)) / besselI0(kaiserBeta);
+		}
+
+		Weights computeWeights(Int32 sourceSize, Int32 destinationSize, MipFilter filter)
+		{
+			const auto ratio   = static_cast<Float64>(sourceSize) / destinationSize;
+			const auto support = filter == MipFilter::box ? ratio * 0.5 : ratio * kaiserRadius;
+
+			Weights w;
+			w.stride = static_cast<Int32>(std::ceil(support * 2)) + 2;
+			w.indices.assign(static_cast<std::size_t>(destinationSize) * w.stride, 0);
+			w.weights.assign(static_cast<std::size_t>(destinationSize) * w.stride, 0.f);
+
+			std::vector<Float64> taps(static_cast<std::size_t>(w.stride));
+
+			for (Int32 i = 0; i < destinationSize; i++)
+			{
+				const auto center = (i + 0.5) * ratio;
+				const auto first  = static_cast<Int32>(std::floor(center - support));
+
+				Float64 total = 0.0;
+
+				for (Int32 k = 0; k < w.stride; k++)
+				{
+					const auto j = first + k;
+
+					if (filter == MipFilter::box)
+					{
+						// Overlap of the source pixel and the destination footprint.
+						taps[k] = (std::max)((std::min)(j + 1.0, center + support) - (std::max)(j + 0.0, center - support), 0.0);
+					}
+					else
+					{
+						taps[k] = kaiser((j + 0.5 - center) / ratio);
+					}
+
+					total += taps[k];
+				}
+
+				for (Int32 k = 0; k < w.stride; k++)
+				{
+					const auto n = static_cast<std::size_t>(i) * w.stride + k;
+
+					w.indices[n] = std::clamp(first + k, 0, sourceSize - 1);
+					w.weights[n] = static_cast<Float32>(taps[k] / total);
+				}
+			}
+
+			return w;
+		}
+
+		// Computes `sum(weights[k] * pixels[indices[k] * step])`.
+		Color4f convolve(const Color4f* pixels, std::size_t step, const Int32* indices, const Float32* weights, Int32 count) noexcept
+		{
+#if defined(NENE_SIMD_SSE2)
+			auto acc = _mm_setzero_ps();
+
+			for (Int32 k = 0; k < count; k++)
+			{
+				acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(&pixels[indices[k] * step].red)));
+			}
+
+			Color4f result;
+			_mm_storeu_ps(&result.red, acc);
+
+			return result;
+#else
+			Color4f result { 0.f, 0.f, 0.f, 0.f };
+
+			for (Int32 k = 0; k < count; k++)
+			{
+				const auto& p = pixels[indices[k] * step];
+
+				result.red   += weights[k] * p.red;
+				result.green += weights[k] * p.green;
+				result.blue  += weights[k] * p.blue;
+				result.alpha += weights[k] * p.alpha;
+			}
+
+			return result;
+#endif
+		}
+
+		[[nodiscard]]
+		Int32 rowsPerTask(Int32 height, ThreadPool& pool) noexcept
+		{
+			const auto chunks = static_cast<Int32>(pool.numThreads() + 1) * 4;
+
+			return (std::max)((height + chunks - 1) / chunks, 1);
+		}
+
+		FloatImage downsample(const FloatImage& source, const Size2Di& size, MipFilter filter, ThreadPool& pool)
+		{
+			const auto wx = computeWeights(source.size.width , size.width , filter);
+			const auto wy = computeWeights(source.size.height, size.height, filter);
+
+			FloatImage horizontal { { size.width, source.size.height } };
+			FloatImage result     { size };
+
+			pool.parallelFor(0, source.size.height, rowsPerTask(source.size.height, pool), [&](Int32 begin, Int32 end)
+			{
+				for (Int32 y = begin; y < end; y++)
+				{
+					const auto src = source.row(y);
+					const auto dst = horizontal.row(y);
+
+					for (Int32 x = 0; x < size.width; x++)
+					{
+						const auto n = static_cast<std::size_t>(x) * wx.stride;
+
+						dst[x] = convolve(src, 1, &wx.indices[n], &wx.weights[n], wx.stride);
+					}
+				}
+			});
+
+			pool.parallelFor(0, size.height, rowsPerTask(size.height, pool), [&](Int32 begin, Int32 end)
+			{
+				for (Int32 y = begin; y < end; y++)
+				{
+					const auto n   = static_cast<std::size_t>(y) * wy.stride;
+					const auto dst = result.row(y);
+
+					for (Int32 x = 0; x < size.width; x++)
+					{
+						auto c = convolve(horizontal.pixels.data() + x, static_cast<std::size_t>(size.width), &wy.indices[n], &wy.weights[n], wy.stride);
+
+						// Negative lobes of the kernel may leave the valid premultiplied range.
+						c.alpha = std::clamp(c.alpha, 0.f, 1.f);
+						c.red   = std::clamp(c.red  , 0.f, c.alpha);
+						c.green = std::clamp(c.green, 0.f, c.alpha);
+						c.blue  = std::clamp(c.blue , 0.f, c.alpha);
+
+						dst[x] = c;
+					}
+				}
+			});
+
+			return result;
+		}
+
+		Float32 coverage(const FloatImage& image, Float32 reference, Float32 scale) noexcept
+		{
+			std::size_t covered = 0;
+
+			for (const auto& p : image.pixels)
+			{
+				covered += p.alpha * scale > reference ? 1 : 0;
+			}
+
+			return static_cast<Float32>(covered) / image.pixels.size();
+		}
+
+		// Finds the alpha scale which makes the coverage of the level closest to `target`.
+		Float32 coverageScale(const FloatImage& image, Float32 reference, Float32 target) noexcept
+		{
+			Float32 low  = 0.f;
+			Float32 high = 1.f;
+
+			while (coverage(image, reference, high) < target && high < 64.f)
+			{
+				low   = high;
+				high *= 2.f;
+			}
+
+			for (Int32 i = 0; i < 12; i++)
+			{
+				const auto middle = (low + high) * 0.5f;
+
+				if (coverage(image, reference, middle) < target)
+				{
+					low = middle;
+				}
+				else
+				{
+					high = middle;
+				}
+			}
+
+			return high;
+		}
+	}
+
+	MipChain generateMipChain(ImageView image, const MipChainOptions& options)
+	{
+		return generateMipChain(image, options, ThreadPool::shared());
+	}
+
+	MipChain generateMipChain(ImageView image, const MipChainOptions& options, ThreadPool& pool)
+	{
+		assert(!image.empty());
+
+		const auto fullLevels = MipChain::fullLevels(image.size());
+		const auto numLevels  = options.maxLevels > 0 ? (std::min)(options.maxLevels, fullLevels) : fullLevels;
+
+		MipChain chain { image.size(), numLevels };
+
+		chain.mutableLevel(0).copyFrom(image);
+
+		if (numLevels == 1)
+		{
+			return chain;
+		}
+
+		// Top level in linear premultiplied floating point.
+		std::vector<FloatImage> levels;
+		levels.reserve(static_cast<std::size_t>(numLevels));
+		levels.emplace_back(image.size());
+
+		pool.parallelFor(0, image.height(), rowsPerTask(image.height(), pool), [&](Int32 begin, Int32 end)
+		{
+			for (Int32 y = begin; y < end; y++)
+			{
+				const ArrayView<Color4> src { image.row(y), static_cast<std::size_t>(image.width()) };
+				const auto              dst = levels[0].row(y);
+
+				if (options.srgb)
+				{
+					srgbToLinear(src, dst);
+				}
+				else
+				{
+					convertRow(src.data(), dst, src.size());
+				}
+
+				premultiply(ArrayView<Color4f> { dst, src.size() }, dst);
+			}
+		});
+
+		for (Int32 level = 1; level < numLevels; level++)
+		{
+			levels.emplace_back(downsample(levels.back(), chain.size(level), options.filter, pool));
+		}
+
+		// Alpha scale of each level preserving the alpha test coverage.
+		std::vector<Float32> alphaScales(static_cast<std::size_t>(numLevels), 1.f);
+
+		if (const auto reference = options.alphaCoverageReference)
+		{
+			const auto target = coverage(levels[0], *reference, 1.f);
+
+			pool.parallelFor(1, numLevels, 1, [&](Int32 begin, Int32 end)
+			{
+				for (Int32 level = begin; level < end; level++)
+				{
+					alphaScales[level] = coverageScale(levels[level], *reference, target);
+				}
+			});
+		}
+
+		// Encode the rows of every level in one pass.
+		std::vector<Int32> firstRows { 0 };
+
+		for (Int32 level = 1; level < numLevels; level++)
+		{
+			firstRows.emplace_back(firstRows.back() + chain.size(level).height);
+		}
+
+		pool.parallelFor(0, firstRows.back(), rowsPerTask(firstRows.back(), pool), [&](Int32 begin, Int32 end)
+		{
+			std::vector<Color4f> buffer(static_cast<std::size_t>(image.width()));
+
+			for (Int32 row = begin; row < end; row++)
+			{
+				const auto level = static_cast<Int32>(std::upper_bound(firstRows.begin(), firstRows.end(), row) - firstRows.begin());
+				const auto y     = row - firstRows[level - 1];
+				const auto width = static_cast<std::size_t>(chain.size(level).width);
+				const auto scale = alphaScales[level];
+				const auto dst   = chain.mutableLevel(level).row(y);
+
+				unpremultiply(ArrayView<Color4f> { levels[level].row(y), width }, buffer.data());
+
+				for (std::size_t x = 0; x < width; x++)
+				{
+					buffer[x].alpha = (std::min)(buffer[x].alpha * scale, 1.f);
+				}
+
+				if (options.srgb)
+				{
+					linearToSrgb(ArrayView<Color4f> { buffer.data(), width }, dst);
+				}
+				else
+				{
+					for (std::size_t x = 0; x < width; x++)
+					{
+						dst[x] = PixelTraits<Color4>::fromColor4f(buffer[x]);
+					}
+				}
+			}
+		});
+
+		return chain;
+	}
+}
@@ -0,0 +1,102 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_IMAGEPROCESSING_MIPMAP_HPP
+#define INCLUDE_NENE_IMAGEPROCESSING_MIPMAP_HPP
+
+#include <optional>
+#include "../MipChain.hpp"
+
+namespace Nene
+{
+	// Forward declarations.
+	class ThreadPool;
+}
+
+namespace Nene::ImageProcessing
+{
+	/**
+	 * @brief      Mipmap downsampling filters.
+	 */
+	enum class MipFilter: Int32
+	{
+		box,
+		kaiser,
+	};
+
+	/**
+	 * @brief      Mipmap generation options.
+	 */
+	class MipChainOptions
+	{
+	public:
+		/**
+		 * @brief      The downsampling filter.
+		 */
+		MipFilter filter = MipFilter::box;
+
+		/**
+		 * @brief      `true` to filter sRGB colors in linear space.
+		 */
+		bool srgb = true;
+
+		/**
+		 * @brief      The alpha test reference whose coverage is preserved
+		 *             through the levels, or `std::nullopt` to disable.
+		 */
+		std::optional<Float32> alphaCoverageReference = std::nullopt;
+
+		/**
+		 * @brief      Maximum number of the levels, `0` for the full chain.
+		 */
+		Int32 maxLevels = 0;
+	};
+
+	/**
+	 * @brief      Generates the mipmap levels of the image.
+	 *
+	 *             Colors are filtered with premultiplied alpha and each level
+	 *             is downsampled from the previous one kept in floating point.
+	 *
+	 * @param[in]  image    The top level image.
+	 * @param[in]  options  The generation options.
+	 *
+	 * @return     The mipmap levels.
+	 */
+	[[nodiscard]]
+	MipChain generateMipChain(ImageView image, const MipChainOptions& options = MipChainOptions {});
+
+	/**
+	 * @brief      Generates the mipmap levels of the image.
+	 *
+	 * @param[in]  image    The top level image.
+	 * @param[in]  options  The generation options.
+	 * @param      pool     The thread pool to filter the levels on.
+	 *
+	 * @return     The mipmap levels.
+	 */
+	[[nodiscard]]
+	MipChain generateMipChain(ImageView image, const MipChainOptions& options, ThreadPool& pool);
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGEPROCESSING_MIPMAP_HPP
@@ -0,0 +1,474 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#include <cmath>
+#include <cstring>
+#include "../Platform.hpp"
+#include "../Math/Constants.hpp"
+#include "../Thread/ThreadPool.hpp"
+#include "Resize.hpp"
+
+#if defined(NENE_SIMD_SSE2)
+#  include <emmintrin.h>
+#endif
+
+#if defined(NENE_SIMD_AVX2)
+#  include <immintrin.h>
+#endif
+
+namespace Nene::ImageProcessing
+{
+	namespace
+	{
+		// Filter weights are 2.14 fixed point numbers so that two taps can be
+		// accumulated at once with 16bit multiply-add.
+		constexpr Int32 weightBits = 14;
+		constexpr Int32 weightOne  = 1 << weightBits;
+		constexpr Int32 weightHalf = 1 << (weightBits - 1);
+
+		struct Filter
+		{
+			Float64 support;
+			Float64 (*function)(Float64);
+		};
+
+		Float64 boxFilter(Float64 x) noexcept
+		{
+			return (x > -0.5 && x <= 0.5) ? 1.0 : 0.0;
+		}
+
+		Float64 triangleFilter(Float64 x) noexcept
+		{
+			x = std::abs(x);
+
+			return x < 1.0 ? 1.0 - x : 0.0;
+		}
+
+		Float64 bicubicFilter(Float64 x) noexcept
+		{
+			constexpr Float64 a = -0.5;
+
+			x = std::abs(x);
+
+			if (x < 1.0)
+			{
+				return ((a + 2.0) * x - (a + 3.0)) * x * x + 1.0;
+			}
+
+			if (x < 2.0)
+			{
+				return (((x - 5.0) * x + 8.0) * x - 4.0) * a;
+			}
+
+			return 0.0;
+		}
+
+		Float64 sinc(Float64 x) noexcept
+		{
+			if (x == 0.0)
+			{
+				return 1.0;
+			}
+
+			x *= Math::pi<Float64>;
+
+			return std::sin(x) / x;
+		}
+
+		Float64 lanczosFilter(Float64 x) noexcept
+		{
+			return (-3.0 < x && x < 3.0) ? sinc(x) * sinc(x / 3.0) : 0.0;
+		}
+
+		const Filter& filterOf(ResizeFilter filter) noexcept
+		{
+			static const Filter box      = { 0.5, boxFilter      };
+			static const Filter bilinear = { 1.0, triangleFilter };
+			static const Filter bicubic  = { 2.0, bicubicFilter  };
+			static const Filter lanczos  = { 3.0, lanczosFilter  };
+
+			switch (filter)
+			{
+				case ResizeFilter::box     : return box;
+				case ResizeFilter::bilinear: return bilinear;
+				case ResizeFilter::bicubic : return bicubic;
+				case ResizeFilter::lanczos : return lanczos;
+				default                    : return bilinear;
+			}
+		}
+
+		/**
+		 * @brief      Filter taps of each destination pixel of a pass.
+		 */
+		struct Coefficients
+		{
+			std::vector<Int32> first;
+			std::vector<Int32> count;
+			std::vector<Int16> weights;
+			Int32              stride;
+		};
+
+		Coefficients computeCoefficients(Int32 sourceSize, Int32 destSize, const Filter& filter)
+		{
+			const Float64 scale       = static_cast<Float64>(sourceSize) / destSize;
+			const Float64 filterScale = (std::max)(scale, 1.0);
+			const Float64 support     = filter.support * filterScale;
+
+			Coefficients coefficients;
+			coefficients.stride = static_cast<Int32>(std::ceil(support)) * 2 + 1;
+			coefficients.first.resize(destSize);
+			coefficients.count.resize(destSize);
+			coefficients.weights.assign(static_cast<std::size_t>(destSize) * coefficients.stride, 0);
+
+			std::vector<Float64> weights(coefficients.stride);
+
+			for (Int32 i = 0; i < destSize; i++)
+			{
+				const Float64 center = (i + 0.5) * scale;
+				const Int32   begin  = (std::max)(static_cast<Int32>(center - support + 0.5), 0);
+				const Int32   end    = (std::min)(static_cast<Int32>(center + support + 0.5), sourceSize);
+				const Int32   count  = (std::min)(end - begin, coefficients.stride);
+
+				Float64 total = 0.0;
+
+				for (Int32 k = 0; k < count; k++)
+				{
+					weights[k] = filter.function((begin + k - center + 0.5) / filterScale);
+					total += weights[k];
+				}
+
+				// Quantize the weights and let the largest one absorb the rounding error.
+				Int16* const dest = &coefficients.weights[static_cast<std::size_t>(i) * coefficients.stride];
+
+				Int32 sum     = 0;
+				Int32 largest = 0;
+
+				for (Int32 k = 0; k < count; k++)
+				{
+					dest[k] = static_cast<Int16>(total != 0.0 ? std::lround(weights[k] / total * weightOne) : 0);
+					sum += dest[k];
+
+					if (std::abs(dest[k]) > std::abs(dest[largest]))
+					{
+						largest = k;
+					}
+				}
+
+				dest[largest] = static_cast<Int16>(dest[largest] + weightOne - sum);
+
+				coefficients.first[i] = begin;
+				coefficients.count[i] = count;
+			}
+
+			return coefficients;
+		}
+
+		[[nodiscard]]
+		UInt8 clamp8(Int32 x) noexcept
+		{
+			return static_cast<UInt8>(std::clamp(x >> weightBits, 0, 255));
+		}
+
+#if defined(NENE_SIMD_SSE2)
+		[[nodiscard]]
+		__m128i loadPixel(const Color4* p) noexcept
+		{
+			Int32 x;
+			std::memcpy(&x, p, sizeof(x));
+
+			return _mm_cvtsi32_si128(x);
+		}
+
+		[[nodiscard]]
+		__m128i weightPair(Int16 w0, Int16 w1) noexcept
+		{
+			return _mm_set1_epi32(static_cast<Int32>((static_cast<UInt32>(static_cast<UInt16>(w1)) << 16) | static_cast<UInt16>(w0)));
+		}
+
+		[[nodiscard]]
+		__m128i packPixels(__m128i s0, __m128i s1, __m128i s2, __m128i s3) noexcept
+		{
+			s0 = _mm_srai_epi32(s0, weightBits);
+			s1 = _mm_srai_epi32(s1, weightBits);
+			s2 = _mm_srai_epi32(s2, weightBits);
+			s3 = _mm_srai_epi32(s3, weightBits);
+
+			return _mm_packus_epi16(_mm_packs_epi32(s0, s1), _mm_packs_epi32(s2, s3));
+		}
+#endif
+
+		void resampleRow(const Color4* source, Color4* dest, Int32 destWidth, const Coefficients& coefficients) noexcept
+		{
+			for (Int32 x = 0; x < destWidth; x++)
+			{
+				const Color4* const p       = source + coefficients.first[x];
+				const Int16*  const weights = &coefficients.weights[static_cast<std::size_t>(x) * coefficients.stride];
+				const Int32         count   = coefficients.count[x];
+
+#if defined(NENE_SIMD_SSE2)
+				const __m128i zero = _mm_setzero_si128();
+				__m128i       sum  = _mm_set1_epi32(weightHalf);
+
+				Int32 k = 0;
+
+				for (; k + 1 < count; k += 2)
+				{
+					// r0 g0 b0 a0 r1 g1 b1 a1 -> r0 r1 g0 g1 b0 b1 a0 a1
+					__m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + k)), zero);
+					pixels = _mm_unpacklo_epi16(pixels, _mm_srli_si128(pixels, 8));
+
+					sum = _mm_add_epi32(sum, _mm_madd_epi16(pixels, weightPair(weights[k], weights[k + 1])));
+				}
+
+				if (k < count)
+				{
+					const __m128i pixel = _mm_unpacklo_epi16(_mm_unpacklo_epi8(loadPixel(p + k), zero), zero);
+
+					sum = _mm_add_epi32(sum, _mm_madd_epi16(pixel, weightPair(weights[k], 0)));
+				}
+
+				sum = _mm_srai_epi32(sum, weightBits);
+				sum = _mm_packus_epi16(_mm_packs_epi32(sum, sum), zero);
+
+				const Int32 result = _mm_cvtsi128_si32(sum);
+				std::memcpy(dest + x, &result, sizeof(result));
+#else
+				Int32 r = weightHalf, g = weightHalf, b = weightHalf, a = weightHalf;
+
+				for (Int32 k = 0; k < count; k++)
+				{
+					r += p[k].red   * weights[k];
+					g += p[k].green * weights[k];
+					b += p[k].blue  * weights[k];
+					a += p[k].alpha * weights[k];
+				}
+
+				dest[x] = { clamp8(r), clamp8(g), clamp8(b), clamp8(a) };
+#endif
+			}
+		}
+
+		void resampleColumn(const Byte* source, std::size_t pitch, Color4* dest, Int32 width, Int32 count, const Int16* weights) noexcept
+		{
+			const auto row = [&](Int32 k)
+			{
+				return reinterpret_cast<const Color4*>(source + k * pitch);
+			};
+
+			Int32 x = 0;
+
+#if defined(NENE_SIMD_AVX2)
+			for (; x + 8 <= width; x += 8)
+			{
+				const __m256i zero = _mm256_setzero_si256();
+
+				// Pixel i and i+4 share a register since unpacking works per 128bit lane.
+				__m256i s0 = _mm256_set1_epi32(weightHalf);
+				__m256i s1 = s0, s2 = s0, s3 = s0;
+
+				Int32 k = 0;
+
+				for (; k + 1 < count; k += 2)
+				{
+					const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row(k    ) + x));
+					const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row(k + 1) + x));
+					const __m256i w = _mm256_set1_epi32(static_cast<Int32>((static_cast<UInt32>(static_cast<UInt16>(weights[k + 1])) << 16) | static_cast<UInt16>(weights[k])));
+
+					const __m256i lo = _mm256_unpacklo_epi8(a, b);
+					const __m256i hi = _mm256_unpackhi_epi8(a, b);
+
+					s0 = _mm256_add_epi32(s0, _mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero), w));
+					s1 = _mm256_add_epi32(s1, _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero), w));
+					s2 = _mm256_add_epi32(s2, _mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero), w));
+					s3 = _mm256_add_epi32(s3, _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero), w));
+				}
+
+				if (k < count)
+				{
+					const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row(k) + x));
+					const __m256i w = _mm256_set1_epi32(static_cast<UInt16>(weights[k]));
+
+					const __m256i lo = _mm256_unpacklo_epi8(a, zero);
+					const __m256i hi = _mm256_unpackhi_epi8(a, zero);
+
+					s0 = _mm256_add_epi32(s0, _mm256_madd_epi16(_mm256_unpacklo_epi16(lo, zero), w));
+					s1 = _mm256_add_epi32(s1, _mm256_madd_epi16(_mm256_unpackhi_epi16(lo, zero), w));
+					s2 = _mm256_add_epi32(s2, _mm256_madd_epi16(_mm256_unpacklo_epi16(hi, zero), w));
+					s3 = _mm256_add_epi32(s3, _mm256_madd_epi16(_mm256_unpackhi_epi16(hi, zero), w));
+				}
+
+				s0 = _mm256_srai_epi32(s0, weightBits);
+				s1 = _mm256_srai_epi32(s1, weightBits);
+				s2 = _mm256_srai_epi32(s2, weightBits);
+				s3 = _mm256_srai_epi32(s3, weightBits);
+
+				const __m256i result = _mm256_packus_epi16(_mm256_packs_epi32(s0, s1), _mm256_packs_epi32(s2, s3));
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + x), result);
+			}
+#endif
+
+#if defined(NENE_SIMD_SSE2)
+			for (; x + 4 <= width; x += 4)
+			{
+				const __m128i zero = _mm_setzero_si128();
+
+				__m128i s0 = _mm_set1_epi32(weightHalf);
+				__m128i s1 = s0, s2 = s0, s3 = s0;
+
+				Int32 k = 0;
+
+				for (; k + 1 < count; k += 2)
+				{
+					const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row(k    ) + x));
+					const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row(k + 1) + x));
+					const __m128i w = weightPair(weights[k], weights[k + 1]);
+
+					const __m128i lo = _mm_unpacklo_epi8(a, b);
+					const __m128i hi = _mm_unpackhi_epi8(a, b);
+
+					s0 = _mm_add_epi32(s0, _mm_madd_epi16(_mm_unpacklo_epi8(lo, zero), w));
+					s1 = _mm_add_epi32(s1, _mm_madd_epi16(_mm_unpackhi_epi8(lo, zero), w));
+					s2 = _mm_add_epi32(s2, _mm_madd_epi16(_mm_unpacklo_epi8(hi, zero), w));
+					s3 = _mm_add_epi32(s3, _mm_madd_epi16(_mm_unpackhi_epi8(hi, zero), w));
+				}
+
+				if (k < count)
+				{
+					const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row(k) + x));
+					const __m128i w = weightPair(weights[k], 0);
+
+					const __m128i lo = _mm_unpacklo_epi8(a, zero);
+					const __m128i hi = _mm_unpackhi_epi8(a, zero);
+
+					s0 = _mm_add_epi32(s0, _mm_madd_epi16(_mm_unpacklo_epi16(lo, zero), w));
+					s1 = _mm_add_epi32(s1, _mm_madd_epi16(_mm_unpackhi_epi16(lo, zero), w));
+					s2 = _mm_add_epi32(s2, _mm_madd_epi16(_mm_unpacklo_epi16(hi, zero), w));
+					s3 = _mm_add_epi32(s3, _mm_madd_epi16(_mm_unpackhi_epi16(hi, zero), w));
+				}
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x), packPixels(s0, s1, s2, s3));
+			}
+#endif
+
+			for (; x < width; x++)
+			{
+				Int32 r = weightHalf, g = weightHalf, b = weightHalf, a = weightHalf;
+
+				for (Int32 k = 0; k < count; k++)
+				{
+					const Color4& p = row(k)[x];
+
+					r += p.red   * weights[k];
+					g += p.green * weights[k];
+					b += p.blue  * weights[k];
+					a += p.alpha * weights[k];
+				}
+
+				dest[x] = { clamp8(r), clamp8(g), clamp8(b), clamp8(a) };
+			}
+		}
+
+		[[nodiscard]]
+		Int32 rowsPerTask(Int32 height, const ThreadPool& pool) noexcept
+		{
+			// A few chunks per worker keep the threads busy until the end.
+			const auto chunks = static_cast<Int32>(pool.numThreads() + 1) * 4;
+
+			return (std::max)((height + chunks - 1) / chunks, 1);
+		}
+
+		[[nodiscard]]
+		Image resizeHorizontal(ImageView image, Int32 width, const Filter& filter, ThreadPool& pool)
+		{
+			const auto coefficients = computeCoefficients(image.width(), width, filter);
+
+			Image result { width, image.height() };
+
+			pool.parallelFor(0, image.height(), rowsPerTask(image.height(), pool), [&](Int32 begin, Int32 end)
+			{
+				for (Int32 y = begin; y < end; y++)
+				{
+					resampleRow(
+						image.row(y),
+						result.row(y),
+						width,
+						coefficients);
+				}
+			});
+
+			return result;
+		}
+
+		[[nodiscard]]
+		Image resizeVertical(ImageView image, Int32 height, const Filter& filter, ThreadPool& pool)
+		{
+			const auto coefficients = computeCoefficients(image.height(), height, filter);
+
+			Image result { image.width(), height };
+
+			pool.parallelFor(0, height, rowsPerTask(height, pool), [&](Int32 begin, Int32 end)
+			{
+				for (Int32 y = begin; y < end; y++)
+				{
+					resampleColumn(
+						image.dataBytes() + coefficients.first[y] * image.pitch(),
+						image.pitch(),
+						result.row(y),
+						image.width(),
+						coefficients.count[y],
+						&coefficients.weights[static_cast<std::size_t>(y) * coefficients.stride]);
+				}
+			});
+
+			return result;
+		}
+	}
+
+	Image resize(ImageView image, const Size2Di& size, ResizeFilter filter)
+	{
+		return resize(image, size, filter, ThreadPool::shared());
+	}
+
+	Image resize(ImageView image, const Size2Di& size, ResizeFilter filter, ThreadPool& pool)
+	{
+		assert(size.width  > 0);
+		assert(size.height > 0);
+
+		const auto& f = filterOf(filter);
+
+		if (size.width == image.width())
+		{
+			return size.height == image.height()
+				? Image { image }
+				: resizeVertical(image, size.height, f, pool);
+		}
+
+		if (size.height == image.height())
+		{
+			return resizeHorizontal(image, size.width, f, pool);
+		}
+
+		return resizeVertical(resizeHorizontal(image, size.width, f, pool), size.height, f, pool);
+	}
+}
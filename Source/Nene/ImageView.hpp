@@ -0,0 +1,550 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_IMAGEVIEW_HPP
+#define INCLUDE_NENE_IMAGEVIEW_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include "Color.hpp"
+#include "Size2D.hpp"
+#include "Vector2D.hpp"
+#include "Geometry/Rectangle.hpp"
+
+namespace Nene
+{
+	/**
+	 * @brief      Non-owning reference to a rectangle of pixels.
+	 *
+	 *             Rows are `pitch()` bytes apart, so a view can refer to a
+	 *             sub-rectangle of a larger image without copying.
+	 *
+	 * @tparam     Pixel  The pixel type.
+	 */
+	template <typename Pixel>
+	class BasicImageView
+	{
+		const Byte* data_;
+		Size2Di     size_;
+		std::size_t pitch_;
+
+	public:
+		using value_type = Pixel;
+
+		/**
+		 * @brief      Default constructor.
+		 */
+		constexpr BasicImageView() noexcept
+			: data_(nullptr), size_(0, 0), pitch_(0) {}
+
+		/**
+		 * @brief      Copy constructor.
+		 */
+		constexpr BasicImageView(const BasicImageView&) noexcept =default;
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  data  Pointer to the top left pixel.
+		 * @param[in]  size  The view size.
+		 */
+		constexpr BasicImageView(const Pixel* data, const Size2Di& size) noexcept
+			: BasicImageView(data, size, size.width * sizeof(Pixel)) {}
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  data   Pointer to the top left pixel.
+		 * @param[in]  size   The view size.
+		 * @param[in]  pitch  Distance between the rows in bytes.
+		 */
+		constexpr BasicImageView(const Pixel* data, const Size2Di& size, std::size_t pitch) noexcept
+			: data_(reinterpret_cast<const Byte*>(data)), size_(size), pitch_(pitch)
+		{
+			assert(size.width  >= 0);
+			assert(size.height >= 0);
+			assert(pitch >= size.width * sizeof(Pixel));
+		}
+
+		/**
+		 * @brief      Destructor.
+		 */
+		~BasicImageView() =default;
+
+		/**
+		 * @brief      Returns the view width.
+		 *
+		 * @return     The view width.
+		 */
+		[[nodiscard]]
+		constexpr Int32 width() const noexcept
+		{
+			return size_.width;
+		}
+
+		/**
+		 * @brief      Returns the view height.
+		 *
+		 * @return     The view height.
+		 */
+		[[nodiscard]]
+		constexpr Int32 height() const noexcept
+		{
+			return size_.height;
+		}
+
+		/**
+		 * @brief      Returns the view size.
+		 *
+		 * @return     The view size.
+		 */
+		[[nodiscard]]
+		constexpr Size2Di size() const noexcept
+		{
+			return size_;
+		}
+
+		/**
+		 * @brief      Returns distance between the rows in bytes.
+		 *
+		 * @return     The row pitch in bytes.
+		 */
+		[[nodiscard]]
+		constexpr std::size_t pitch() const noexcept
+		{
+			return pitch_;
+		}
+
+		/**
+		 * @brief      Checks whether the view has no pixels.
+		 *
+		 * @return     `true` if the view is empty, `false` otherwise.
+		 */
+		[[nodiscard]]
+		constexpr bool empty() const noexcept
+		{
+			return size_.width <= 0 || size_.height <= 0;
+		}
+
+		/**
+		 * @brief      Checks whether the rows are laid out without gaps.
+		 *
+		 * @return     `true` if the pixels are contiguous, `false` otherwise.
+		 */
+		[[nodiscard]]
+		constexpr bool isContiguous() const noexcept
+		{
+			return pitch_ == size_.width * sizeof(Pixel) || size_.height <= 1;
+		}
+
+		/**
+		 * @brief      Returns number of pixels the view contains.
+		 *
+		 * @return     Number of pixels the view contains.
+		 */
+		[[nodiscard]]
+		constexpr std::size_t numPixels() const noexcept
+		{
+			return static_cast<std::size_t>(size_.width) * size_.height;
+		}
+
+		/**
+		 * @brief      Returns the pointer to the top left pixel.
+		 *
+		 * @return     The pointer to the top left pixel.
+		 */
+		[[nodiscard]]
+		const Pixel* dataPointer() const noexcept
+		{
+			return reinterpret_cast<const Pixel*>(data_);
+		}
+
+		/**
+		 * @brief      Returns the pointer to the top left pixel bytes.
+		 *
+		 * @return     The pointer to the top left pixel bytes.
+		 */
+		[[nodiscard]]
+		constexpr const Byte* dataBytes() const noexcept
+		{
+			return data_;
+		}
+
+		/**
+		 * @brief      Returns the row.
+		 *
+		 * @param[in]  y     The row index.
+		 *
+		 * @return     The pointer to the first pixel of the row.
+		 */
+		[[nodiscard]]
+		const Pixel* row(Int32 y) const noexcept
+		{
+			assert(0 <= y && y < size_.height);
+
+			return reinterpret_cast<const Pixel*>(data_ + y * pitch_);
+		}
+
+		/**
+		 * @brief      Returns the pixel.
+		 *
+		 * @param[in]  x     The column index.
+		 * @param[in]  y     The row index.
+		 *
+		 * @return     The pixel at `(x, y)`.
+		 */
+		[[nodiscard]]
+		const Pixel& operator()(Int32 x, Int32 y) const noexcept
+		{
+			assert(0 <= x && x < size_.width);
+
+			return row(y)[x];
+		}
+
+		/**
+		 * @brief      Operator `[]`.
+		 *
+		 * @param[in]  position  The pixel location.
+		 *
+		 * @return     The pixel at `position`.
+		 */
+		[[nodiscard]]
+		const Pixel& operator[](const Vector2Di& position) const noexcept
+		{
+			return (*this)(position.x, position.y);
+		}
+
+		/**
+		 * @brief      Returns a view of the sub-rectangle.
+		 *
+		 * @param[in]  rect  The rectangle to refer.
+		 *
+		 * @return     The view of the sub-rectangle.
+		 */
+		[[nodiscard]]
+		BasicImageView subView(const Rectanglei& rect) const noexcept
+		{
+			assert(0 <= rect.left() && rect.right()  <= size_.width);
+			assert(0 <= rect.top()  && rect.bottom() <= size_.height);
+
+			return { reinterpret_cast<const Pixel*>(data_ + rect.top() * pitch_) + rect.left(), rect.size, pitch_ };
+		}
+
+		/**
+		 * @brief      Returns a view of the rows.
+		 *
+		 * @param[in]  first  The first row.
+		 * @param[in]  count  Number of the rows.
+		 *
+		 * @return     The view of the rows.
+		 */
+		[[nodiscard]]
+		BasicImageView rows(Int32 first, Int32 count) const noexcept
+		{
+			return subView({ { 0, first }, { size_.width, count } });
+		}
+
+		/**
+		 * @brief      Copy operator `=`.
+		 */
+		constexpr BasicImageView& operator=(const BasicImageView&) noexcept =default;
+	};
+
+	/**
+	 * @brief      Non-owning mutable reference to a rectangle of pixels.
+	 *
+	 * @tparam     Pixel  The pixel type.
+	 */
+	template <typename Pixel>
+	class BasicMutableImageView
+	{
+		Byte*       data_;
+		Size2Di     size_;
+		std::size_t pitch_;
+
+	public:
+		using value_type = Pixel;
+
+		/**
+		 * @brief      Default constructor.
+		 */
+		constexpr BasicMutableImageView() noexcept
+			: data_(nullptr), size_(0, 0), pitch_(0) {}
+
+		/**
+		 * @brief      Copy constructor.
+		 */
+		constexpr BasicMutableImageView(const BasicMutableImageView&) noexcept =default;
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  data  Pointer to the top left pixel.
+		 * @param[in]  size  The view size.
+		 */
+		constexpr BasicMutableImageView(Pixel* data, const Size2Di& size) noexcept
+			: BasicMutableImageView(data, size, size.width * sizeof(Pixel)) {}
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  data   Pointer to the top left pixel.
+		 * @param[in]  size   The view size.
+		 * @param[in]  pitch  Distance between the rows in bytes.
+		 */
+		constexpr BasicMutableImageView(Pixel* data, const Size2Di& size, std::size_t pitch) noexcept
+			: data_(reinterpret_cast<Byte*>(data)), size_(size), pitch_(pitch)
+		{
+			assert(size.width  >= 0);
+			assert(size.height >= 0);
+			assert(pitch >= size.width * sizeof(Pixel));
+		}
+
+		/**
+		 * @brief      Destructor.
+		 */
+		~BasicMutableImageView() =default;
+
+		/**
+		 * @brief      Converts into the immutable view.
+		 */
+		constexpr operator BasicImageView<Pixel>() const noexcept
+		{
+			return { reinterpret_cast<const Pixel*>(data_), size_, pitch_ };
+		}
+
+		/**
+		 * @brief      Returns the view width.
+		 *
+		 * @return     The view width.
+		 */
+		[[nodiscard]]
+		constexpr Int32 width() const noexcept
+		{
+			return size_.width;
+		}
+
+		/**
+		 * @brief      Returns the view height.
+		 *
+		 * @return     The view height.
+		 */
+		[[nodiscard]]
+		constexpr Int32 height() const noexcept
+		{
+			return size_.height;
+		}
+
+		/**
+		 * @brief      Returns the view size.
+		 *
+		 * @return     The view size.
+		 */
+		[[nodiscard]]
+		constexpr Size2Di size() const noexcept
+		{
+			return size_;
+		}
+
+		/**
+		 * @brief      Returns distance between the rows in bytes.
+		 *
+		 * @return     The row pitch in bytes.
+		 */
+		[[nodiscard]]
+		constexpr std::size_t pitch() const noexcept
+		{
+			return pitch_;
+		}
+
+		/**
+		 * @brief      Checks whether the view has no pixels.
+		 *
+		 * @return     `true` if the view is empty, `false` otherwise.
+		 */
+		[[nodiscard]]
+		constexpr bool empty() const noexcept
+		{
+			return size_.width <= 0 || size_.height <= 0;
+		}
+
+		/**
+		 * @brief      Checks whether the rows are laid out without gaps.
+		 *
+		 * @return     `true` if the pixels are contiguous, `false` otherwise.
+		 */
+		[[nodiscard]]
+		constexpr bool isContiguous() const noexcept
+		{
+			return pitch_ == size_.width * sizeof(Pixel) || size_.height <= 1;
+		}
+
+		/**
+		 * @brief      Returns number of pixels the view contains.
+		 *
+		 * @return     Number of pixels the view contains.
+		 */
+		[[nodiscard]]
+		constexpr std::size_t numPixels() const noexcept
+		{
+			return static_cast<std::size_t>(size_.width) * size_.height;
+		}
+
+		/**
+		 * @brief      Returns the pointer to the top left pixel.
+		 *
+		 * @return     The pointer to the top left pixel.
+		 */
+		[[nodiscard]]
+		Pixel* dataPointer() const noexcept
+		{
+			return reinterpret_cast<Pixel*>(data_);
+		}
+
+		/**
+		 * @brief      Returns the pointer to the top left pixel bytes.
+		 *
+		 * @return     The pointer to the top left pixel bytes.
+		 */
+		[[nodiscard]]
+		constexpr Byte* dataBytes() const noexcept
+		{
+			return data_;
+		}
+
+		/**
+		 * @brief      Returns the row.
+		 *
+		 * @param[in]  y     The row index.
+		 *
+		 * @return     The pointer to the first pixel of the row.
+		 */
+		[[nodiscard]]
+		Pixel* row(Int32 y) const noexcept
+		{
+			assert(0 <= y && y < size_.height);
+
+			return reinterpret_cast<Pixel*>(data_ + y * pitch_);
+		}
+
+		/**
+		 * @brief      Returns the pixel.
+		 *
+		 * @param[in]  x     The column index.
+		 * @param[in]  y     The row index.
+		 *
+		 * @return     The pixel at `(x, y)`.
+		 */
+		[[nodiscard]]
+		Pixel& operator()(Int32 x, Int32 y) const noexcept
+		{
+			assert(0 <= x && x < size_.width);
+
+			return row(y)[x];
+		}
+
+		/**
+		 * @brief      Operator `[]`.
+		 *
+		 * @param[in]  position  The pixel location.
+		 *
+		 * @return     The pixel at `position`.
+		 */
+		[[nodiscard]]
+		Pixel& operator[](const Vector2Di& position) const noexcept
+		{
+			return (*this)(position.x, position.y);
+		}
+
+		/**
+		 * @brief      Returns a view of the sub-rectangle.
+		 *
+		 * @param[in]  rect  The rectangle to refer.
+		 *
+		 * @return     The view of the sub-rectangle.
+		 */
+		[[nodiscard]]
+		BasicMutableImageView subView(const Rectanglei& rect) const noexcept
+		{
+			assert(0 <= rect.left() && rect.right()  <= size_.width);
+			assert(0 <= rect.top()  && rect.bottom() <= size_.height);
+
+			return { reinterpret_cast<Pixel*>(data_ + rect.top() * pitch_) + rect.left(), rect.size, pitch_ };
+		}
+
+		/**
+		 * @brief      Returns a view of the rows.
+		 *
+		 * @param[in]  first  The first row.
+		 * @param[in]  count  Number of the rows.
+		 *
+		 * @return     The view of the rows.
+		 */
+		[[nodiscard]]
+		BasicMutableImageView rows(Int32 first, Int32 count) const noexcept
+		{
+			return subView({ { 0, first }, { size_.width, count } });
+		}
+
+		/**
+		 * @brief      Fills the pixels.
+		 *
+		 * @param[in]  pixel  The fill value.
+		 */
+		void fill(const Pixel& pixel) const noexcept
+		{
+			for (Int32 y = 0; y < size_.height; y++)
+			{
+				std::fill_n(row(y), size_.width, pixel);
+			}
+		}
+
+		/**
+		 * @brief      Copies the pixels from the view of the same size.
+		 *
+		 * @param[in]  source  The pixels to copy.
+		 */
+		void copyFrom(const BasicImageView<Pixel>& source) const noexcept
+		{
+			assert(source.size() == size_);
+
+			const std::size_t rowBytes = size_.width * sizeof(Pixel);
+
+			for (Int32 y = 0; y < size_.height; y++)
+			{
+				std::memcpy(row(y), source.row(y), rowBytes);
+			}
+		}
+
+		/**
+		 * @brief      Copy operator `=`.
+		 */
+		constexpr BasicMutableImageView& operator=(const BasicMutableImageView&) noexcept =default;
+	};
+
+	using ImageView        = BasicImageView<Color4>;
+	using MutableImageView = BasicMutableImageView<Color4>;
+}
+
+#endif  // #ifndef INCLUDE_NENE_IMAGEVIEW_HPP
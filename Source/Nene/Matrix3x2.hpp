@@ -282,8 +282,8 @@ namespace Nene
 
 			return Matrix3x2 {
 				( _22) / det,
-				(-_21) / det,
 				(-_12) / det,
+				(-_21) / det,
 				( _11) / det,
 				(_21*_32 - _22*_31) / det,
 				(_12*_31 - _11*_32) / det,
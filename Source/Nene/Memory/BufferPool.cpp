@@ -0,0 +1,134 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#include <new>
+#include "BufferPool.hpp"
+
+namespace Nene
+{
+	std::size_t BufferPool::blockSize(std::size_t size) noexcept
+	{
+		constexpr std::size_t minBlockSize = 4096;
+
+		if (size <= minBlockSize)
+		{
+			return minBlockSize;
+		}
+
+		// Four size classes per power of two.
+		std::size_t power = minBlockSize;
+
+		while (power * 2 < size)
+		{
+			power *= 2;
+		}
+
+		const auto step = power / 4;
+
+		return (size + step - 1) / step * step;
+	}
+
+	BufferPool::BufferPool(std::size_t maxCachedBytes)
+		: freeBlocks_()
+		, mutex_()
+		, cachedBytes_(0)
+		, maxCachedBytes_(maxCachedBytes) {}
+
+	BufferPool::~BufferPool()
+	{
+		clear();
+	}
+
+	Byte* BufferPool::allocate(std::size_t size)
+	{
+		const auto bytes = blockSize(size);
+
+		{
+			std::lock_guard<std::mutex> lock { mutex_ };
+
+			if (const auto it = freeBlocks_.find(bytes); it != freeBlocks_.end() && !it->second.empty())
+			{
+				const auto block = it->second.back();
+
+				it->second.pop_back();
+				cachedBytes_ -= bytes;
+
+				return block;
+			}
+		}
+
+		return static_cast<Byte*>(::operator new(bytes));
+	}
+
+	void BufferPool::deallocate(Byte* block, std::size_t size) noexcept
+	{
+		if (!block)
+		{
+			return;
+		}
+
+		const auto bytes = blockSize(size);
+
+		try
+		{
+			std::lock_guard<std::mutex> lock { mutex_ };
+
+			if (cachedBytes_ + bytes <= maxCachedBytes_)
+			{
+				freeBlocks_[bytes].push_back(block);
+				cachedBytes_ += bytes;
+
+				return;
+			}
+		}
+		catch (...)
+		{
+			// Failed to cache the block.
+		}
+
+		::operator delete(block);
+	}
+
+	void BufferPool::clear() noexcept
+	{
+		std::lock_guard<std::mutex> lock { mutex_ };
+
+		for (auto& [bytes, blocks] : freeBlocks_)
+		{
+			for (const auto block : blocks)
+			{
+				::operator delete(block);
+			}
+		}
+
+		freeBlocks_.clear();
+		cachedBytes_ = 0;
+	}
+
+	std::size_t BufferPool::cachedBytes() noexcept
+	{
+		std::lock_guard<std::mutex> lock { mutex_ };
+
+		return cachedBytes_;
+	}
+}
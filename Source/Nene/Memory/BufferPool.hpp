@@ -0,0 +1,107 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_MEMORY_BUFFERPOOL_HPP
+#define INCLUDE_NENE_MEMORY_BUFFERPOOL_HPP
+
+#include <map>
+#include <mutex>
+#include <vector>
+#include "../Byte.hpp"
+#include "../Uncopyable.hpp"
+
+namespace Nene
+{
+	/**
+	 * @brief      Thread safe pool which recycles large memory blocks.
+	 *
+	 *             Requests are rounded up to size classes so that buffers of
+	 *             similar size, e.g. images of every frame, share blocks.
+	 */
+	class BufferPool final
+		: private Uncopyable
+	{
+		std::map<std::size_t, std::vector<Byte*>> freeBlocks_;
+		std::mutex                                mutex_;
+		std::size_t                               cachedBytes_;
+		std::size_t                               maxCachedBytes_;
+
+	public:
+		/**
+		 * @brief      Returns the size class for the request.
+		 *
+		 * @param[in]  size  The requested size in bytes.
+		 *
+		 * @return     The size of the block to allocate.
+		 */
+		[[nodiscard]]
+		static std::size_t blockSize(std::size_t size) noexcept;
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  maxCachedBytes  Maximum bytes of the free blocks to keep.
+		 */
+		explicit BufferPool(std::size_t maxCachedBytes = 256 * 1024 * 1024);
+
+		/**
+		 * @brief      Destructor.
+		 *
+		 *             Every block must have been returned to the pool.
+		 */
+		~BufferPool();
+
+		/**
+		 * @brief      Allocates a memory block.
+		 *
+		 * @param[in]  size  The requested size in bytes.
+		 *
+		 * @return     The memory block of at least `size` bytes.
+		 */
+		[[nodiscard]]
+		Byte* allocate(std::size_t size);
+
+		/**
+		 * @brief      Returns a memory block to the pool.
+		 *
+		 * @param      block  The block returned by `allocate()`.
+		 * @param[in]  size   The size passed to `allocate()`.
+		 */
+		void deallocate(Byte* block, std::size_t size) noexcept;
+
+		/**
+		 * @brief      Releases the cached free blocks.
+		 */
+		void clear() noexcept;
+
+		/**
+		 * @brief      Returns bytes of the cached free blocks.
+		 *
+		 * @return     Bytes of the cached free blocks.
+		 */
+		[[nodiscard]]
+		std::size_t cachedBytes() noexcept;
+	};
+}
+
+#endif  // #ifndef INCLUDE_NENE_MEMORY_BUFFERPOOL_HPP
@@ -0,0 +1,128 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_MEMORY_POOLALLOCATOR_HPP
+#define INCLUDE_NENE_MEMORY_POOLALLOCATOR_HPP
+
+#include "BufferPool.hpp"
+
+namespace Nene
+{
+	/**
+	 * @brief      Allocator which takes memory blocks from `BufferPool`.
+	 *
+	 * @tparam     T     The element type.
+	 */
+	template <typename T>
+	class PoolAllocator
+	{
+		template <typename U>
+		friend class PoolAllocator;
+
+		BufferPool* pool_;
+
+	public:
+		using value_type = T;
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param      pool  The pool to allocate from. It must outlive the allocator.
+		 */
+		explicit PoolAllocator(BufferPool& pool) noexcept
+			: pool_(&pool) {}
+
+		/**
+		 * @brief      Copy constructor.
+		 */
+		PoolAllocator(const PoolAllocator&) noexcept =default;
+
+		/**
+		 * @brief      Converting constructor.
+		 */
+		template <typename U>
+		PoolAllocator(const PoolAllocator<U>& allocator) noexcept
+			: pool_(allocator.pool_) {}
+
+		/**
+		 * @brief      Destructor.
+		 */
+		~PoolAllocator() =default;
+
+		/**
+		 * @brief      Copy operator `=`.
+		 */
+		PoolAllocator& operator=(const PoolAllocator&) noexcept =default;
+
+		/**
+		 * @brief      Allocates elements.
+		 *
+		 * @param[in]  n     Number of the elements.
+		 *
+		 * @return     The pointer to the allocated elements.
+		 */
+		[[nodiscard]]
+		T* allocate(std::size_t n)
+		{
+			return reinterpret_cast<T*>(pool_->allocate(n * sizeof(T)));
+		}
+
+		/**
+		 * @brief      Deallocates elements.
+		 *
+		 * @param      p     The pointer returned by `allocate()`.
+		 * @param[in]  n     Number of the elements.
+		 */
+		void deallocate(T* p, std::size_t n) noexcept
+		{
+			pool_->deallocate(reinterpret_cast<Byte*>(p), n * sizeof(T));
+		}
+
+		/**
+		 * @brief      Returns the pool.
+		 *
+		 * @return     The pool to allocate from.
+		 */
+		[[nodiscard]]
+		BufferPool& pool() const noexcept
+		{
+			return *pool_;
+		}
+
+		template <typename U>
+		[[nodiscard]]
+		bool operator==(const PoolAllocator<U>& allocator) const noexcept
+		{
+			return pool_ == allocator.pool_;
+		}
+
+		template <typename U>
+		[[nodiscard]]
+		bool operator!=(const PoolAllocator<U>& allocator) const noexcept
+		{
+			return pool_ != allocator.pool_;
+		}
+	};
+}
+
+#endif  // #ifndef INCLUDE_NENE_MEMORY_POOLALLOCATOR_HPP
@@ -0,0 +1,232 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_MIPCHAIN_HPP
+#define INCLUDE_NENE_MIPCHAIN_HPP
+
+#include <vector>
+#include "ArrayView.hpp"
+#include "ImageView.hpp"
+
+namespace Nene
+{
+	/**
+	 * @brief      Mipmap levels of an image in one contiguous buffer.
+	 *
+	 *             Level `i` is `max(1, width >> i)` by `max(1, height >> i)`
+	 *             pixels with packed rows, placed right after level `i - 1`.
+	 */
+	class MipChain
+	{
+		std::vector<Color4>      data_;
+		std::vector<std::size_t> offsets_;
+		std::vector<Size2Di>     sizes_;
+
+	public:
+		/**
+		 * @brief      Returns number of levels of the full chain.
+		 *
+		 * @param[in]  size  The size of the top level.
+		 *
+		 * @return     Number of levels down to 1x1.
+		 */
+		[[nodiscard]]
+		static Int32 fullLevels(const Size2Di& size) noexcept
+		{
+			Int32 levels = 1;
+
+			for (auto n = (std::max)(size.width, size.height); n > 1; n /= 2)
+			{
+				levels++;
+			}
+
+			return levels;
+		}
+
+		/**
+		 * @brief      Default constructor.
+		 */
+		MipChain() =delete;
+
+		/**
+		 * @brief      Copy constructor.
+		 */
+		MipChain(const MipChain&) =delete;
+
+		/**
+		 * @brief      Move constructor.
+		 */
+		MipChain(MipChain&&) =default;
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  size       The size of the top level.
+		 * @param[in]  numLevels  Number of the levels.
+		 */
+		explicit MipChain(const Size2Di& size, Int32 numLevels)
+			: data_()
+			, offsets_()
+			, sizes_()
+		{
+			assert(size.width  > 0);
+			assert(size.height > 0);
+			assert(0 < numLevels && numLevels <= fullLevels(size));
+
+			std::size_t offset = 0;
+
+			for (Int32 i = 0; i < numLevels; i++)
+			{
+				const Size2Di levelSize { (std::max)(size.width >> i, 1), (std::max)(size.height >> i, 1) };
+
+				offsets_.emplace_back(offset);
+				sizes_.emplace_back(levelSize);
+
+				offset += static_cast<std::size_t>(levelSize.width) * levelSize.height;
+			}
+
+			data_.resize(offset);
+		}
+
+		/**
+		 * @brief      Destructor.
+		 */
+		~MipChain() =default;
+
+		/**
+		 * @brief      Copy operator `=`.
+		 */
+		MipChain& operator=(const MipChain&) =delete;
+
+		/**
+		 * @brief      Move operator `=`.
+		 */
+		MipChain& operator=(MipChain&&) =default;
+
+		/**
+		 * @brief      Returns number of the levels.
+		 *
+		 * @return     Number of the levels.
+		 */
+		[[nodiscard]]
+		Int32 numLevels() const noexcept
+		{
+			return static_cast<Int32>(sizes_.size());
+		}
+
+		/**
+		 * @brief      Returns the level size.
+		 *
+		 * @param[in]  level  The level index.
+		 *
+		 * @return     The size of the level.
+		 */
+		[[nodiscard]]
+		Size2Di size(Int32 level) const noexcept
+		{
+			assert(0 <= level && level < numLevels());
+
+			return sizes_[level];
+		}
+
+		/**
+		 * @brief      Returns the offset of the level in the buffer.
+		 *
+		 * @param[in]  level  The level index.
+		 *
+		 * @return     The offset of the level in bytes.
+		 */
+		[[nodiscard]]
+		std::size_t offset(Int32 level) const noexcept
+		{
+			assert(0 <= level && level < numLevels());
+
+			return offsets_[level] * sizeof(Color4);
+		}
+
+		/**
+		 * @brief      Returns the view of the level.
+		 *
+		 * @param[in]  level  The level index.
+		 *
+		 * @return     The view of the level pixels.
+		 */
+		[[nodiscard]]
+		ImageView level(Int32 level) const noexcept
+		{
+			assert(0 <= level && level < numLevels());
+
+			return { data_.data() + offsets_[level], sizes_[level] };
+		}
+
+		/**
+		 * @brief      Returns the mutable view of the level.
+		 *
+		 * @param[in]  level  The level index.
+		 *
+		 * @return     The mutable view of the level pixels.
+		 */
+		[[nodiscard]]
+		MutableImageView mutableLevel(Int32 level) noexcept
+		{
+			assert(0 <= level && level < numLevels());
+
+			return { data_.data() + offsets_[level], sizes_[level] };
+		}
+
+		/**
+		 * @brief      Returns the pixels of all the levels.
+		 *
+		 * @return     The array of the pixels.
+		 */
+		[[nodiscard]]
+		ArrayView<Color4> data() const noexcept
+		{
+			return data_;
+		}
+
+		/**
+		 * @brief      Returns the pointer to the byte data of all the levels.
+		 *
+		 * @return     The pointer to the byte data.
+		 */
+		[[nodiscard]]
+		const Byte* dataBytes() const noexcept
+		{
+			return reinterpret_cast<const Byte*>(data_.data());
+		}
+
+		/**
+		 * @brief      Returns bytes size of all the levels.
+		 *
+		 * @return     Bytes size of all the levels.
+		 */
+		[[nodiscard]]
+		std::size_t sizeBytes() const noexcept
+		{
+			return data_.size() * sizeof(Color4);
+		}
+	};
+}
+
+#endif  // #ifndef INCLUDE_NENE_MIPCHAIN_HPP
@@ -0,0 +1,310 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_PIXELFORMAT_HPP
+#define INCLUDE_NENE_PIXELFORMAT_HPP
+
+#include <algorithm>
+#include "Color.hpp"
+#include "Float16.hpp"
+
+namespace Nene
+{
+	/**
+	 * @brief      Pixel formats.
+	 *
+	 *             Single channel formats hold gray scale and two channel
+	 *             formats hold gray scale with alpha when they are converted
+	 *             from or into color formats.
+	 */
+	enum class PixelFormat: Int32
+	{
+		r8,
+		rg8,
+		rgba8,
+		bgra8,
+		r16,
+		rgba16f,
+		rgba32f,
+	};
+
+	/**
+	 * @brief      8bit single channel pixel.
+	 */
+	class PixelR8
+	{
+	public:
+		UInt8 red;
+
+		constexpr PixelR8() noexcept =default;
+
+		constexpr PixelR8(UInt8 red) noexcept
+			: red(red) {}
+	};
+
+	/**
+	 * @brief      8bit two channel pixel.
+	 */
+	class PixelRG8
+	{
+	public:
+		UInt8 red, green;
+
+		constexpr PixelRG8() noexcept =default;
+
+		constexpr PixelRG8(UInt8 red, UInt8 green) noexcept
+			: red(red), green(green) {}
+	};
+
+	/**
+	 * @brief      8bit BGRA pixel.
+	 */
+	class PixelBGRA8
+	{
+	public:
+		UInt8 blue, green, red, alpha;
+
+		constexpr PixelBGRA8() noexcept =default;
+
+		constexpr PixelBGRA8(UInt8 blue, UInt8 green, UInt8 red, UInt8 alpha = 255) noexcept
+			: blue(blue), green(green), red(red), alpha(alpha) {}
+	};
+
+	/**
+	 * @brief      16bit single channel pixel.
+	 */
+	class PixelR16
+	{
+	public:
+		UInt16 red;
+
+		constexpr PixelR16() noexcept =default;
+
+		constexpr PixelR16(UInt16 red) noexcept
+			: red(red) {}
+	};
+
+	/**
+	 * @brief      Half float RGBA pixel.
+	 */
+	class PixelRGBA16F
+	{
+	public:
+		Float16 red, green, blue, alpha;
+
+		PixelRGBA16F() noexcept =default;
+
+		PixelRGBA16F(Float16 red, Float16 green, Float16 blue, Float16 alpha) noexcept
+			: red(red), green(green), blue(blue), alpha(alpha) {}
+	};
+
+	using PixelRGBA8   = Color4;
+	using PixelRGBA32F = Color4f;
+
+	namespace Detail
+	{
+		[[nodiscard]]
+		constexpr UInt8 toUnorm8(Float32 x) noexcept
+		{
+			return static_cast<UInt8>(std::clamp(x, 0.f, 1.f) * 255.f + 0.5f);
+		}
+
+		[[nodiscard]]
+		constexpr UInt16 toUnorm16(Float32 x) noexcept
+		{
+			return static_cast<UInt16>(std::clamp(x, 0.f, 1.f) * 65535.f + 0.5f);
+		}
+
+		[[nodiscard]]
+		constexpr Float32 luma(const Color4f& c) noexcept
+		{
+			return 0.299f * c.red + 0.587f * c.green + 0.114f * c.blue;
+		}
+	}
+
+	/**
+	 * @brief      Pixel type properties.
+	 *
+	 * @tparam     Pixel  The pixel type.
+	 */
+	template <typename Pixel>
+	struct PixelTraits;
+
+	template <>
+	struct PixelTraits<PixelR8>
+	{
+		static constexpr PixelFormat format   = PixelFormat::r8;
+		static constexpr Int32       channels = 1;
+
+		[[nodiscard]]
+		static constexpr Color4f toColor4f(const PixelR8& p) noexcept
+		{
+			return Color4f::gray(p.red / 255.f);
+		}
+
+		[[nodiscard]]
+		static constexpr PixelR8 fromColor4f(const Color4f& c) noexcept
+		{
+			return { Detail::toUnorm8(Detail::luma(c)) };
+		}
+	};
+
+	template <>
+	struct PixelTraits<PixelRG8>
+	{
+		static constexpr PixelFormat format   = PixelFormat::rg8;
+		static constexpr Int32       channels = 2;
+
+		[[nodiscard]]
+		static constexpr Color4f toColor4f(const PixelRG8& p) noexcept
+		{
+			return Color4f::gray(p.red / 255.f, p.green / 255.f);
+		}
+
+		[[nodiscard]]
+		static constexpr PixelRG8 fromColor4f(const Color4f& c) noexcept
+		{
+			return { Detail::toUnorm8(Detail::luma(c)), Detail::toUnorm8(c.alpha) };
+		}
+	};
+
+	template <>
+	struct PixelTraits<PixelRGBA8>
+	{
+		static constexpr PixelFormat format   = PixelFormat::rgba8;
+		static constexpr Int32       channels = 4;
+
+		[[nodiscard]]
+		static constexpr Color4f toColor4f(const PixelRGBA8& p) noexcept
+		{
+			return Color4f { p };
+		}
+
+		[[nodiscard]]
+		static constexpr PixelRGBA8 fromColor4f(const Color4f& c) noexcept
+		{
+			return { Detail::toUnorm8(c.red), Detail::toUnorm8(c.green), Detail::toUnorm8(c.blue), Detail::toUnorm8(c.alpha) };
+		}
+	};
+
+	template <>
+	struct PixelTraits<PixelBGRA8>
+	{
+		static constexpr PixelFormat format   = PixelFormat::bgra8;
+		static constexpr Int32       channels = 4;
+
+		[[nodiscard]]
+		static constexpr Color4f toColor4f(const PixelBGRA8& p) noexcept
+		{
+			return { p.red / 255.f, p.green / 255.f, p.blue / 255.f, p.alpha / 255.f };
+		}
+
+		[[nodiscard]]
+		static constexpr PixelBGRA8 fromColor4f(const Color4f& c) noexcept
+		{
+			return { Detail::toUnorm8(c.blue), Detail::toUnorm8(c.green), Detail::toUnorm8(c.red), Detail::toUnorm8(c.alpha) };
+		}
+	};
+
+	template <>
+	struct PixelTraits<PixelR16>
+	{
+		static constexpr PixelFormat format   = PixelFormat::r16;
+		static constexpr Int32       channels = 1;
+
+		[[nodiscard]]
+		static constexpr Color4f toColor4f(const PixelR16& p) noexcept
+		{
+			return Color4f::gray(p.red / 65535.f);
+		}
+
+		[[nodiscard]]
+		static constexpr PixelR16 fromColor4f(const Color4f& c) noexcept
+		{
+			return { Detail::toUnorm16(Detail::luma(c)) };
+		}
+	};
+
+	template <>
+	struct PixelTraits<PixelRGBA16F>
+	{
+		static constexpr PixelFormat format   = PixelFormat::rgba16f;
+		static constexpr Int32       channels = 4;
+
+		[[nodiscard]]
+		static Color4f toColor4f(const PixelRGBA16F& p) noexcept
+		{
+			return { p.red, p.green, p.blue, p.alpha };
+		}
+
+		[[nodiscard]]
+		static PixelRGBA16F fromColor4f(const Color4f& c) noexcept
+		{
+			return { c.red, c.green, c.blue, c.alpha };
+		}
+	};
+
+	template <>
+	struct PixelTraits<PixelRGBA32F>
+	{
+		static constexpr PixelFormat format   = PixelFormat::rgba32f;
+		static constexpr Int32       channels = 4;
+
+		[[nodiscard]]
+		static constexpr Color4f toColor4f(const PixelRGBA32F& p) noexcept
+		{
+			return p;
+		}
+
+		[[nodiscard]]
+		static constexpr PixelRGBA32F fromColor4f(const Color4f& c) noexcept
+		{
+			return c;
+		}
+	};
+
+	/**
+	 * @brief      Returns size of a pixel in bytes.
+	 *
+	 * @param[in]  format  The pixel format.
+	 *
+	 * @return     Size of a pixel of `format` in bytes.
+	 */
+	[[nodiscard]]
+	constexpr std::size_t bytesPerPixel(PixelFormat format) noexcept
+	{
+		switch (format)
+		{
+			case PixelFormat::r8     : return sizeof(PixelR8);
+			case PixelFormat::rg8    : return sizeof(PixelRG8);
+			case PixelFormat::rgba8  : return sizeof(PixelRGBA8);
+			case PixelFormat::bgra8  : return sizeof(PixelBGRA8);
+			case PixelFormat::r16    : return sizeof(PixelR16);
+			case PixelFormat::rgba16f: return sizeof(PixelRGBA16F);
+			case PixelFormat::rgba32f: return sizeof(PixelRGBA32F);
+			default                  : return 0;
+		}
+	}
+}
+
+#endif  // #ifndef INCLUDE_NENE_PIXELFORMAT_HPP
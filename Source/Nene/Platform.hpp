@@ -40,6 +40,18 @@
 #  define NENE_COMPILER_UNKNOWN
 #endif
 
+#if defined(__AVX2__)
+#  define NENE_SIMD_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define NENE_SIMD_SSE2
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#  define NENE_SIMD_SSSE3
+#endif
+
 #if defined(_DEBUG) || defined(DEBUG) || !defined(NDEBUG)
 #  define NENE_DEBUG
 #else
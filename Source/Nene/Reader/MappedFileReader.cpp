@@ -0,0 +1,93 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+#include "../Platform.hpp"
+#if defined(NENE_OS_WINDOWS)
+
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+
+#include <Windows.h>
+#include <fmt/ostream.h>
+#include "MappedFileReader.hpp"
+#include "../Exceptions/FileException.hpp"
+
+namespace Nene
+{
+	MappedFileReader::MappedFileReader(const path_type& path)
+		: path_(std::experimental::filesystem::absolute(path))
+		, data_(nullptr)
+		, size_(0)
+		, pos_(0)
+	{
+		const auto file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			throw FileException { fmt::format(u8"Could not open file '{}'.", path.u8string()) };
+		}
+
+		LARGE_INTEGER fileSize;
+
+		if (!::GetFileSizeEx(file, &fileSize))
+		{
+			::CloseHandle(file);
+
+			throw FileException { fmt::format(u8"Could not get the size of file '{}'.", path.u8string()) };
+		}
+
+		size_ = static_cast<std::size_t>(fileSize.QuadPart);
+
+		// Empty files cannot be mapped.
+		if (size_ > 0)
+		{
+			// The view keeps the mapping alive after the handles are closed.
+			const auto mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+			if (mapping)
+			{
+				data_ = static_cast<const Byte*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+				::CloseHandle(mapping);
+			}
+		}
+
+		::CloseHandle(file);
+
+		if (size_ > 0 && !data_)
+		{
+			throw FileException { fmt::format(u8"Could not map file '{}'.", path.u8string()) };
+		}
+	}
+
+	MappedFileReader::~MappedFileReader()
+	{
+		if (!data_)
+		{
+			return;
+		}
+
+		::UnmapViewOfFile(data_);
+	}
+}
+
+#endif
@@ -0,0 +1,157 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+#ifndef INCLUDE_NENE_READER_MAPPEDFILEREADER_HPP
+#define INCLUDE_NENE_READER_MAPPEDFILEREADER_HPP
+
+#include "../Platform.hpp"
+#if defined(NENE_OS_WINDOWS)
+
+#include <algorithm>
+#include <cstring>
+#include <experimental/filesystem>
+#include "../ArrayView.hpp"
+#include "../Types.hpp"
+#include "../Uncopyable.hpp"
+#include "IReader.hpp"
+
+namespace Nene
+{
+	/**
+	 * @brief      Memory mapped file reader.
+	 *
+	 *             The whole file is mapped read only, so the data can be
+	 *             accessed without copying it.
+	 */
+	class MappedFileReader final
+		: public  IReader
+		, private Uncopyable
+	{
+		std::experimental::filesystem::path path_;
+		const Byte* data_;
+		std::size_t size_;
+		std::size_t pos_;
+
+	public:
+		using path_type = std::experimental::filesystem::path;
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  path  The file path to map.
+		 */
+		explicit MappedFileReader(const path_type& path);
+
+		/**
+		 * @brief      Destructor.
+		 */
+		~MappedFileReader();
+
+		/**
+		 * @see        `Nene::IReader::eof()`.
+		 */
+		[[nodiscard]]
+		bool eof() const noexcept override
+		{
+			return pos_ >= size_;
+		}
+
+		/**
+		 * @see        `Nene::IReader::size()`.
+		 */
+		[[nodiscard]]
+		std::size_t size() const noexcept override
+		{
+			return size_;
+		}
+
+		/**
+		 * @see        `Nene::IReader::position()`.
+		 */
+		[[nodiscard]]
+		std::size_t position() const noexcept override
+		{
+			return pos_;
+		}
+
+		/**
+		 * @see        `Nene::IReader::position()`.
+		 */
+		void position(std::size_t pos) override
+		{
+			pos_ = (std::min)(pos, size_);
+		}
+
+		/**
+		 * @see        `Nene::IReader::read()`.
+		 */
+		std::size_t read(void* buffer, std::size_t size) override
+		{
+			const auto sizeToRead = peek(buffer, size);
+
+			pos_ += sizeToRead;
+
+			return sizeToRead;
+		}
+
+		/**
+		 * @see        `Nene::IReader::peek()`.
+		 */
+		std::size_t peek(void* buffer, std::size_t size) override
+		{
+			const auto sizeToPeek = (std::min)(size, size_ - pos_);
+
+			if (sizeToPeek > 0)
+			{
+				std::memcpy(buffer, data_ + pos_, sizeToPeek);
+			}
+
+			return sizeToPeek;
+		}
+
+		/**
+		 * @brief      Returns the mapped data.
+		 *
+		 * @return     The mapped data, valid while the reader is alive.
+		 */
+		[[nodiscard]]
+		ByteArrayView data() const noexcept
+		{
+			return ByteArrayView { data_, size_ };
+		}
+
+		/**
+		 * @brief      Returns the file path.
+		 *
+		 * @return     The absolute file path.
+		 */
+		[[nodiscard]]
+		path_type path() const
+		{
+			return path_;
+		}
+	};
+}
+
+#endif
+
+#endif  // #ifndef INCLUDE_NENE_READER_MAPPEDFILEREADER_HPP
@@ -26,6 +26,7 @@
 
 #include <algorithm>
 #include <vector>
+#include "../ArrayView.hpp"
 #include "../Types.hpp"
 #include "../Uncopyable.hpp"
 #include "IReader.hpp"
@@ -52,6 +53,15 @@ namespace Nene
 			: data_ (data.to_vector())
 			, pos_  (0) {}
 
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  data  The memory data to take without copying.
+		 */
+		explicit MemoryReader(std::vector<Byte>&& data) noexcept
+			: data_ (std::move(data))
+			, pos_  (0) {}
+
 		/**
 		 * @brief      Destructor.
 		 */
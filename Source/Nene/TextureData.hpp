@@ -0,0 +1,369 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_TEXTUREDATA_HPP
+#define INCLUDE_NENE_TEXTUREDATA_HPP
+
+#include <vector>
+#include "ArrayView.hpp"
+#include "Byte.hpp"
+#include "MipChain.hpp"
+#include "Size2D.hpp"
+
+namespace Nene
+{
+	/**
+	 * @brief      GPU texture formats.
+	 */
+	enum class TextureFormat: Int32
+	{
+		rgba8,
+		rgba8Srgb,
+		bgra8,
+		bgra8Srgb,
+		bgrx8,
+		bgrx8Srgb,
+		rgba16f,
+		bc1,
+		bc1Srgb,
+		bc2,
+		bc2Srgb,
+		bc3,
+		bc3Srgb,
+		bc4,
+		bc5,
+		bc6h,
+		bc6hSigned,
+		bc7,
+		bc7Srgb,
+	};
+
+	/**
+	 * @brief      Texture data ready to be uploaded to GPU.
+	 *
+	 *             The subresources are stored in one contiguous buffer in the
+	 *             order of Direct3D and DDS files: all the levels of the first
+	 *             array item, then all the levels of the next item and so on.
+	 *             Level `i` is `max(1, width >> i)` by `max(1, height >> i)`
+	 *             pixels with packed rows of pixels or 4x4 blocks.
+	 */
+	class TextureData
+	{
+		std::vector<Byte>        data_;
+		std::vector<std::size_t> offsets_;
+		TextureFormat            format_;
+		Size2Di                  size_;
+		Int32                    numLevels_;
+		Int32                    arraySize_;
+		bool                     cubeMap_;
+
+	public:
+		/**
+		 * @brief      Returns whether the format is block compressed.
+		 *
+		 * @param[in]  format  The texture format.
+		 *
+		 * @return     `true` if the format stores 4x4 blocks, `false` otherwise.
+		 */
+		[[nodiscard]]
+		static constexpr bool isCompressed(TextureFormat format) noexcept
+		{
+			return format >= TextureFormat::bc1;
+		}
+
+		/**
+		 * @brief      Returns size of a pixel or a block.
+		 *
+		 * @param[in]  format  The texture format.
+		 *
+		 * @return     Size of a pixel, or a 4x4 block for the compressed formats, in bytes.
+		 */
+		[[nodiscard]]
+		static constexpr std::size_t elementBytes(TextureFormat format) noexcept
+		{
+			switch (format)
+			{
+				case TextureFormat::rgba16f:
+				case TextureFormat::bc1:
+				case TextureFormat::bc1Srgb:
+				case TextureFormat::bc4:
+					return 8;
+
+				case TextureFormat::rgba8:
+				case TextureFormat::rgba8Srgb:
+				case TextureFormat::bgra8:
+				case TextureFormat::bgra8Srgb:
+				case TextureFormat::bgrx8:
+				case TextureFormat::bgrx8Srgb:
+					return 4;
+
+				default:
+					return 16;
+			}
+		}
+
+		/**
+		 * @brief      Returns size of a row of pixels or blocks.
+		 *
+		 * @param[in]  format  The texture format.
+		 * @param[in]  width   The width in pixels.
+		 *
+		 * @return     Size of a row in bytes.
+		 */
+		[[nodiscard]]
+		static constexpr std::size_t rowBytes(TextureFormat format, Int32 width) noexcept
+		{
+			const auto columns = isCompressed(format) ? (width + 3) / 4 : width;
+
+			return static_cast<std::size_t>(columns) * elementBytes(format);
+		}
+
+		/**
+		 * @brief      Returns size of a level.
+		 *
+		 * @param[in]  format  The texture format.
+		 * @param[in]  size    The level size in pixels.
+		 *
+		 * @return     Size of the level in bytes.
+		 */
+		[[nodiscard]]
+		static constexpr std::size_t levelBytes(TextureFormat format, const Size2Di& size) noexcept
+		{
+			const auto rows = isCompressed(format) ? (size.height + 3) / 4 : size.height;
+
+			return static_cast<std::size_t>(rows) * rowBytes(format, size.width);
+		}
+
+		/**
+		 * @brief      Default constructor.
+		 */
+		TextureData() =delete;
+
+		/**
+		 * @brief      Copy constructor.
+		 */
+		TextureData(const TextureData&) =delete;
+
+		/**
+		 * @brief      Move constructor.
+		 */
+		TextureData(TextureData&&) =default;
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 *             The data are left zero filled.
+		 *
+		 * @param[in]  format     The texture format.
+		 * @param[in]  size       The size of the top level.
+		 * @param[in]  numLevels  Number of the mipmap levels.
+		 * @param[in]  arraySize  Number of the array items; six faces per cube for cube maps.
+		 * @param[in]  cubeMap    `true` if the array items are cube faces.
+		 */
+		explicit TextureData(TextureFormat format, const Size2Di& size, Int32 numLevels, Int32 arraySize = 1, bool cubeMap = false)
+			: data_()
+			, offsets_()
+			, format_(format)
+			, size_(size)
+			, numLevels_(numLevels)
+			, arraySize_(arraySize)
+			, cubeMap_(cubeMap)
+		{
+			assert(size.width  > 0);
+			assert(size.height > 0);
+			assert(0 < numLevels && numLevels <= MipChain::fullLevels(size));
+			assert(arraySize > 0);
+			assert(!cubeMap || arraySize % 6 == 0);
+
+			std::size_t offset = 0;
+
+			for (Int32 item = 0; item < arraySize; item++)
+			{
+				for (Int32 level = 0; level < numLevels; level++)
+				{
+					offsets_.emplace_back(offset);
+
+					offset += levelBytes(format, this->size(level));
+				}
+			}
+
+			data_.resize(offset);
+		}
+
+		/**
+		 * @brief      Destructor.
+		 */
+		~TextureData() =default;
+
+		/**
+		 * @brief      Copy operator `=`.
+		 */
+		TextureData& operator=(const TextureData&) =delete;
+
+		/**
+		 * @brief      Move operator `=`.
+		 */
+		TextureData& operator=(TextureData&&) =default;
+
+		/**
+		 * @brief      Returns the texture format.
+		 *
+		 * @return     The texture format.
+		 */
+		[[nodiscard]]
+		TextureFormat format() const noexcept
+		{
+			return format_;
+		}
+
+		/**
+		 * @brief      Returns the size of the top level.
+		 *
+		 * @return     The size of the top level.
+		 */
+		[[nodiscard]]
+		const Size2Di& size() const noexcept
+		{
+			return size_;
+		}
+
+		/**
+		 * @brief      Returns the level size.
+		 *
+		 * @param[in]  level  The level index.
+		 *
+		 * @return     The size of the level in pixels.
+		 */
+		[[nodiscard]]
+		Size2Di size(Int32 level) const noexcept
+		{
+			assert(0 <= level && level < numLevels_);
+
+			return { (std::max)(size_.width >> level, 1), (std::max)(size_.height >> level, 1) };
+		}
+
+		/**
+		 * @brief      Returns number of the mipmap levels.
+		 *
+		 * @return     Number of the mipmap levels.
+		 */
+		[[nodiscard]]
+		Int32 numLevels() const noexcept
+		{
+			return numLevels_;
+		}
+
+		/**
+		 * @brief      Returns number of the array items.
+		 *
+		 * @return     Number of the array items, counting each cube face.
+		 */
+		[[nodiscard]]
+		Int32 arraySize() const noexcept
+		{
+			return arraySize_;
+		}
+
+		/**
+		 * @brief      Returns whether the texture is a cube map.
+		 *
+		 * @return     `true` if the array items are cube faces, `false` otherwise.
+		 */
+		[[nodiscard]]
+		bool isCubeMap() const noexcept
+		{
+			return cubeMap_;
+		}
+
+		/**
+		 * @brief      Returns size of a row of the level.
+		 *
+		 * @param[in]  level  The level index.
+		 *
+		 * @return     Size of a row of pixels or blocks in bytes.
+		 */
+		[[nodiscard]]
+		std::size_t pitch(Int32 level) const noexcept
+		{
+			return rowBytes(format_, size(level).width);
+		}
+
+		/**
+		 * @brief      Returns the data of the subresource.
+		 *
+		 * @param[in]  item   The array item index.
+		 * @param[in]  level  The level index.
+		 *
+		 * @return     The bytes of the level of the array item.
+		 */
+		[[nodiscard]]
+		ByteArrayView subresource(Int32 item, Int32 level) const noexcept
+		{
+			assert(0 <= item && item < arraySize_);
+			assert(0 <= level && level < numLevels_);
+
+			return { data_.data() + offsets_[item * numLevels_ + level], levelBytes(format_, size(level)) };
+		}
+
+		/**
+		 * @brief      Returns the mutable data of the subresource.
+		 *
+		 * @param[in]  item   The array item index.
+		 * @param[in]  level  The level index.
+		 *
+		 * @return     The pointer to the bytes of the level of the array item.
+		 */
+		[[nodiscard]]
+		Byte* mutableSubresource(Int32 item, Int32 level) noexcept
+		{
+			assert(0 <= item && item < arraySize_);
+			assert(0 <= level && level < numLevels_);
+
+			return data_.data() + offsets_[item * numLevels_ + level];
+		}
+
+		/**
+		 * @brief      Returns the data of all the subresources.
+		 *
+		 * @return     The bytes of all the subresources.
+		 */
+		[[nodiscard]]
+		ByteArrayView data() const noexcept
+		{
+			return data_;
+		}
+
+		/**
+		 * @brief      Returns the mutable data of all the subresources.
+		 *
+		 * @return     The pointer to the bytes of all the subresources.
+		 */
+		[[nodiscard]]
+		Byte* mutableData() noexcept
+		{
+			return data_.data();
+		}
+	};
+}
+
+#endif  // #ifndef INCLUDE_NENE_TEXTUREDATA_HPP
@@ -0,0 +1,98 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#include "ThreadPool.hpp"
+
+namespace Nene
+{
+	ThreadPool& ThreadPool::shared()
+	{
+		static ThreadPool pool;
+
+		return pool;
+	}
+
+	ThreadPool::ThreadPool(std::size_t numThreads)
+		: workers_()
+		, tasks_()
+		, mutex_()
+		, condition_()
+		, stopping_(false)
+	{
+		workers_.reserve(numThreads);
+
+		for (std::size_t i = 0; i < numThreads; i++)
+		{
+			workers_.emplace_back([this]() { run(); });
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock { mutex_ };
+			stopping_ = true;
+		}
+
+		condition_.notify_all();
+
+		for (auto& worker : workers_)
+		{
+			worker.join();
+		}
+	}
+
+	void ThreadPool::enqueue(std::function<void()>&& task)
+	{
+		{
+			std::lock_guard<std::mutex> lock { mutex_ };
+			tasks_.emplace_back(std::move(task));
+		}
+
+		condition_.notify_one();
+	}
+
+	void ThreadPool::run()
+	{
+		for (;;)
+		{
+			std::function<void()> task;
+
+			{
+				std::unique_lock<std::mutex> lock { mutex_ };
+				condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+
+				if (tasks_.empty())
+				{
+					// Stopping and no tasks remain.
+					return;
+				}
+
+				task = std::move(tasks_.front());
+				tasks_.pop_front();
+			}
+
+			task();
+		}
+	}
+}
@@ -0,0 +1,221 @@
+//=============================================================================
+// Copyright (c) 2017 Ryooooooga
+// https://github.com/Ryooooooga
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom
+// the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+// OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//=============================================================================
+
+#ifndef INCLUDE_NENE_THREAD_THREADPOOL_HPP
+#define INCLUDE_NENE_THREAD_THREADPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "../Types.hpp"
+#include "../Uncopyable.hpp"
+
+namespace Nene
+{
+	/**
+	 * @brief      Fixed size worker thread pool.
+	 */
+	class ThreadPool final
+		: private Uncopyable
+	{
+		std::vector<std::thread>          workers_;
+		std::deque<std::function<void()>> tasks_;
+		std::mutex                        mutex_;
+		std::condition_variable           condition_;
+		bool                              stopping_;
+
+		void enqueue(std::function<void()>&& task);
+
+		void run();
+
+	public:
+		/**
+		 * @brief      Returns the process-wide shared thread pool.
+		 *
+		 * @return     The thread pool shared by the engine.
+		 */
+		[[nodiscard]]
+		static ThreadPool& shared();
+
+		/**
+		 * @brief      Constructor.
+		 *
+		 * @param[in]  numThreads  Number of the worker threads.
+		 */
+		explicit ThreadPool(std::size_t numThreads = (std::max)(std::thread::hardware_concurrency(), 1u));
+
+		/**
+		 * @brief      Destructor.
+		 *
+		 *             Waits for the queued tasks to finish.
+		 */
+		~ThreadPool();
+
+		/**
+		 * @brief      Returns number of the worker threads.
+		 *
+		 * @return     Number of the worker threads.
+		 */
+		[[nodiscard]]
+		std::size_t numThreads() const noexcept
+		{
+			return workers_.size();
+		}
+
+		/**
+		 * @brief      Queues the task.
+		 *
+		 * @param      task  The task to run on a worker thread.
+		 *
+		 * @tparam     Task  The task type.
+		 *
+		 * @return     The future of the result of the task.
+		 */
+		template <typename Task>
+		[[nodiscard]]
+		std::future<std::invoke_result_t<std::decay_t<Task>>> submit(Task&& task)
+		{
+			using result_type = std::invoke_result_t<std::decay_t<Task>>;
+
+			// `std::function` requires copyable function objects.
+			const auto packaged = std::make_shared<std::packaged_task<result_type()>>(std::forward<Task>(task));
+
+			auto future = packaged->get_future();
+
+			enqueue([packaged]()
+			{
+				(*packaged)();
+			});
+
+			return future;
+		}
+
+		/**
+		 * @brief      Runs the function over the range on the worker threads.
+		 *
+		 *             The range `[first, last)` is split into chunks of
+		 *             `grain` elements. The calling thread also processes
+		 *             the chunks, so it is safe to call from a worker thread.
+		 *
+		 * @param[in]  first     The first index.
+		 * @param[in]  last      The last index (exclusive).
+		 * @param[in]  grain     Number of the indices per chunk.
+		 * @param[in]  function  The function called as `function(begin, end)`.
+		 *
+		 * @tparam     Function  The function type.
+		 */
+		template <typename Function>
+		void parallelFor(Int32 first, Int32 last, Int32 grain, Function&& function)
+		{
+			if (first >= last)
+			{
+				return;
+			}
+
+			grain = (std::max)(grain, 1);
+
+			const Int32 numChunks = (last - first + grain - 1) / grain;
+
+			if (numChunks == 1 || workers_.empty())
+			{
+				function(first, last);
+				return;
+			}
+
+			struct State
+			{
+				std::atomic<Int32>      next;
+				Int32                   completed;
+				std::exception_ptr      exception;
+				std::mutex              mutex;
+				std::condition_variable condition;
+			};
+
+			const auto state = std::make_shared<State>();
+			state->next      = 0;
+			state->completed = 0;
+
+			// Chunks are claimed by the index, so `function` is referenced
+			// only while the calling thread is waiting.
+			const auto process = [=, &function]()
+			{
+				Int32 chunk;
+
+				while ((chunk = state->next++) < numChunks)
+				{
+					const Int32 begin = first + chunk * grain;
+					const Int32 end   = (std::min)(begin + grain, last);
+
+					try
+					{
+						function(begin, end);
+					}
+					catch (...)
+					{
+						std::lock_guard<std::mutex> lock { state->mutex };
+
+						if (!state->exception)
+						{
+							state->exception = std::current_exception();
+						}
+					}
+
+					std::lock_guard<std::mutex> lock { state->mutex };
+
+					if (++state->completed == numChunks)
+					{
+						state->condition.notify_all();
+					}
+				}
+			};
+
+			const auto numHelpers = (std::min)(workers_.size(), static_cast<std::size_t>(numChunks - 1));
+
+			for (std::size_t i = 0; i < numHelpers; i++)
+			{
+				enqueue(process);
+			}
+
+			process();
+
+			std::unique_lock<std::mutex> lock { state->mutex };
+			state->condition.wait(lock, [&]() { return state->completed == numChunks; });
+
+			if (state->exception)
+			{
+				std::rethrow_exception(state->exception);
+			}
+		}
+	};
+}
+
+#endif  // #ifndef INCLUDE_NENE_THREAD_THREADPOOL_HPP